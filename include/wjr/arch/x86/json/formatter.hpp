@@ -0,0 +1,78 @@
+#ifndef WJR_ARCH_X86_JSON_FORMATTER_HPP__
+#define WJR_ARCH_X86_JSON_FORMATTER_HPP__
+
+#include <wjr/arch/x86/simd/simd.hpp>
+#include <wjr/math/ctz.hpp>
+
+namespace wjr::json::formatter_detail {
+
+#if WJR_HAS_SIMD(SSE2)
+    #define WJR_HAS_BUILTIN_JSON_FIND_ESCAPE WJR_HAS_DEF
+#endif
+
+#if WJR_HAS_BUILTIN(JSON_FIND_ESCAPE)
+
+/// @brief Bit i is set if byte i is '"', '\\' or a control character.
+template <typename simd>
+WJR_INTRINSIC_INLINE typename simd::mask_type escape_mask(const char *ptr) noexcept {
+    const auto x = simd::loadu(ptr);
+    const auto quote = simd::cmpeq_epi8(x, simd::set1_epi8('\"'));
+    const auto backslash = simd::cmpeq_epi8(x, simd::set1_epi8('\\'));
+    const auto control = simd::cmpeq_epi8(simd::min_epu8(x, simd::set1_epi8(0x1f)), x);
+    return simd::movemask_epi8(simd::Or(simd::Or(quote, backslash), control));
+}
+
+/**
+ * @brief First character in [first, last) that must be escaped, or last.
+ *
+ * @details The end of the range is checked by a last load that overlaps the
+ * bytes already checked, so only ranges shorter than 16 bytes are scanned one
+ * byte at a time.
+ */
+WJR_PURE inline const char *builtin_find_escape(const char *first, const char *last) noexcept {
+    constexpr auto is_avx = WJR_HAS_SIMD(AVX2);
+
+    using simd = std::conditional_t<is_avx, avx, sse>;
+    constexpr size_t width = simd::width() / 8;
+
+    const size_t n = static_cast<size_t>(last - first);
+
+    if (n < width) {
+        if constexpr (is_avx) {
+            if (n >= 16) {
+                sse::mask_type mask = escape_mask<sse>(first);
+                if (mask != 0) {
+                    return first + ctz(mask);
+                }
+
+                mask = escape_mask<sse>(last - 16);
+                return mask != 0 ? last - 16 + ctz(mask) : last;
+            }
+        }
+
+        for (; first != last; ++first) {
+            const auto ch = static_cast<uint8_t>(*first);
+            if (ch <= 0x1f || ch == '\"' || ch == '\\') {
+                break;
+            }
+        }
+
+        return first;
+    }
+
+    for (; static_cast<size_t>(last - first) > width; first += width) {
+        const auto mask = escape_mask<simd>(first);
+        if (mask != 0) {
+            return first + ctz(mask);
+        }
+    }
+
+    const auto mask = escape_mask<simd>(last - width);
+    return mask != 0 ? last - width + ctz(mask) : last;
+}
+
+#endif
+
+} // namespace wjr::json::formatter_detail
+
+#endif // WJR_ARCH_X86_JSON_FORMATTER_HPP__
@@ -136,13 +136,14 @@ struct __btree_inline_traits<Key, void> {
     }
 };
 
-template <typename Key, typename Value, bool Multi, typename Compare = std::less<>>
+template <typename Key, typename Value, bool Multi, typename Compare = std::less<>,
+          typename Alloc = memory_pool<char>>
 struct btree_traits : __btree_inline_traits<Key, Value> {
 private:
     using Mybase = __btree_inline_traits<Key, Value>;
 
 public:
-    using _Alty = typename std::allocator_traits<memory_pool<char>>::template rebind_alloc<char>;
+    using _Alty = typename std::allocator_traits<Alloc>::template rebind_alloc<char>;
     using _Alty_traits = std::allocator_traits<_Alty>;
     using storage_fn_type = container_fn<_Alty>;
 
@@ -640,18 +641,35 @@ public:
     }
 
 protected:
+    template <typename T>
+    using __node_alloc = typename _Alty_traits::template rebind_alloc<T>;
+
+    template <typename T>
+    using __node_alloc_traits = typename _Alty_traits::template rebind_traits<T>;
+
+    /// @brief Allocate through an allocator rebound to T, so that T is aligned.
+    template <typename T>
+    WJR_INTRINSIC_INLINE static T *__allocate_node() noexcept {
+        __node_alloc<T> al;
+        return __node_alloc_traits<T>::allocate(al, 1);
+    }
+
+    template <typename T>
+    WJR_INTRINSIC_INLINE static void __deallocate_node(T *node) noexcept {
+        __node_alloc<T> al;
+        __node_alloc_traits<T>::deallocate(al, node, 1);
+    }
+
     WJR_INTRINSIC_INLINE static inner_node_type *__create_inner_node() noexcept {
         _Alty al;
-        auto *const node = reinterpret_cast<inner_node_type *>(
-            _Alty_traits::allocate(al, sizeof(inner_node_type)));
+        auto *const node = __allocate_node<inner_node_type>();
         uninitialized_construct_using_allocator(node, al, default_construct);
         return node;
     }
 
     WJR_INTRINSIC_INLINE static leaf_node_type *__create_leaf_node() noexcept {
         _Alty al;
-        auto *const node =
-            reinterpret_cast<leaf_node_type *>(_Alty_traits::allocate(al, sizeof(leaf_node_type)));
+        auto *const node = __allocate_node<leaf_node_type>();
         uninitialized_construct_using_allocator(node, al, default_construct);
         return node;
     }
@@ -659,8 +677,7 @@ protected:
     template <typename... Args>
     WJR_INTRINSIC_INLINE static value_type *__create_node(Args &&...args) noexcept {
         _Alty al;
-        auto *const node =
-            reinterpret_cast<value_type *>(_Alty_traits::allocate(al, sizeof(value_type)));
+        auto *const node = __allocate_node<value_type>();
         uninitialized_construct_using_allocator(node, al, std::forward<Args>(args)...);
         return node;
     }
@@ -668,19 +685,19 @@ protected:
     WJR_INTRINSIC_INLINE static void __drop_inner_node(inner_node_type *node) noexcept {
         _Alty al;
         destroy_at_using_allocator(node, al);
-        _Alty_traits::deallocate(al, reinterpret_cast<char *>(node), sizeof(inner_node_type));
+        __deallocate_node(node);
     }
 
     WJR_INTRINSIC_INLINE static void __drop_leaf_node(leaf_node_type *node) noexcept {
         _Alty al;
         destroy_at_using_allocator(node, al);
-        _Alty_traits::deallocate(al, reinterpret_cast<char *>(node), sizeof(leaf_node_type));
+        __deallocate_node(node);
     }
 
     WJR_INTRINSIC_INLINE static void __drop_node(value_type *node) noexcept {
         _Alty al;
-        destroy_at_using_allocator(std::addressof(node), al);
-        _Alty_traits::deallocate(al, reinterpret_cast<char *>(node), sizeof(value_type));
+        destroy_at_using_allocator(node, al);
+        __deallocate_node(node);
     }
 
     WJR_INTRINSIC_INLINE const_iterator __get_insert_multi_pos(const key_type &key) const noexcept {
@@ -707,7 +724,7 @@ protected:
         }
 
         __drop_node(xval);
-        return {iterator(iter).__adjust_next(), false};
+        return {iterator(iter.get_leaf(), pos - 1), false};
     }
 
     iterator __insert_multi(const value_type &val) noexcept { return __emplace_multi(val); }
@@ -732,7 +749,7 @@ protected:
             return {__insert_iter(iter, xval), true};
         }
 
-        return {iterator(iter).__adjust_next(), false};
+        return {iterator(iter.get_leaf(), pos - 1), false};
     }
 
     template <typename... Args>
@@ -747,7 +764,7 @@ protected:
             return {__insert_iter(iter, xval), true};
         }
 
-        return {iterator(iter).__adjust_next(), false};
+        return {iterator(iter.get_leaf(), pos - 1), false};
     }
 
 public:
@@ -804,7 +821,7 @@ private:
 
         auto *const this_inner = __create_inner_node();
         this_inner->size() = cur_size;
-        const key_type *Key;
+        const key_type *Key = nullptr;
         const unsigned int cur_usize = cur_size;
 
         for (unsigned i = 0; i <= cur_usize; ++i) {
@@ -1251,7 +1268,7 @@ private:
 
             const auto inner = current->as_inner();
 
-            key_type **const keys = inner->m_keys;
+            const key_type **const keys = inner->m_keys;
             node_type **const sons = inner->m_sons;
 
             if (cur_size > floor_half) {
@@ -1304,7 +1321,7 @@ private:
 
                     const unsigned int moved_elements = (next_size - floor_half + 1) / 2;
 
-                    key_type *key = lhs->m_keys[next_size - moved_elements];
+                    const key_type *key = lhs->m_keys[next_size - moved_elements];
 
                     if (moved_elements != 1) {
                         Traits::template copy_backward<0, floor_half - 1>(
@@ -1374,7 +1391,7 @@ private:
 
                     const unsigned int moved_elements = (next_size - floor_half + 1) / 2;
 
-                    key_type *key = rhs->m_keys[moved_elements - 1];
+                    const key_type *key = rhs->m_keys[moved_elements - 1];
 
                     Traits::template copy<0, floor_half - 1>(keys + pos, keys + floor_half,
                                                              keys + pos - 1);
@@ -1384,9 +1401,9 @@ private:
                         rhs->m_keys, rhs->m_keys + moved_elements - 1, keys + floor_half);
                     Traits::template copy<1, max_moved_elements>(
                         rhs->m_sons, rhs->m_sons + moved_elements, sons + floor_half);
-                    Traits::template copy<node_size - max_moved_elements, node_size - 1>(
+                    Traits::template copy<floor_half, node_size - max_moved_elements>(
                         rhs->m_keys + moved_elements, rhs->m_keys + next_size, rhs->m_keys);
-                    Traits::template copy<node_size - max_moved_elements + 1, node_size>(
+                    Traits::template copy<floor_half + 1, node_size - max_moved_elements + 1>(
                         rhs->m_sons + moved_elements, rhs->m_sons + next_size + 1, rhs->m_sons);
 
                     keys[floor_half - 1] = par_inner->m_keys[par_pos];
@@ -1424,8 +1441,8 @@ private:
         const auto inner = current->as_inner();
 
         if (cur_size == 1) {
-            __drop_inner_node(inner);
             node_type *root = inner->m_sons[0];
+            __drop_inner_node(inner);
             __get_root() = root;
             root->m_parent = nullptr;
             return;
@@ -1589,7 +1606,7 @@ private:
         } while (false);
 
         lhs->size() = -(merge_size - 1);
-        remove(rhs);
+        rhs->remove();
         __drop_leaf_node(rhs);
 
         __rec_erase_iter(parent, par_pos, cur_size);
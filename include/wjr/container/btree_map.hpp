@@ -5,9 +5,10 @@
 
 namespace wjr {
 
-template <typename Key, typename Value, typename Pr = std::less<Key>>
-class btree_map : public basic_btree<btree_traits<Key, Value, false, Pr>> {
-    using Traits = btree_traits<Key, Value, false, Pr>;
+template <typename Key, typename Value, typename Pr = std::less<Key>,
+          typename Alloc = memory_pool<char>>
+class btree_map : public basic_btree<btree_traits<Key, Value, false, Pr, Alloc>> {
+    using Traits = btree_traits<Key, Value, false, Pr, Alloc>;
     using Mybase = basic_btree<Traits>;
 
 public:
@@ -95,39 +96,39 @@ public:
     size_type count(const key_type &key) const noexcept { return __count_unique(key) ? 1 : 0; }
 };
 
-template <typename Key, typename Value, typename Pr>
-WJR_NODISCARD bool operator==(const btree_map<Key, Value, Pr> &lhs,
-                              const btree_map<Key, Value, Pr> &rhs) {
+template <typename Key, typename Value, typename Pr, typename Alloc>
+WJR_NODISCARD bool operator==(const btree_map<Key, Value, Pr, Alloc> &lhs,
+                              const btree_map<Key, Value, Pr, Alloc> &rhs) {
     return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <typename Key, typename Value, typename Pr>
-WJR_NODISCARD bool operator!=(const btree_map<Key, Value, Pr> &lhs,
-                              const btree_map<Key, Value, Pr> &rhs) {
+template <typename Key, typename Value, typename Pr, typename Alloc>
+WJR_NODISCARD bool operator!=(const btree_map<Key, Value, Pr, Alloc> &lhs,
+                              const btree_map<Key, Value, Pr, Alloc> &rhs) {
     return !(lhs == rhs);
 }
 
-template <typename Key, typename Value, typename Pr>
-WJR_NODISCARD bool operator<(const btree_map<Key, Value, Pr> &lhs,
-                             const btree_map<Key, Value, Pr> &rhs) {
+template <typename Key, typename Value, typename Pr, typename Alloc>
+WJR_NODISCARD bool operator<(const btree_map<Key, Value, Pr, Alloc> &lhs,
+                             const btree_map<Key, Value, Pr, Alloc> &rhs) {
     return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
 
-template <typename Key, typename Value, typename Pr>
-WJR_NODISCARD bool operator>(const btree_map<Key, Value, Pr> &lhs,
-                             const btree_map<Key, Value, Pr> &rhs) {
+template <typename Key, typename Value, typename Pr, typename Alloc>
+WJR_NODISCARD bool operator>(const btree_map<Key, Value, Pr, Alloc> &lhs,
+                             const btree_map<Key, Value, Pr, Alloc> &rhs) {
     return rhs < lhs;
 }
 
-template <typename Key, typename Value, typename Pr>
-WJR_NODISCARD bool operator<=(const btree_map<Key, Value, Pr> &lhs,
-                              const btree_map<Key, Value, Pr> &rhs) {
+template <typename Key, typename Value, typename Pr, typename Alloc>
+WJR_NODISCARD bool operator<=(const btree_map<Key, Value, Pr, Alloc> &lhs,
+                              const btree_map<Key, Value, Pr, Alloc> &rhs) {
     return !(rhs < lhs);
 }
 
-template <typename Key, typename Value, typename Pr>
-WJR_NODISCARD bool operator>=(const btree_map<Key, Value, Pr> &lhs,
-                              const btree_map<Key, Value, Pr> &rhs) {
+template <typename Key, typename Value, typename Pr, typename Alloc>
+WJR_NODISCARD bool operator>=(const btree_map<Key, Value, Pr, Alloc> &lhs,
+                              const btree_map<Key, Value, Pr, Alloc> &rhs) {
     return !(lhs < rhs);
 }
 
@@ -5,9 +5,10 @@
 
 namespace wjr {
 
-template <typename Key, typename Pr = std::less<Key>>
-class btree_set : public basic_btree<btree_traits<Key, void, false, Pr>> {
-    using Traits = btree_traits<Key, void, false, Pr>;
+template <typename Key, typename Pr = std::less<Key>,
+          typename Alloc = memory_pool<char>>
+class btree_set : public basic_btree<btree_traits<Key, void, false, Pr, Alloc>> {
+    using Traits = btree_traits<Key, void, false, Pr, Alloc>;
     using Mybase = basic_btree<Traits>;
 
 public:
@@ -55,9 +56,10 @@ public:
     size_type count(const key_type &key) const noexcept { return __count_unique(key) ? 1 : 0; }
 };
 
-template <typename Key, typename Pr = std::less<Key>>
-class btree_multiset : public basic_btree<btree_traits<Key, void, true, Pr>> {
-    using Traits = btree_traits<Key, void, true, Pr>;
+template <typename Key, typename Pr = std::less<Key>,
+          typename Alloc = memory_pool<char>>
+class btree_multiset : public basic_btree<btree_traits<Key, void, true, Pr, Alloc>> {
+    using Traits = btree_traits<Key, void, true, Pr, Alloc>;
     using Mybase = basic_btree<Traits>;
 
 public:
@@ -0,0 +1,596 @@
+#ifndef WJR_CONTAINER_FLAT_HASH_MAP_HPP__
+#define WJR_CONTAINER_FLAT_HASH_MAP_HPP__
+
+/**
+ * @file flat_hash_map.hpp
+ * @brief Open addressing hash map that iterates in insertion order.
+ *
+ * @details Elements are stored contiguously in insertion order, and a swiss
+ * table of control bytes maps hashes to their positions. Every control byte
+ * is either empty or holds 7 bits of the hash of a full slot, so a probe
+ * compares a whole group of control bytes at once (16 with SSE2, 8 with a
+ * portable word) and only compares keys whose 7 bits match. \n
+ * Maps with at most small_size elements don't build the table and are searched
+ * linearly, which is faster for the small objects of most JSON documents. \n
+ * Erasing shifts the following elements and leaves a tombstone in the table,
+ * the positions stored after it are decremented in place without hashing any
+ * key. Insertion may invalidate iterators. Keys must not be modified through
+ * iterators.
+ *
+ * @version 0.1
+ * @date 2025-01-18
+ *
+ */
+
+#include <cstring>
+#include <stdexcept>
+#include <tuple>
+
+#include <wjr/math/ctz.hpp>
+#include <wjr/memory/memory_pool.hpp>
+#include <wjr/simd/simd.hpp>
+#include <wjr/vector.hpp>
+
+namespace wjr {
+
+namespace flat_hash_map_detail {
+
+inline constexpr uint8_t ctrl_empty = 0x80;
+// an erased slot, the probe of a lookup goes on after it
+inline constexpr uint8_t ctrl_deleted = 0xfe;
+
+#if WJR_HAS_SIMD(SSE2)
+
+class group {
+public:
+    static constexpr size_t width = 16;
+
+    /// @brief Bits of the matched control bytes.
+    class bitmask {
+    public:
+        explicit bitmask(uint32_t mask) noexcept : m_mask(mask) {}
+
+        explicit operator bool() const noexcept { return m_mask != 0; }
+        size_t lowest() const noexcept { return static_cast<size_t>(ctz(m_mask)); }
+        void pop() noexcept { m_mask &= m_mask - 1; }
+
+    private:
+        uint32_t m_mask;
+    };
+
+    explicit group(const uint8_t *ctrl) noexcept : m_ctrl(sse::loadu(ctrl)) {}
+
+    bitmask match(uint8_t h2) const noexcept {
+        return bitmask(sse::movemask_epi8(sse::cmpeq_epi8(m_ctrl, sse::set1_epi8(h2))));
+    }
+
+    bitmask match_empty() const noexcept {
+        return bitmask(sse::movemask_epi8(sse::cmpeq_epi8(m_ctrl, sse::set1_epi8(ctrl_empty))));
+    }
+
+    /// @brief Empty and deleted control bytes are the only ones with the highest bit set.
+    bitmask match_empty_or_deleted() const noexcept {
+        return bitmask(sse::movemask_epi8(m_ctrl));
+    }
+
+private:
+    __m128i m_ctrl;
+};
+
+#else
+
+class group {
+    static constexpr uint64_t lsbs = 0x0101010101010101ull;
+    static constexpr uint64_t msbs = 0x8080808080808080ull;
+
+public:
+    static constexpr size_t width = 8;
+
+    /// @brief Highest bits of the matched control bytes.
+    class bitmask {
+    public:
+        explicit bitmask(uint64_t mask) noexcept : m_mask(mask) {}
+
+        explicit operator bool() const noexcept { return m_mask != 0; }
+        size_t lowest() const noexcept { return static_cast<size_t>(ctz(m_mask)) / 8; }
+        void pop() noexcept { m_mask &= m_mask - 1; }
+
+    private:
+        uint64_t m_mask;
+    };
+
+    explicit group(const uint8_t *ctrl) noexcept : m_ctrl(read_memory<uint64_t>(ctrl)) {}
+
+    /// @details May have false positives after a true match, keys are compared anyway.
+    bitmask match(uint8_t h2) const noexcept {
+        const uint64_t x = m_ctrl ^ (lsbs * h2);
+        return bitmask((x - lsbs) & ~x & msbs);
+    }
+
+    /// @details May have false positives after a true match, like match.
+    bitmask match_empty() const noexcept {
+        const uint64_t x = m_ctrl ^ (lsbs * ctrl_empty);
+        return bitmask((x - lsbs) & ~x & msbs);
+    }
+
+    bitmask match_empty_or_deleted() const noexcept { return bitmask(m_ctrl & msbs); }
+
+private:
+    uint64_t m_ctrl;
+};
+
+#endif
+
+WJR_CONST WJR_INTRINSIC_CONSTEXPR uint64_t mix(uint64_t h) noexcept {
+    // std::hash of integers is the identity, spread it over all the bits
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return h;
+}
+
+} // namespace flat_hash_map_detail
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename Eq = std::equal_to<Key>, typename Alloc = memory_pool<char>>
+class flat_hash_map {
+    using group = flat_hash_map_detail::group;
+    using _Alty = typename std::allocator_traits<Alloc>::template rebind_alloc<uint32_t>;
+    using _Alty_traits = std::allocator_traits<_Alty>;
+
+    static constexpr bool is_transparent =
+        has_compare_is_transparent_v<Hash> && has_compare_is_transparent_v<Eq>;
+
+    template <typename K>
+    using enable_other_key_t = std::enable_if_t<
+        is_transparent && !std::is_convertible_v<const K &, const Key &>, int>;
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = Eq;
+    using allocator_type = Alloc;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+
+private:
+    using entry_allocator_type =
+        typename std::allocator_traits<Alloc>::template rebind_alloc<value_type>;
+    using container_type = vector<value_type, entry_allocator_type>;
+
+public:
+    using pointer = typename container_type::pointer;
+    using const_pointer = typename container_type::const_pointer;
+    using iterator = typename container_type::iterator;
+    using const_iterator = typename container_type::const_iterator;
+
+    /// @brief Maps up to this size are searched without the table.
+    static constexpr size_type small_size = 8;
+
+    flat_hash_map() = default;
+
+    flat_hash_map(const flat_hash_map &other) : m_entries(other.m_entries) {
+        if (other.m_capacity != 0) {
+            __allocate(other.m_capacity);
+            std::memcpy(m_ctrl, other.m_ctrl, m_capacity + group::width);
+            std::memcpy(m_index, other.m_index, m_capacity * sizeof(uint32_t));
+            m_deleted = other.m_deleted;
+        }
+    }
+
+    flat_hash_map(flat_hash_map &&other) noexcept
+        : m_entries(std::move(other.m_entries)), m_ctrl(other.m_ctrl), m_index(other.m_index),
+          m_capacity(other.m_capacity), m_deleted(other.m_deleted) {
+        other.m_ctrl = nullptr;
+        other.m_index = nullptr;
+        other.m_capacity = 0;
+        other.m_deleted = 0;
+    }
+
+    flat_hash_map &operator=(const flat_hash_map &other) {
+        if (WJR_LIKELY(this != std::addressof(other))) {
+            flat_hash_map tmp(other);
+            swap(tmp);
+        }
+
+        return *this;
+    }
+
+    flat_hash_map &operator=(flat_hash_map &&other) noexcept {
+        if (WJR_LIKELY(this != std::addressof(other))) {
+            flat_hash_map tmp(std::move(other));
+            swap(tmp);
+        }
+
+        return *this;
+    }
+
+    ~flat_hash_map() noexcept { __deallocate(); }
+
+    template <typename Iter>
+    flat_hash_map(Iter first, Iter last) {
+        for (; first != last; ++first) {
+            emplace(*first);
+        }
+    }
+
+    flat_hash_map(std::initializer_list<value_type> il) : flat_hash_map(il.begin(), il.end()) {}
+
+    iterator begin() noexcept { return m_entries.begin(); }
+    const_iterator begin() const noexcept { return m_entries.begin(); }
+    const_iterator cbegin() const noexcept { return m_entries.cbegin(); }
+
+    iterator end() noexcept { return m_entries.end(); }
+    const_iterator end() const noexcept { return m_entries.end(); }
+    const_iterator cend() const noexcept { return m_entries.cend(); }
+
+    size_type size() const noexcept { return m_entries.size(); }
+    WJR_NODISCARD bool empty() const noexcept { return m_entries.empty(); }
+
+    hasher hash_function() const { return hasher(); }
+    key_equal key_eq() const { return key_equal(); }
+
+    void clear() noexcept {
+        m_entries.clear();
+
+        if (m_capacity != 0) {
+            std::memset(m_ctrl, flat_hash_map_detail::ctrl_empty, m_capacity + group::width);
+            m_deleted = 0;
+        }
+    }
+
+    void reserve(size_type n) {
+        m_entries.reserve(n);
+
+        if (n > small_size && n > __max_load()) {
+            __rehash(__capacity_for(n));
+        }
+    }
+
+    iterator find(const key_type &key) { return begin() + __find(key); }
+    const_iterator find(const key_type &key) const { return begin() + __find(key); }
+
+    template <typename K, enable_other_key_t<K> = 0>
+    iterator find(const K &key) {
+        return begin() + __find(key);
+    }
+
+    template <typename K, enable_other_key_t<K> = 0>
+    const_iterator find(const K &key) const {
+        return begin() + __find(key);
+    }
+
+    size_type count(const key_type &key) const { return __find(key) != size() ? 1 : 0; }
+
+    template <typename K, enable_other_key_t<K> = 0>
+    size_type count(const K &key) const {
+        return __find(key) != size() ? 1 : 0;
+    }
+
+    bool contains(const key_type &key) const { return count(key) != 0; }
+
+    template <typename K, enable_other_key_t<K> = 0>
+    bool contains(const K &key) const {
+        return count(key) != 0;
+    }
+
+    mapped_type &at(const key_type &key) { return __at(key); }
+    const mapped_type &at(const key_type &key) const {
+        return const_cast<flat_hash_map &>(*this).__at(key);
+    }
+
+    template <typename K, enable_other_key_t<K> = 0>
+    mapped_type &at(const K &key) {
+        return __at(key);
+    }
+
+    template <typename K, enable_other_key_t<K> = 0>
+    const mapped_type &at(const K &key) const {
+        return const_cast<flat_hash_map &>(*this).__at(key);
+    }
+
+    mapped_type &operator[](const key_type &key) { return try_emplace(key).first->second; }
+    mapped_type &operator[](key_type &&key) { return try_emplace(std::move(key)).first->second; }
+
+    std::pair<iterator, bool> insert(const value_type &val) {
+        return try_emplace(val.first, val.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type &&val) {
+        return try_emplace(std::move(val.first), std::move(val.second));
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args &&...args) {
+        value_type val(std::forward<Args>(args)...);
+        return try_emplace(std::move(val.first), std::move(val.second));
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const key_type &key, Args &&...args) {
+        return __try_emplace(key, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(key_type &&key, Args &&...args) {
+        return __try_emplace(std::move(key), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Erase an element, the following elements keep their order.
+     *
+     * @details Keeping the order costs O(n) in the size plus the table capacity:
+     * the following elements are moved down and the table is scanned to renumber
+     * their indexes.
+     * Erasing the last element only costs the lookup.
+     */
+    iterator erase(const_iterator pos) {
+        const size_type idx = static_cast<size_type>(pos - cbegin());
+
+        if (m_capacity != 0) {
+            __erase_index(static_cast<uint32_t>(idx));
+        }
+
+        m_entries.erase(m_entries.begin() + idx);
+        return begin() + idx;
+    }
+
+    size_type erase(const key_type &key) {
+        const size_type idx = __find(key);
+        if (idx == size()) {
+            return 0;
+        }
+
+        erase(cbegin() + idx);
+        return 1;
+    }
+
+    void swap(flat_hash_map &other) noexcept {
+        std::swap(m_entries, other.m_entries);
+        std::swap(m_ctrl, other.m_ctrl);
+        std::swap(m_index, other.m_index);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_deleted, other.m_deleted);
+    }
+
+private:
+    template <typename K>
+    static uint64_t __hash(const K &key) noexcept {
+        return flat_hash_map_detail::mix(static_cast<uint64_t>(hasher()(key)));
+    }
+
+    static uint8_t __h2(uint64_t h) noexcept { return static_cast<uint8_t>(h >> 57); }
+
+    size_type __max_load() const noexcept { return m_capacity - m_capacity / 8; }
+
+    static size_type __capacity_for(size_type n) noexcept {
+        size_type cap = group::width;
+        while (cap - cap / 8 < n) {
+            cap *= 2;
+        }
+
+        return cap;
+    }
+
+    /// @return size() if not found.
+    template <typename K>
+    size_type __find(const K &key) const noexcept {
+        const size_type n = size();
+        const value_type *const entries = m_entries.data();
+
+        if (m_capacity == 0) {
+            for (size_type i = 0; i != n; ++i) {
+                if (key_equal()(entries[i].first, key)) {
+                    return i;
+                }
+            }
+
+            return n;
+        }
+
+        const uint64_t h = __hash(key);
+        const uint8_t h2 = __h2(h);
+        const size_type mask = m_capacity - 1;
+        size_type pos = static_cast<size_type>(h) & mask;
+        size_type step = 0;
+
+        while (true) {
+            const group g(m_ctrl + pos);
+
+            for (auto match = g.match(h2); match; match.pop()) {
+                const uint32_t idx = m_index[(pos + match.lowest()) & mask];
+                if (WJR_LIKELY(key_equal()(entries[idx].first, key))) {
+                    return idx;
+                }
+            }
+
+            if (WJR_LIKELY(static_cast<bool>(g.match_empty()))) {
+                return n;
+            }
+
+            step += group::width;
+            pos = (pos + step) & mask;
+        }
+    }
+
+    template <typename K>
+    mapped_type &__at(const K &key) {
+        const size_type idx = __find(key);
+        if (WJR_UNLIKELY(idx == size())) {
+            WJR_THROW(std::out_of_range("invalid map key"));
+        }
+
+        return m_entries[idx].second;
+    }
+
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> __try_emplace(K &&key, Args &&...args) {
+        const size_type idx = __find(key);
+        if (idx != size()) {
+            return {begin() + idx, false};
+        }
+
+        m_entries.emplace_back(std::piecewise_construct,
+                               std::forward_as_tuple(std::forward<K>(key)),
+                               std::forward_as_tuple(std::forward<Args>(args)...));
+
+        if (m_capacity != 0) {
+            if (WJR_UNLIKELY(idx + m_deleted >= __max_load())) {
+                // grow if the table is at least half full, otherwise only drop the tombstones
+                __rehash(idx >= __max_load() / 2 ? m_capacity * 2 : m_capacity);
+            } else {
+                __insert_index(__hash(m_entries.back().first), static_cast<uint32_t>(idx));
+            }
+        } else if (WJR_UNLIKELY(idx == small_size)) {
+            __rehash(__capacity_for(small_size + 1));
+        }
+
+        return {begin() + idx, true};
+    }
+
+    void __set_ctrl(size_type pos, uint8_t h2) noexcept {
+        m_ctrl[pos] = h2;
+        // mirror the first group after the end, so a group can be loaded at any position
+        if (pos < group::width) {
+            m_ctrl[m_capacity + pos] = h2;
+        }
+    }
+
+    void __insert_index(uint64_t h, uint32_t idx) noexcept {
+        const size_type mask = m_capacity - 1;
+        size_type pos = static_cast<size_type>(h) & mask;
+        size_type step = 0;
+
+        while (true) {
+            const auto match = group(m_ctrl + pos).match_empty_or_deleted();
+            if (match) {
+                pos = (pos + match.lowest()) & mask;
+                m_deleted -= m_ctrl[pos] == flat_hash_map_detail::ctrl_deleted;
+                __set_ctrl(pos, __h2(h));
+                m_index[pos] = idx;
+                return;
+            }
+
+            step += group::width;
+            pos = (pos + step) & mask;
+        }
+    }
+
+    /// @brief Leave a tombstone in the slot of idx and shift the positions after it,
+    /// which scans the whole table unless idx is the last element.
+    void __erase_index(uint32_t idx) noexcept {
+        const uint64_t h = __hash(m_entries[idx].first);
+        const uint8_t h2 = __h2(h);
+        const size_type mask = m_capacity - 1;
+        size_type pos = static_cast<size_type>(h) & mask;
+        size_type step = 0;
+
+        while (true) {
+            const group g(m_ctrl + pos);
+            auto match = g.match(h2);
+
+            for (; match; match.pop()) {
+                const size_type slot = (pos + match.lowest()) & mask;
+                if (m_index[slot] == idx) {
+                    __set_ctrl(slot, flat_hash_map_detail::ctrl_deleted);
+                    ++m_deleted;
+                    break;
+                }
+            }
+
+            if (match) {
+                break;
+            }
+
+            WJR_ASSERT(!g.match_empty(), "the element must be in the table");
+            step += group::width;
+            pos = (pos + step) & mask;
+        }
+
+        if (idx + 1 == size()) {
+            return;
+        }
+
+        for (size_type i = 0; i != m_capacity; ++i) {
+            // full slots are the only ones without the highest bit
+            if (!(m_ctrl[i] & 0x80) && m_index[i] > idx) {
+                --m_index[i];
+            }
+        }
+    }
+
+    WJR_NOINLINE void __rehash(size_type capacity) {
+        __deallocate();
+        __allocate(capacity);
+        std::memset(m_ctrl, flat_hash_map_detail::ctrl_empty, m_capacity + group::width);
+        m_deleted = 0;
+
+        const size_type n = size();
+        for (size_type i = 0; i != n; ++i) {
+            __insert_index(__hash(m_entries[i].first), static_cast<uint32_t>(i));
+        }
+    }
+
+    /// @brief Control bytes and indexes share one allocation of uint32_t.
+    static size_type __words(size_type capacity) noexcept {
+        return (capacity + group::width) / sizeof(uint32_t) + capacity;
+    }
+
+    void __allocate(size_type capacity) {
+        _Alty al;
+        uint32_t *const ptr = _Alty_traits::allocate(al, __words(capacity));
+        m_index = ptr;
+        m_ctrl = reinterpret_cast<uint8_t *>(ptr + capacity);
+        m_capacity = capacity;
+    }
+
+    void __deallocate() noexcept {
+        if (m_capacity != 0) {
+            _Alty al;
+            _Alty_traits::deallocate(al, m_index, __words(m_capacity));
+            m_ctrl = nullptr;
+            m_index = nullptr;
+            m_capacity = 0;
+        }
+    }
+
+    container_type m_entries;
+    uint8_t *m_ctrl = nullptr;
+    uint32_t *m_index = nullptr;
+    // 0 if the table is not built
+    size_type m_capacity = 0;
+    // tombstones in the table, they count against the load like full slots
+    size_type m_deleted = 0;
+};
+
+/// @brief Equal if they have the same elements, regardless of the order.
+template <typename Key, typename Value, typename Hash, typename Eq, typename Alloc>
+WJR_NODISCARD bool operator==(const flat_hash_map<Key, Value, Hash, Eq, Alloc> &lhs,
+                              const flat_hash_map<Key, Value, Hash, Eq, Alloc> &rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+
+    for (const auto &[key, value] : lhs) {
+        const auto iter = rhs.find(key);
+        if (iter == rhs.end() || !(iter->second == value)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename Key, typename Value, typename Hash, typename Eq, typename Alloc>
+WJR_NODISCARD bool operator!=(const flat_hash_map<Key, Value, Hash, Eq, Alloc> &lhs,
+                              const flat_hash_map<Key, Value, Hash, Eq, Alloc> &rhs) {
+    return !(lhs == rhs);
+}
+
+} // namespace wjr
+
+#endif // WJR_CONTAINER_FLAT_HASH_MAP_HPP__
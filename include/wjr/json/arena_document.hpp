@@ -0,0 +1,123 @@
+/**
+ * @file arena_document.hpp
+ * @author wjr
+ * @brief JSON document whose nodes live in a bump arena.
+ *
+ * @details Strings, objects and arrays of an arena_document are allocated from
+ * its own arena instead of one malloc per node. Destroying or resetting the
+ * document releases the arena at once without walking the tree.
+ *
+ * @version 0.1
+ * @date 2025-01-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_ARENA_DOCUMENT_HPP__
+#define WJR_JSON_ARENA_DOCUMENT_HPP__
+
+#include <wjr/json/document.hpp>
+
+namespace wjr::json {
+
+namespace detail {
+
+using arena_document_traits =
+    basic_document_traits<std::basic_string, btree_map, vector, arena_allocator>;
+
+} // namespace detail
+
+namespace visitor_detail {
+
+extern template result<void>
+parse<detail::basic_document_parser<basic_document<detail::arena_document_traits>> &>(
+    detail::basic_document_parser<basic_document<detail::arena_document_traits>> &par,
+    const reader &rd) noexcept;
+
+} // namespace visitor_detail
+
+/**
+ * @brief Owns an arena and the document allocated from it.
+ *
+ * @details Reading and modifying the root is the same as a json::document.
+ * Anything that allocates (assigning strings, objects or arrays, inserting
+ * elements, copying) must be done while scope() is alive:
+ * @code
+ * auto doc = *json::arena_document::parse(rd);
+ * {
+ *     auto scope = doc.scope();
+ *     (*doc)["key"] = "value";
+ * }
+ * @endcode
+ * Values of the document must not outlive it.
+ *
+ */
+class arena_document {
+public:
+    using document_type = basic_document<detail::arena_document_traits>;
+
+    arena_document() = default;
+    explicit arena_document(size_t block_size) noexcept : m_arena(block_size) {}
+
+    arena_document(const arena_document &) = delete;
+    arena_document &operator=(const arena_document &) = delete;
+    arena_document(arena_document &&) = default;
+    arena_document &operator=(arena_document &&) = default;
+    ~arena_document() = default;
+
+    WJR_NODISCARD static result<arena_document> parse(const reader &rd) noexcept {
+        arena_document doc;
+        WJR_EXPECTED_TRY(doc.read(rd));
+        return doc;
+    }
+
+    /**
+     * @brief Parse into this document, reusing the memory of the arena.
+     *
+     * @details Once the arena is large enough for the input, reading again
+     * doesn't allocate.
+     */
+    result<void> read(const reader &rd) noexcept {
+        reset();
+
+        arena_scope guard(m_arena);
+        detail::basic_document_parser<document_type> par;
+        auto ret = par.parse(rd);
+        if (WJR_UNLIKELY(!ret)) {
+            m_arena.reset();
+            return unexpected(std::move(ret).error());
+        }
+
+        m_root = *std::move(ret);
+        return {};
+    }
+
+    /// @brief Drop the document and release its arena at once.
+    void reset() noexcept {
+        m_root = document_type();
+        m_arena.reset();
+    }
+
+    WJR_NODISCARD arena_scope scope() noexcept { return arena_scope(m_arena); }
+
+    document_type &root() noexcept { return m_root; }
+    const document_type &root() const noexcept { return m_root; }
+
+    document_type &operator*() noexcept { return m_root; }
+    const document_type &operator*() const noexcept { return m_root; }
+
+    document_type *operator->() noexcept { return std::addressof(m_root); }
+    const document_type *operator->() const noexcept { return std::addressof(m_root); }
+
+    arena &get_arena() noexcept { return m_arena; }
+    const arena &get_arena() const noexcept { return m_arena; }
+
+private:
+    arena m_arena;
+    document_type m_root;
+};
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_ARENA_DOCUMENT_HPP__
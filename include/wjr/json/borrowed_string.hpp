@@ -0,0 +1,267 @@
+/**
+ * @file borrowed_string.hpp
+ * @author wjr
+ * @brief A string that either refers to the input or owns its characters.
+ *
+ * @details Used as the string type of view_document: strings without escape
+ * sequences are stored as a view of the input buffer, other strings are
+ * unescaped into storage of their own. detach() copies a view into owned
+ * storage, after which the input buffer is no longer referenced.
+ *
+ * @version 0.1
+ * @date 2025-01-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_BORROWED_STRING_HPP__
+#define WJR_JSON_BORROWED_STRING_HPP__
+
+#include <string>
+#include <string_view>
+
+#include <wjr/type_traits.hpp>
+
+namespace wjr::json {
+
+struct borrow_string_t {};
+inline constexpr borrow_string_t borrow_string{};
+
+template <typename Char, typename Traits = std::char_traits<Char>,
+          typename Alloc = std::allocator<Char>>
+class basic_borrowed_string {
+    using string_type = std::basic_string<Char, Traits, Alloc>;
+    using view_type = std::basic_string_view<Char, Traits>;
+
+    template <typename T>
+    using is_string_view_like =
+        std::conjunction<std::is_convertible<const T &, view_type>,
+                         std::negation<std::is_convertible<const T &, const Char *>>>;
+
+public:
+    using value_type = Char;
+    using traits_type = Traits;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using pointer = Char *;
+    using const_pointer = const Char *;
+    using const_iterator = const Char *;
+
+    basic_borrowed_string() = default;
+    basic_borrowed_string(const basic_borrowed_string &) = default;
+    basic_borrowed_string(basic_borrowed_string &&) noexcept = default;
+    basic_borrowed_string &operator=(const basic_borrowed_string &) = default;
+    basic_borrowed_string &operator=(basic_borrowed_string &&) noexcept = default;
+    ~basic_borrowed_string() = default;
+
+    /// @brief Refer to str without copying, str must outlive this string or detach().
+    basic_borrowed_string(borrow_string_t, view_type str) noexcept
+        : m_data(str.data()), m_size(str.size()) {}
+
+    basic_borrowed_string(const Char *str) : m_str(str) {}
+    basic_borrowed_string(const Char *str, size_type n) : m_str(str, n) {}
+
+    template <typename T, WJR_REQUIRES(is_string_view_like<T>::value)>
+    explicit basic_borrowed_string(const T &str) : m_str(view_type(str)) {}
+
+    template <typename T, WJR_REQUIRES(is_string_view_like<T>::value)>
+    basic_borrowed_string &operator=(const T &str) {
+        const view_type view(str);
+        m_str.assign(view.data(), view.size());
+        m_data = nullptr;
+        return *this;
+    }
+
+    /// @brief Return true if the characters belong to another buffer.
+    bool is_borrowed() const noexcept { return m_data != nullptr; }
+
+    /**
+     * @brief Copy the characters of a borrowed string into storage of its own.
+     *
+     * @details The value of the string doesn't change, so a const string, such as
+     * the key of an object, can be detached.
+     */
+    void detach() const {
+        if (m_data != nullptr) {
+            m_str.assign(m_data, m_size);
+            m_data = nullptr;
+        }
+    }
+
+    const Char *data() const noexcept { return m_data != nullptr ? m_data : m_str.data(); }
+    size_type size() const noexcept { return m_data != nullptr ? m_size : m_str.size(); }
+    size_type length() const noexcept { return size(); }
+    bool empty() const noexcept { return size() == 0; }
+
+    /// @brief Writable characters, a borrowed string is detached first.
+    Char *data() {
+        detach();
+        return m_str.data();
+    }
+
+    /// @brief The string is detached first.
+    void resize(size_type n) {
+        detach();
+        m_str.resize(n);
+    }
+
+    void clear() noexcept {
+        m_str.clear();
+        m_data = nullptr;
+    }
+
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + size(); }
+
+    const Char &operator[](size_type pos) const noexcept { return data()[pos]; }
+
+    view_type view() const noexcept { return view_type(data(), size()); }
+    operator view_type() const noexcept { return view(); }
+
+    friend bool operator==(const basic_borrowed_string &lhs,
+                           const basic_borrowed_string &rhs) noexcept {
+        return lhs.view() == rhs.view();
+    }
+
+    friend bool operator==(const basic_borrowed_string &lhs, view_type rhs) noexcept {
+        return lhs.view() == rhs;
+    }
+
+    friend bool operator==(view_type lhs, const basic_borrowed_string &rhs) noexcept {
+        return lhs == rhs.view();
+    }
+
+    friend bool operator==(const basic_borrowed_string &lhs, const Char *rhs) noexcept {
+        return lhs.view() == view_type(rhs);
+    }
+
+    friend bool operator==(const Char *lhs, const basic_borrowed_string &rhs) noexcept {
+        return view_type(lhs) == rhs.view();
+    }
+
+    friend bool operator!=(const basic_borrowed_string &lhs,
+                           const basic_borrowed_string &rhs) noexcept {
+        return lhs.view() != rhs.view();
+    }
+
+    friend bool operator!=(const basic_borrowed_string &lhs, view_type rhs) noexcept {
+        return lhs.view() != rhs;
+    }
+
+    friend bool operator!=(view_type lhs, const basic_borrowed_string &rhs) noexcept {
+        return lhs != rhs.view();
+    }
+
+    friend bool operator!=(const basic_borrowed_string &lhs, const Char *rhs) noexcept {
+        return lhs.view() != view_type(rhs);
+    }
+
+    friend bool operator!=(const Char *lhs, const basic_borrowed_string &rhs) noexcept {
+        return view_type(lhs) != rhs.view();
+    }
+
+    friend bool operator<(const basic_borrowed_string &lhs,
+                          const basic_borrowed_string &rhs) noexcept {
+        return lhs.view() < rhs.view();
+    }
+
+    friend bool operator<(const basic_borrowed_string &lhs, view_type rhs) noexcept {
+        return lhs.view() < rhs;
+    }
+
+    friend bool operator<(view_type lhs, const basic_borrowed_string &rhs) noexcept {
+        return lhs < rhs.view();
+    }
+
+    friend bool operator<(const basic_borrowed_string &lhs, const Char *rhs) noexcept {
+        return lhs.view() < view_type(rhs);
+    }
+
+    friend bool operator<(const Char *lhs, const basic_borrowed_string &rhs) noexcept {
+        return view_type(lhs) < rhs.view();
+    }
+
+    friend bool operator>(const basic_borrowed_string &lhs,
+                          const basic_borrowed_string &rhs) noexcept {
+        return rhs < lhs;
+    }
+
+    friend bool operator>(const basic_borrowed_string &lhs, view_type rhs) noexcept {
+        return rhs < lhs;
+    }
+
+    friend bool operator>(view_type lhs, const basic_borrowed_string &rhs) noexcept {
+        return rhs < lhs;
+    }
+
+    friend bool operator>(const basic_borrowed_string &lhs, const Char *rhs) noexcept {
+        return view_type(rhs) < lhs;
+    }
+
+    friend bool operator>(const Char *lhs, const basic_borrowed_string &rhs) noexcept {
+        return rhs < view_type(lhs);
+    }
+
+    friend bool operator<=(const basic_borrowed_string &lhs,
+                           const basic_borrowed_string &rhs) noexcept {
+        return !(rhs < lhs);
+    }
+
+    friend bool operator<=(const basic_borrowed_string &lhs, view_type rhs) noexcept {
+        return !(rhs < lhs);
+    }
+
+    friend bool operator<=(view_type lhs, const basic_borrowed_string &rhs) noexcept {
+        return !(rhs < lhs);
+    }
+
+    friend bool operator<=(const basic_borrowed_string &lhs, const Char *rhs) noexcept {
+        return !(view_type(rhs) < lhs);
+    }
+
+    friend bool operator<=(const Char *lhs, const basic_borrowed_string &rhs) noexcept {
+        return !(rhs < view_type(lhs));
+    }
+
+    friend bool operator>=(const basic_borrowed_string &lhs,
+                           const basic_borrowed_string &rhs) noexcept {
+        return !(lhs < rhs);
+    }
+
+    friend bool operator>=(const basic_borrowed_string &lhs, view_type rhs) noexcept {
+        return !(lhs < rhs);
+    }
+
+    friend bool operator>=(view_type lhs, const basic_borrowed_string &rhs) noexcept {
+        return !(lhs < rhs);
+    }
+
+    friend bool operator>=(const basic_borrowed_string &lhs, const Char *rhs) noexcept {
+        return !(lhs < view_type(rhs));
+    }
+
+    friend bool operator>=(const Char *lhs, const basic_borrowed_string &rhs) noexcept {
+        return !(view_type(lhs) < rhs);
+    }
+
+private:
+    // mutable for detach()
+    mutable string_type m_str;
+    // non-null if borrowed
+    mutable const Char *m_data = nullptr;
+    mutable size_type m_size = 0;
+};
+
+template <typename T>
+struct is_borrowed_string : std::false_type {};
+
+template <typename Char, typename Traits, typename Alloc>
+struct is_borrowed_string<basic_borrowed_string<Char, Traits, Alloc>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool is_borrowed_string_v = is_borrowed_string<T>::value;
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_BORROWED_STRING_HPP__
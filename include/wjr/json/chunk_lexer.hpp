@@ -0,0 +1,94 @@
+/**
+ * @file chunk_lexer.hpp
+ * @author wjr
+ * @brief Lex an input that arrives as a chain of buffers.
+ * @version 0.1
+ * @date 2025-01-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_CHUNK_LEXER_HPP__
+#define WJR_JSON_CHUNK_LEXER_HPP__
+
+#include <wjr/json/lexer.hpp>
+
+namespace wjr::json {
+
+class reader;
+
+/**
+ * @brief Lex successive chunks of one input, such as the buffers of a request body.
+ *
+ * @details Chunks may have any size. The whole 64-byte blocks of a chunk are
+ * lexed in place, the bytes left at its end are copied into a block that the
+ * next chunk completes. The lexer carries the state between blocks (in string,
+ * escape, whitespace and UTF-8), so values cut by a chunk boundary get the same
+ * tokens as in a contiguous input. Tokens are positions in the whole input. \n
+ * Parsing reads strings and numbers from the input, so it still needs the
+ * chunks in one piece: read the finished lexer into a reader with the gathered
+ * input, the tokens are moved instead of lexing again.
+ * @code
+ * json::chunk_lexer lex;
+ * std::string body;
+ * while (auto buf = next_buffer()) {
+ *     lex.feed(*buf);
+ *     body.append(buf->data(), buf->size());
+ * }
+ *
+ * lex.finish();
+ * json::reader rd;
+ * rd.read(body, std::move(lex));
+ * @endcode
+ *
+ * The whole input must be smaller than 4 GiB, like the input of a reader.
+ *
+ */
+class chunk_lexer {
+    friend class reader;
+
+public:
+    chunk_lexer() noexcept : m_lexer(span<const char>()) {}
+
+    chunk_lexer(const chunk_lexer &) = delete;
+    chunk_lexer(chunk_lexer &&) = default;
+    chunk_lexer &operator=(const chunk_lexer &) = delete;
+    chunk_lexer &operator=(chunk_lexer &&) = default;
+    ~chunk_lexer() = default;
+
+    /// @brief Lex the chunk that follows the ones already fed.
+    void feed(span<const char> chunk) noexcept;
+
+    /// @brief Lex the bytes kept from the last chunk, after the last feed().
+    void finish() noexcept;
+
+    /// @brief Start a new input, the capacity of the tokens is kept.
+    void reset() noexcept;
+
+    /// @brief Tokens lexed so far, the last bytes fed are only lexed by a later feed() or finish().
+    span<const uint32_t> tokens() const noexcept { return m_tokens; }
+
+    /// @brief Number of bytes fed.
+    uint32_t size() const noexcept { return m_offset + m_tail_size; }
+
+    bool is_finished() const noexcept { return m_finished; }
+
+    /// @brief Whether the bytes lexed so far are valid UTF-8, see lexer::is_valid_utf8.
+    bool is_valid_utf8() const noexcept { return m_lexer.is_valid_utf8(); }
+
+private:
+    void __lex(const char *first, uint32_t n) noexcept;
+
+    lexer m_lexer;
+    vector<uint32_t> m_tokens;
+    // position of the first byte of m_tail in the input
+    uint32_t m_offset = 0;
+    uint32_t m_tail_size = 0;
+    bool m_finished = false;
+    char m_tail[64];
+};
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_CHUNK_LEXER_HPP__
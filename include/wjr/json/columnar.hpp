@@ -0,0 +1,131 @@
+/**
+ * @file columnar.hpp
+ * @author wjr
+ * @brief Extract the fields of an array of objects into typed columns.
+ *
+ * @details extract_columns walks the tokens of `[{"ts" : 1, "v" : 0.5}, ...]`
+ * once with sax_parse and writes every mapped field straight into the buffer of
+ * its column, no basic_document is built. Numbers are converted by the same
+ * fastfloat routine as the document parser. Columns keep their capacity between
+ * extractions, so extracting batch after batch into the same columns stops
+ * allocating.
+ *
+ * @version 0.1
+ * @date 2025-01-24
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_COLUMNAR_HPP__
+#define WJR_JSON_COLUMNAR_HPP__
+
+#include <wjr/json/sax.hpp>
+
+namespace wjr::json {
+
+namespace columnar_detail {
+class column_handler;
+} // namespace columnar_detail
+
+enum class column_type : uint8_t {
+    int64,
+    float64,
+    string,
+};
+
+/**
+ * @brief The values of one field, one row per object.
+ *
+ * @details A row whose object misses the field, or has it set to null, stores 0,
+ * NaN or an empty string and is not valid. The strings of a string column are
+ * decoded and stored back to back, string i is [offsets()[i], offsets()[i + 1])
+ * of chars().
+ *
+ */
+class column {
+    friend class columnar_detail::column_handler;
+
+public:
+    /**
+     * @brief key is compared with the raw keys of the input, escapes included.
+     *
+     * @details Only a view of key is kept, it must outlive the column.
+     */
+    column(std::string_view key, column_type type) noexcept : m_key(key), m_type(type) {
+        clear();
+    }
+
+    column(const column &) = default;
+    column(column &&) = default;
+    column &operator=(const column &) = default;
+    column &operator=(column &&) = default;
+    ~column() = default;
+
+    std::string_view key() const noexcept { return m_key; }
+    column_type type() const noexcept { return m_type; }
+    size_t size() const noexcept { return m_valid.size(); }
+
+    span<const int64_t> int64s() const noexcept { return m_int64s; }
+    span<const double> doubles() const noexcept { return m_doubles; }
+    span<const uint64_t> offsets() const noexcept { return m_offsets; }
+    span<const char> chars() const noexcept { return m_chars; }
+    /// @brief 1 for the rows that have a value, 0 for missing and null fields.
+    span<const uint8_t> valid() const noexcept { return m_valid; }
+
+    std::string_view string(size_t row) const noexcept {
+        return std::string_view(m_chars.data() + m_offsets[row],
+                                static_cast<size_t>(m_offsets[row + 1] - m_offsets[row]));
+    }
+
+    /// @brief Remove all rows, the capacity is kept.
+    void clear() noexcept {
+        m_int64s.clear();
+        m_doubles.clear();
+        m_offsets.clear();
+        m_chars.clear();
+        m_valid.clear();
+
+        if (m_type == column_type::string) {
+            m_offsets.emplace_back(0);
+        }
+    }
+
+private:
+    std::string_view m_key;
+    column_type m_type;
+    vector<int64_t> m_int64s;
+    vector<double> m_doubles;
+    vector<uint64_t> m_offsets;
+    vector<char> m_chars;
+    vector<uint8_t> m_valid;
+};
+
+/**
+ * @brief Extract the fields of an array of objects into columns.
+ *
+ * @details The root of rd must be an array of objects. Every column is cleared,
+ * then gets one row per object: the value of the field named by its key.
+ * Fields without a column and values nested deeper are checked and skipped. For
+ * example:
+ * @code
+ * column cols[] = {{"ts", column_type::int64}, {"v", column_type::float64}};
+ * auto rows = json::extract_columns(json::reader(str), cols);
+ * // cols[1].doubles() is ready for a vectorized sum.
+ * @endcode
+ * Errors:
+ * - INCORRECT_TYPE : the root isn't an array of objects, or a field doesn't
+ * match the type of its column. An int64 column takes integers only, a float64
+ * column takes any number.
+ * - NUMBER_OUT_OF_RANGE : an integer doesn't fit in int64_t.
+ * - The errors of the parse, malformed numbers and strings.
+ *
+ * A key repeated in an object keeps its first value.
+ *
+ * @return The number of rows.
+ */
+WJR_NODISCARD result<size_t> extract_columns(const reader &rd, span<column> columns) noexcept;
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_COLUMNAR_HPP__
@@ -0,0 +1,226 @@
+/**
+ * @file deserializer.hpp
+ * @author wjr
+ * @brief Fill C++ objects directly from the tokens of a reader.
+ *
+ * @details json::deserialize walks the tokens with the on-demand API and writes
+ * every value straight into its destination, no basic_document is built.
+ * Numbers are converted by the same fastfloat routine as the document parser,
+ * and the fields of a registered object are dispatched by a fold over its
+ * field names, which are known at compile time. \n
+ * Objects registered with WJR_REGISTER_DOCUMENT_OBJECT_SERIALIZER (or
+ * WJR_REGISTER_FROM_READER_OBJECT_SERIALIZER) are supported, as well as
+ * bool, integers, floating points, std::basic_string, std::optional,
+ * std::vector and wjr::vector of supported types. Other types can specialize
+ * json::deserializer.
+ *
+ * @version 0.1
+ * @date 2025-01-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_DESERIALIZER_HPP__
+#define WJR_JSON_DESERIALIZER_HPP__
+
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include <wjr/json/document.hpp>
+#include <wjr/json/ondemand.hpp>
+
+namespace wjr::json {
+
+/**
+ * @brief Read a value of type T from an ondemand::value.
+ *
+ * @details A specialization provides
+ * `static result<void> read(ondemand::value val, T &out) noexcept`.
+ */
+template <typename T, typename Enable = void>
+struct deserializer {};
+
+WJR_REGISTER_HAS_TYPE(deserializer,
+                      deserializer<T>::read(std::declval<ondemand::value>(), std::declval<T &>()),
+                      T);
+
+template <>
+struct deserializer<bool> {
+    static result<void> read(ondemand::value val, bool &out) noexcept {
+        WJR_EXPECTED_INIT(ret, val.get_bool());
+        out = *ret;
+        return {};
+    }
+};
+
+template <typename T>
+struct deserializer<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+    static result<void> read(ondemand::value val, T &out) noexcept {
+        if constexpr (std::is_signed_v<T>) {
+            WJR_EXPECTED_INIT(ret, val.get_int64());
+            if (WJR_UNLIKELY(*ret < static_cast<int64_t>(std::numeric_limits<T>::min()) ||
+                             *ret > static_cast<int64_t>(std::numeric_limits<T>::max()))) {
+                return unexpected(error_code::NUMBER_OUT_OF_RANGE);
+            }
+
+            out = static_cast<T>(*ret);
+        } else {
+            WJR_EXPECTED_INIT(ret, val.get_uint64());
+            if (WJR_UNLIKELY(*ret > static_cast<uint64_t>(std::numeric_limits<T>::max()))) {
+                return unexpected(error_code::NUMBER_OUT_OF_RANGE);
+            }
+
+            out = static_cast<T>(*ret);
+        }
+
+        return {};
+    }
+};
+
+template <typename T>
+struct deserializer<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+    static result<void> read(ondemand::value val, T &out) noexcept {
+        WJR_EXPECTED_INIT(ret, val.get_double());
+        out = static_cast<T>(*ret);
+        return {};
+    }
+};
+
+template <typename Traits, typename Alloc>
+struct deserializer<std::basic_string<char, Traits, Alloc>> {
+    static result<void> read(ondemand::value val,
+                             std::basic_string<char, Traits, Alloc> &out) noexcept {
+        WJR_EXPECTED_INIT(ret, val.get_string_view());
+        out.assign(ret->data(), ret->size());
+        return {};
+    }
+};
+
+template <typename T>
+struct deserializer<std::optional<T>, std::enable_if_t<has_deserializer_v<T>>> {
+    static result<void> read(ondemand::value val, std::optional<T> &out) noexcept {
+        if (val.is_null()) {
+            out.reset();
+            return {};
+        }
+
+        return deserializer<T>::read(val, out.emplace());
+    }
+};
+
+namespace deserializer_detail {
+
+template <typename Container>
+result<void> read_array(ondemand::value val, Container &out) noexcept {
+    using value_type = typename Container::value_type;
+
+    WJR_EXPECTED_INIT(arr, val.get_array());
+    out.clear();
+
+    auto iter = arr->begin();
+    for (; iter != arr->end(); ++iter) {
+        WJR_EXPECTED_TRY(deserializer<value_type>::read(*iter, out.emplace_back()));
+    }
+
+    // the elements must end at the ']' of the array
+    if (WJR_UNLIKELY(iter.error() != error_code::SUCCESS)) {
+        return unexpected(iter.error());
+    }
+
+    return {};
+}
+
+template <typename T, typename Field>
+WJR_INTRINSIC_INLINE bool read_field(std::string_view key, const ondemand::value &val, T &out,
+                                     const Field &field, result<void> &ret) noexcept {
+    if (key != field.first) {
+        return false;
+    }
+
+    using value_type = remove_cvref_t<decltype(out.*(field.second))>;
+    ret = deserializer<value_type>::read(val, out.*(field.second));
+    return true;
+}
+
+} // namespace deserializer_detail
+
+template <typename T, typename Alloc>
+struct deserializer<std::vector<T, Alloc>, std::enable_if_t<has_deserializer_v<T>>> {
+    static result<void> read(ondemand::value val, std::vector<T, Alloc> &out) noexcept {
+        return deserializer_detail::read_array(val, out);
+    }
+};
+
+template <typename Storage>
+struct deserializer<basic_vector<Storage>,
+                    std::enable_if_t<has_deserializer_v<typename Storage::value_type>>> {
+    static result<void> read(ondemand::value val, basic_vector<Storage> &out) noexcept {
+        return deserializer_detail::read_array(val, out);
+    }
+};
+
+/**
+ * @brief Objects registered with WJR_REGISTER_FROM_READER_OBJECT_SERIALIZER.
+ *
+ * @details Unknown fields are skipped without being decoded, and missing fields
+ * keep their current value. Keys are compared with the raw keys of the input.
+ */
+template <typename T>
+struct deserializer<T, std::enable_if_t<has_reader_fields_v<T>>> {
+    static result<void> read(ondemand::value val, T &out) noexcept {
+        static constexpr auto fields = T::__wjr_reader_fields();
+
+        WJR_EXPECTED_INIT(obj, val.get_object());
+
+        auto iter = obj->begin();
+        for (; iter != obj->end(); ++iter) {
+            const ondemand::field &field = *iter;
+            const std::string_view key = field.key();
+            result<void> ret;
+
+            std::apply(
+                [&key, &field, &out, &ret](const auto &...fs) {
+                    (void)(deserializer_detail::read_field(key, field.value(), out, fs, ret) ||
+                           ...);
+                },
+                fields);
+
+            WJR_EXPECTED_TRY(ret);
+        }
+
+        // the fields must end at the '}' of the object
+        if (WJR_UNLIKELY(iter.error() != error_code::SUCCESS)) {
+            return unexpected(iter.error());
+        }
+
+        return {};
+    }
+};
+
+/**
+ * @brief Fill val from the tokens of rd.
+ *
+ * @details Like ondemand::document, only what is read is validated: the
+ * values of skipped fields are not checked, but every object and array that is
+ * read must be well-formed up to its closing bracket. Use json::check first
+ * when the whole input must be valid JSON.
+ */
+template <typename T, WJR_REQUIRES(has_deserializer_v<T>)>
+result<void> deserialize(const reader &rd, T &val) noexcept {
+    ondemand::document doc(rd);
+    WJR_EXPECTED_INIT(root, doc.root());
+    return deserializer<T>::read(*root, val);
+}
+
+template <typename T, WJR_REQUIRES(has_deserializer_v<T> && std::is_default_constructible_v<T>)>
+result<T> deserialize(const reader &rd) noexcept {
+    T val{};
+    WJR_EXPECTED_TRY(deserialize(rd, val));
+    return val;
+}
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_DESERIALIZER_HPP__
@@ -43,6 +43,9 @@ enum class error_code : uint8_t {
     SCALAR_DOCUMENT_AS_VALUE,   ///< A scalar document is treated as a value.
     OUT_OF_BOUNDS,              ///< Attempted to access location outside of document.
     TRAILING_CONTENT,           ///< Unexpected trailing content in the JSON input
+    SNAPSHOT_ERROR,             ///< A snapshot has a wrong header, size or checksum
+    INVALID_PATCH,              ///< A JSON Patch or one of its operations is malformed
+    PATCH_TEST_FAILED,          ///< The value of a JSON Patch test operation differs
     NUM_ERROR_CODES,
 };
 
@@ -14,12 +14,17 @@
 #ifndef WJR_JSON_DOCUMENT_HPP__
 #define WJR_JSON_DOCUMENT_HPP__
 
+#include <atomic>
 #include <map>
+#include <new>
 
+#include <wjr/json/borrowed_string.hpp>
 #include <wjr/json/formatter.hpp>
+#include <wjr/json/interned_string.hpp>
 #include <wjr/json/visitor.hpp>
 
 #include <wjr/container/btree_map.hpp>
+#include <wjr/memory/arena.hpp>
 
 namespace wjr::json {
 
@@ -37,17 +42,38 @@ inline constexpr bool is_document_v = is_document<T>::value;
 
 namespace detail {
 
+/// @brief key_compare of ordered objects, key_equal of hashed objects.
+template <typename Object, typename = void>
+struct __object_key_compare {
+    using type = typename Object::key_equal;
+};
+
+template <typename Object>
+struct __object_key_compare<Object, std::void_t<typename Object::key_compare>> {
+    using type = typename Object::key_compare;
+};
+
 template <template <typename Char, typename Traits, typename Alloc> typename String,
           template <typename... Types> typename Object,
-          template <typename T, typename Alloc> typename Array>
+          template <typename T, typename Alloc> typename Array,
+          template <typename T> typename Allocator = memory_pool, bool Shared = false>
 struct basic_document_traits {
 private:
     using document_type = basic_document<basic_document_traits>;
 
 public:
-    using string_type = String<char, std::char_traits<char>, memory_pool<char>>;
-    using object_type = Object<string_type, document_type, std::less<>>;
-    using array_type = Array<document_type, memory_pool<document_type>>;
+    using string_type = String<char, std::char_traits<char>, Allocator<char>>;
+    using object_type = Object<string_type, document_type, std::less<>,
+                               Allocator<std::pair<const string_type, document_type>>>;
+    using array_type = Array<document_type, Allocator<document_type>>;
+
+    /// @brief Nodes are released with their arena, so destruction needn't walk the tree.
+    static constexpr bool is_arena = is_arena_allocator_v<Allocator<char>>;
+
+    /// @brief Copies share objects and arrays, which are cloned when written.
+    static constexpr bool is_shared = Shared;
+
+    static_assert(!(is_arena && is_shared), "nodes of an arena are never released one by one");
 
     using value_type = document_type;
     using reference = value_type &;
@@ -61,8 +87,10 @@ public:
     struct is_other_key
         : std::conjunction<std::negation<std::is_convertible<Key, size_type>>,
                            std::negation<std::is_same<string_type, remove_cvref_t<Key>>>,
-                           has_compare<typename object_type::key_compare, string_type, Key>,
-                           has_compare<typename object_type::key_compare, Key, string_type>> {};
+                           has_compare<typename __object_key_compare<object_type>::type,
+                                       string_type, Key>,
+                           has_compare<typename __object_key_compare<object_type>::type, Key,
+                                       string_type>> {};
 };
 
 using default_document_traits = basic_document_traits<std::basic_string, btree_map, vector>;
@@ -76,6 +104,7 @@ class check_parser;
 } // namespace detail
 
 WJR_INTRINSIC_INLINE result<void> check(const reader &rd) noexcept;
+WJR_INTRINSIC_INLINE result<void> check(stream_reader &rd) noexcept;
 
 template <typename T>
 struct __document_get_impl;
@@ -84,7 +113,7 @@ struct __document_get_impl;
     template <>                                                                                    \
     struct __document_get_impl<T##_t> {                                                            \
         template <typename Document>                                                               \
-        WJR_PURE WJR_INTRINSIC_CONSTEXPR static auto get(Document &&doc) noexcept                  \
+        WJR_INTRINSIC_CONSTEXPR static auto get(Document &&doc) noexcept                           \
             -> decltype(std::declval<Document &&>().__get_##T()) {                                 \
             return std::forward<Document>(doc).__get_##T();                                        \
         }                                                                                          \
@@ -454,26 +483,130 @@ public:
                       in_place_document_serializer_object_move);                                    \
     }
 
+// from_reader
+
+#define __WJR_REGISTER_FROM_READER_OBJECT_SERIALIZER_FIELD_CALLER(var)                             \
+    std::make_pair(std::string_view(#var), &TT::var)
+
+/**
+ * @brief Names and member pointers of the fields, used by json::deserialize to
+ * fill the object directly from the tokens of a reader, and by json::serialize
+ * to write it without building a document.
+ */
+#define WJR_REGISTER_FROM_READER_OBJECT_SERIALIZER(Type, ...)                                       \
+public:                                                                                             \
+    template <typename TT = Type>                                                                   \
+    static constexpr auto __wjr_reader_fields() noexcept {                                          \
+        return std::make_tuple(WJR_PP_QUEUE_EXPAND(WJR_PP_QUEUE_TRANSFORM(                          \
+            (__VA_ARGS__), __WJR_REGISTER_FROM_READER_OBJECT_SERIALIZER_FIELD_CALLER)));            \
+    }
+
+WJR_REGISTER_HAS_TYPE(reader_fields, T::__wjr_reader_fields(), T);
+
 #define WJR_REGISTER_DOCUMENT_OBJECT_SERIALIZER(Type, ...)                                         \
     WJR_REGISTER_FROM_DOCUMENT_OBJECT_SERIALIZER(Type, __VA_ARGS__)                                \
-    WJR_REGISTER_TO_DOCUMENT_OBJECT_SERIALIZER(Type, __VA_ARGS__)
+    WJR_REGISTER_TO_DOCUMENT_OBJECT_SERIALIZER(Type, __VA_ARGS__)                                  \
+    WJR_REGISTER_FROM_READER_OBJECT_SERIALIZER(Type, __VA_ARGS__)
+
+template <typename T>
+struct __is_shared_document : std::false_type {};
+
+template <typename Traits>
+struct __is_shared_document<basic_document<Traits>> : std::bool_constant<Traits::is_shared> {};
+
+/// @brief Whether T is the object or the array of a document with shared subtrees.
+template <typename T, typename = void>
+struct __is_shared_document_node : __is_shared_document<typename T::value_type> {};
+
+template <typename T>
+struct __is_shared_document_node<T, std::void_t<typename T::mapped_type>>
+    : __is_shared_document<typename T::mapped_type> {};
+
+template <typename T>
+inline constexpr bool __is_shared_document_node_v = __is_shared_document_node<T>::value;
+
+/**
+ * @brief A shared node is allocated behind its reference count.
+ *
+ * @details The document still points to the container itself, so reading a
+ * shared node costs the same as reading any other node.
+ */
+template <typename T>
+struct __document_shared_node {
+    using count_type = std::atomic<size_t>;
+
+    static constexpr size_t offset =
+        (sizeof(count_type) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+    struct alignas(std::max(alignof(T), alignof(count_type))) type {
+        char data[offset + sizeof(T)];
+    };
+
+    static count_type *count(const T *ptr) noexcept {
+        return std::launder(reinterpret_cast<count_type *>(
+            reinterpret_cast<char *>(const_cast<T *>(ptr)) - offset));
+    }
+};
+
+/// @brief Nodes are allocated by the allocator of the container itself.
+template <typename T>
+using __document_allocator_t =
+    typename std::allocator_traits<typename T::allocator_type>::template rebind_alloc<T>;
+
+template <typename T>
+using __document_shared_allocator_t = typename std::allocator_traits<
+    typename T::allocator_type>::template rebind_alloc<typename __document_shared_node<T>::type>;
 
 template <typename T, typename... Args>
 T *__document_create(Args &&...args) noexcept(
-    noexcept(std::declval<memory_pool<T>>().allocate(1)) &&
+    noexcept(std::declval<__document_allocator_t<T>>().allocate(1)) &&
     std::is_nothrow_constructible_v<T, Args &&...>) {
-    memory_pool<T> al;
-    auto *const ptr = al.allocate(1);
-    wjr::construct_at(ptr, std::forward<Args>(args)...);
-    return ptr;
+    if constexpr (__is_shared_document_node_v<T>) {
+        using node = __document_shared_node<T>;
+        __document_shared_allocator_t<T> al;
+        char *const raw = reinterpret_cast<char *>(al.allocate(1));
+        ::new (static_cast<void *>(raw)) typename node::count_type(1);
+        auto *const ptr = reinterpret_cast<T *>(raw + node::offset);
+        wjr::construct_at(ptr, std::forward<Args>(args)...);
+        return ptr;
+    } else {
+        __document_allocator_t<T> al;
+        auto *const ptr = al.allocate(1);
+        wjr::construct_at(ptr, std::forward<Args>(args)...);
+        return ptr;
+    }
 }
 
+/// @brief A shared node is only destroyed by its last owner.
 template <typename T>
 void __document_destroy(T *ptr) noexcept(std::is_nothrow_destructible_v<T> && noexcept(
-    std::declval<memory_pool<T>>().deallocate(std::declval<T *>(), 1))) {
-    std::destroy_at(ptr);
-    memory_pool<T> al;
-    al.deallocate(ptr, 1);
+    std::declval<__document_allocator_t<T>>().deallocate(std::declval<T *>(), 1))) {
+    if constexpr (__is_shared_document_node_v<T>) {
+        using node = __document_shared_node<T>;
+        auto *const count = node::count(ptr);
+        if (count->fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+
+        std::destroy_at(ptr);
+        std::destroy_at(count);
+        __document_shared_allocator_t<T> al;
+        al.deallocate(reinterpret_cast<typename node::type *>(count), 1);
+    } else {
+        std::destroy_at(ptr);
+        __document_allocator_t<T> al;
+        al.deallocate(ptr, 1);
+    }
+}
+
+template <typename T>
+void __document_share(T *ptr) noexcept {
+    __document_shared_node<T>::count(ptr)->fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename T>
+bool __document_is_unique(const T *ptr) noexcept {
+    return __document_shared_node<T>::count(ptr)->load(std::memory_order_acquire) == 1;
 }
 
 namespace detail {
@@ -495,7 +628,8 @@ void format(Formatter fmt, const basic_document<Traits> &doc) noexcept {
  * 2. Maybe use hash like std::unordered_map, but for long strings, compare even
  * faster than hash.
  * 3. Use B plus tree ?
- * 4. In place construct without using low performance basic_document.
+ * 4. In place construct without using low performance basic_document. Registered
+ * objects can be read with json::deserialize instead.
  *
  */
 template <typename Traits>
@@ -539,6 +673,7 @@ public:
     basic_document(const basic_document &other) {
         switch (other.type()) {
         case value_t::null:
+        case value_t::boolean:
         case value_t::number_unsigned:
         case value_t::number_signed:
         case value_t::number_float: {
@@ -551,11 +686,21 @@ public:
             break;
         }
         case value_t::object: {
-            __emplace_object(other.__get_object());
+            if constexpr (traits_type::is_shared) {
+                __document_share(static_cast<object_type *>(other.m_value.m_ptr));
+                m_value = other.m_value;
+            } else {
+                __emplace_object(other.__get_object());
+            }
             break;
         }
         case value_t::array: {
-            __emplace_array(other.__get_array());
+            if constexpr (traits_type::is_shared) {
+                __document_share(static_cast<array_type *>(other.m_value.m_ptr));
+                m_value = other.m_value;
+            } else {
+                __emplace_array(other.__get_array());
+            }
             break;
         }
         default: {
@@ -574,6 +719,11 @@ public:
             return *this;
         }
 
+        if constexpr (traits_type::is_shared) {
+            basic_document(other).swap(*this);
+            return *this;
+        }
+
         switch (type()) {
         case value_t::null:
         case value_t::boolean:
@@ -778,6 +928,17 @@ public:
     WJR_CONST static size_type max_depth_size() noexcept { return 256; }
 
     static result<basic_document> parse(const reader &rd) noexcept;
+    static result<basic_document> parse(stream_reader &rd) noexcept;
+
+    /**
+     * @brief Parse with object keys interned into pool.
+     *
+     * @details Only for documents whose string_type is a basic_interned_string,
+     * such as interned_document. Documents parsed with the same pool share
+     * their keys, so pool must outlive them.
+     */
+    static result<basic_document> parse(const reader &rd, key_pool &pool) noexcept;
+    static result<basic_document> parse(stream_reader &rd, key_pool &pool) noexcept;
 
     template <typename Container>
     void dump_impl(Container &cont, unsigned indents = -1) const noexcept {
@@ -962,6 +1123,19 @@ public:
 
     void swap(basic_document &other) noexcept { std::swap(m_value, other.m_value); }
 
+    /**
+     * @brief Copy every string that refers to the input into storage of the document.
+     *
+     * @details Only documents whose string_type is a basic_borrowed_string, such
+     * as view_document, borrow strings from the input. Call it before the input
+     * buffer is released. For other documents it does nothing.
+     */
+    void detach() {
+        if constexpr (is_borrowed_string_v<string_type>) {
+            __detach_impl();
+        }
+    }
+
     bool is_null() const noexcept { return type() == value_t::null; }
     bool is_boolean() const noexcept { return type() == value_t::boolean; }
     bool is_number_unsigned() const noexcept { return type() == value_t::number_unsigned; }
@@ -1073,6 +1247,10 @@ public:
 
 private:
     void __destroy() noexcept {
+        if constexpr (traits_type::is_arena) {
+            return;
+        }
+
         if WJR_BUILTIN_CONSTANT_CONSTEXPR (WJR_BUILTIN_CONSTANT_P(type())) {
             switch (type()) {
             case value_t::null:
@@ -1091,6 +1269,32 @@ private:
         __destroy_impl();
     }
 
+    void __detach_impl() {
+        switch (type()) {
+        case value_t::string: {
+            __get_string().detach();
+            break;
+        }
+        case value_t::object: {
+            for (auto &[key, value] : __get_object()) {
+                // detaching doesn't change the key, so the order of the object is kept
+                key.detach();
+                value.__detach_impl();
+            }
+            break;
+        }
+        case value_t::array: {
+            for (auto &value : __get_array()) {
+                value.__detach_impl();
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+        }
+    }
+
     void __destroy_impl() noexcept {
         switch (type()) {
         case value_t::null:
@@ -1101,15 +1305,15 @@ private:
             break;
         }
         case value_t::string: {
-            __document_destroy(std::addressof(__get_string()));
+            __document_destroy(static_cast<string_type *>(m_value.m_ptr));
             break;
         }
         case value_t::object: {
-            __document_destroy(std::addressof(__get_object()));
+            __document_destroy(static_cast<object_type *>(m_value.m_ptr));
             break;
         }
         case value_t::array: {
-            __document_destroy(std::addressof(__get_array()));
+            __document_destroy(static_cast<array_type *>(m_value.m_ptr));
             break;
         }
         default: {
@@ -1119,6 +1323,16 @@ private:
         }
     }
 
+    /// @brief Clone a node shared with other documents before it's written.
+    template <typename T>
+    void __unshare() noexcept(std::is_nothrow_copy_constructible_v<T>) {
+        auto *const ptr = static_cast<T *>(m_value.m_ptr);
+        if (WJR_UNLIKELY(!__document_is_unique(ptr))) {
+            m_value.m_ptr = __document_create<T>(std::as_const(*ptr));
+            __document_destroy(ptr);
+        }
+    }
+
     boolean_type &__get_boolean() noexcept { return m_value.m_boolean; }
     const boolean_type &__get_boolean() const noexcept { return m_value.m_boolean; }
 
@@ -1140,12 +1354,26 @@ private:
         return *static_cast<const string_type *>(m_value.m_ptr);
     }
 
-    object_type &__get_object() noexcept { return *static_cast<object_type *>(m_value.m_ptr); }
+    object_type &__get_object() noexcept(!traits_type::is_shared) {
+        if constexpr (traits_type::is_shared) {
+            __unshare<object_type>();
+        }
+
+        return *static_cast<object_type *>(m_value.m_ptr);
+    }
+
     const object_type &__get_object() const noexcept {
         return *static_cast<const object_type *>(m_value.m_ptr);
     }
 
-    array_type &__get_array() noexcept { return *static_cast<array_type *>(m_value.m_ptr); }
+    array_type &__get_array() noexcept(!traits_type::is_shared) {
+        if constexpr (traits_type::is_shared) {
+            __unshare<array_type>();
+        }
+
+        return *static_cast<array_type *>(m_value.m_ptr);
+    }
+
     const array_type &__get_array() const noexcept {
         return *static_cast<const array_type *>(m_value.m_ptr);
     }
@@ -1809,8 +2037,8 @@ namespace detail {
 
 template <typename Document>
 class basic_document_parser {
-    template <typename Parser>
-    friend result<void> visitor_detail::parse(Parser &&par, const reader &rd) noexcept;
+    template <typename Parser, typename TokenSource>
+    friend result<void> visitor_detail::parse_impl(Parser &&par, TokenSource &src) noexcept;
 
     using document_type = Document;
     using string_type = typename document_type::string_type;
@@ -1818,10 +2046,16 @@ class basic_document_parser {
     using array_type = typename document_type::array_type;
 
 public:
-    WJR_INTRINSIC_INLINE result<document_type> parse(const reader &rd) noexcept {
+    basic_document_parser() = default;
+
+    /// @brief Intern object keys into pool, string_type must be a basic_interned_string.
+    explicit basic_document_parser(key_pool &kp) noexcept : pool(std::addressof(kp)) {}
+
+    template <typename Reader>
+    WJR_INTRINSIC_INLINE result<document_type> parse(Reader &&rd) noexcept {
         document_type doc;
         current = std::addressof(doc);
-        WJR_EXPECTED_TRY(visitor_detail::parse(*this, rd));
+        WJR_EXPECTED_TRY(visitor_detail::parse(*this, std::forward<Reader>(rd)));
         return doc;
     }
 
@@ -1891,48 +2125,24 @@ protected:
 
     WJR_INTRINSIC_INLINE result<void> visit_root_string(const char *first,
                                                         const char *last) const noexcept {
-        string_type *str = __document_create<string_type>();
-        try_uninitialized_resize(*str, last - first);
-
-        auto ret = parse_string(str->data(), first, last);
-        if (WJR_UNLIKELY(!ret)) {
-            __document_destroy(str);
-            return unexpected(std::move(ret).error());
-        }
-
-        str->resize(*ret - str->data());
+        string_type *str;
+        WJR_EXPECTED_TRY(__create_string(str, first, last));
         current->m_value.set(string_t(), str);
         return {};
     }
 
     WJR_INTRINSIC_INLINE result<void> visit_object_string(const char *first,
                                                           const char *last) const noexcept {
-        string_type *str = __document_create<string_type>();
-        try_uninitialized_resize(*str, last - first);
-
-        auto ret = parse_string(str->data(), first, last);
-        if (WJR_UNLIKELY(!ret)) {
-            __document_destroy(str);
-            return unexpected(std::move(ret).error());
-        }
-
-        str->resize(*ret - str->data());
+        string_type *str;
+        WJR_EXPECTED_TRY(__create_string(str, first, last));
         element->m_value.set(string_t(), str);
         return {};
     }
 
     WJR_INTRINSIC_INLINE result<void> visit_array_string(const char *first,
                                                          const char *last) const noexcept {
-        string_type *str = __document_create<string_type>();
-        try_uninitialized_resize(*str, last - first);
-
-        auto ret = parse_string(str->data(), first, last);
-        if (WJR_UNLIKELY(!ret)) {
-            __document_destroy(str);
-            return unexpected(std::move(ret).error());
-        }
-
-        str->resize(*ret - str->data());
+        string_type *str;
+        WJR_EXPECTED_TRY(__create_string(str, first, last));
         current->__get_array().emplace_back(string_t(), str);
         return {};
     }
@@ -1940,10 +2150,20 @@ protected:
     WJR_INTRINSIC_INLINE result<void> visit_object_key_string(const char *first,
                                                               const char *last) noexcept {
         string_type str;
-        try_uninitialized_resize(str, last - first);
 
-        WJR_EXPECTED_INIT(ret, parse_string(str.data(), first, last));
-        str.resize(*ret - str.data());
+        if (!__try_borrow_string(str, first, last) && !__try_intern_string(str, first, last)) {
+            try_uninitialized_resize(str, last - first);
+
+            WJR_EXPECTED_INIT(ret, parse_string(str.data(), first, last));
+            str.resize(*ret - str.data());
+
+            if constexpr (is_interned_string_v<string_type>) {
+                if (pool != nullptr) {
+                    str = string_type(*pool, str.view());
+                }
+            }
+        }
+
         const auto iter = current->__get_object().try_emplace(std::move(str), default_construct);
         element = std::addressof(iter.first->second);
         if (WJR_UNLIKELY(!iter.second)) {
@@ -2025,20 +2245,71 @@ protected:
     }
 
 private:
+    /// @brief Strings without escapes can refer to the input if string_type allows it.
+    WJR_INTRINSIC_INLINE static bool __try_borrow_string(string_type &str, const char *first,
+                                                         const char *last) noexcept {
+        if constexpr (is_borrowed_string_v<string_type>) {
+            if (std::memchr(first, '\\', last - first) == nullptr) {
+                str = string_type(borrow_string, std::string_view(first, last - first));
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /// @brief Keys without escapes are interned as they are spelled in the input.
+    WJR_INTRINSIC_INLINE bool __try_intern_string(string_type &str, const char *first,
+                                                  const char *last) const {
+        if constexpr (is_interned_string_v<string_type>) {
+            if (pool != nullptr && std::memchr(first, '\\', last - first) == nullptr) {
+                str = string_type(*pool, std::string_view(first, last - first));
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    WJR_INTRINSIC_INLINE static result<void> __create_string(string_type *&str, const char *first,
+                                                            const char *last) noexcept {
+        str = __document_create<string_type>();
+
+        if (__try_borrow_string(*str, first, last)) {
+            return {};
+        }
+
+        try_uninitialized_resize(*str, last - first);
+
+        auto ret = parse_string(str->data(), first, last);
+        if (WJR_UNLIKELY(!ret)) {
+            __document_destroy(str);
+            return unexpected(std::move(ret).error());
+        }
+
+        str->resize(*ret - str->data());
+        return {};
+    }
+
     inplace_vector<document_type *, 256> stk;
     document_type *current;
     document_type *element;
+    key_pool *pool = nullptr;
 };
 
 class check_parser {
-    template <typename Parser>
-    friend result<void> visitor_detail::parse(Parser &&par, const reader &rd) noexcept;
+    template <typename Parser, typename TokenSource>
+    friend result<void> visitor_detail::parse_impl(Parser &&par, TokenSource &src) noexcept;
 
 public:
     WJR_INTRINSIC_INLINE static result<void> parse(const reader &rd) noexcept {
         return visitor_detail::parse(check_parser(), rd);
     }
 
+    WJR_INTRINSIC_INLINE static result<void> parse(stream_reader &rd) noexcept {
+        return visitor_detail::parse(check_parser(), rd);
+    }
+
 protected:
     WJR_INTRINSIC_INLINE result<void> visit_root_null(const char *first) const noexcept {
         return check_null(first);
@@ -2168,6 +2439,13 @@ parse<detail::basic_document_parser<document> &>(detail::basic_document_parser<d
 
 extern template result<void> parse<detail::check_parser>(detail::check_parser &&par,
                                                          const reader &rd) noexcept;
+
+extern template result<void>
+parse<detail::basic_document_parser<document> &>(detail::basic_document_parser<document> &par,
+                                                 stream_reader &rd) noexcept;
+
+extern template result<void> parse<detail::check_parser>(detail::check_parser &&par,
+                                                         stream_reader &rd) noexcept;
 } // namespace visitor_detail
 
 template <typename Traits>
@@ -2176,7 +2454,32 @@ result<basic_document<Traits>> basic_document<Traits>::parse(const reader &rd) n
     return par.parse(rd);
 }
 
+template <typename Traits>
+result<basic_document<Traits>> basic_document<Traits>::parse(stream_reader &rd) noexcept {
+    detail::basic_document_parser<basic_document<Traits>> par;
+    return par.parse(rd);
+}
+
+template <typename Traits>
+result<basic_document<Traits>> basic_document<Traits>::parse(const reader &rd,
+                                                             key_pool &pool) noexcept {
+    static_assert(is_interned_string_v<string_type>, "Keys can only be interned into "
+                                                     "documents of basic_interned_string.");
+    detail::basic_document_parser<basic_document<Traits>> par(pool);
+    return par.parse(rd);
+}
+
+template <typename Traits>
+result<basic_document<Traits>> basic_document<Traits>::parse(stream_reader &rd,
+                                                             key_pool &pool) noexcept {
+    static_assert(is_interned_string_v<string_type>, "Keys can only be interned into "
+                                                     "documents of basic_interned_string.");
+    detail::basic_document_parser<basic_document<Traits>> par(pool);
+    return par.parse(rd);
+}
+
 inline result<void> check(const reader &rd) noexcept { return detail::check_parser::parse(rd); }
+inline result<void> check(stream_reader &rd) noexcept { return detail::check_parser::parse(rd); }
 
 namespace detail {
 
@@ -2334,12 +2637,23 @@ bool operator==(const basic_document<Traits> &lhs, const basic_document<Traits>
                lhs.template get_unsafe<string_t>() == rhs.template get_unsafe<string_t>();
     }
     case value_t::object: {
-        return rhs.is_object() &&
-               lhs.template get_unsafe<object_t>() == rhs.template get_unsafe<object_t>();
+        if (!rhs.is_object()) {
+            return false;
+        }
+
+        // copies of a document with shared subtrees may share the node
+        const auto &lobj = lhs.template get_unsafe<object_t>();
+        const auto &robj = rhs.template get_unsafe<object_t>();
+        return std::addressof(lobj) == std::addressof(robj) || lobj == robj;
     }
     case value_t::array: {
-        return rhs.is_array() &&
-               lhs.template get_unsafe<array_t>() == rhs.template get_unsafe<array_t>();
+        if (!rhs.is_array()) {
+            return false;
+        }
+
+        const auto &larr = lhs.template get_unsafe<array_t>();
+        const auto &rarr = rhs.template get_unsafe<array_t>();
+        return std::addressof(larr) == std::addressof(rarr) || larr == rarr;
     }
     default: {
         WJR_UNREACHABLE();
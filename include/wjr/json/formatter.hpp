@@ -7,6 +7,10 @@
 #include <wjr/json/detail.hpp>
 #include <wjr/vector.hpp>
 
+#if defined(WJR_X86)
+    #include <wjr/arch/x86/json/formatter.hpp>
+#endif
+
 namespace wjr::json {
 
 namespace formatter_detail {
@@ -51,171 +55,100 @@ inline constexpr char needs_escaping[] = {
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 
-template <typename Container>
-WJR_INTRINSIC_INLINE void format_string(Container &cont, std::string_view str) {
-    auto first = str.data();
-    const auto length = str.size();
-
-    const auto old_size = cont.size();
-    try_uninitialized_append(cont, length + 2);
-    auto *ptr = cont.data() + old_size;
-    *ptr++ = '\"';
-
-    size_t pos = 0;
-
-    for (; pos + 8 <= length; pos += 8) {
-        // Poor's man vectorization. This could get much faster if we used SIMD.
+// If packed, this uses 8 * 32 bytes.
+// Note that we expect most compilers to embed this code in the
+// data section.
+inline constexpr escape_sequence escaped[32] = {
+    {6, "\\u0000"}, {6, "\\u0001"}, {6, "\\u0002"}, {6, "\\u0003"}, {6, "\\u0004"},
+    {6, "\\u0005"}, {6, "\\u0006"}, {6, "\\u0007"}, {2, "\\b"},     {2, "\\t"},
+    {2, "\\n"},     {6, "\\u000b"}, {2, "\\f"},     {2, "\\r"},     {6, "\\u000e"},
+    {6, "\\u000f"}, {6, "\\u0010"}, {6, "\\u0011"}, {6, "\\u0012"}, {6, "\\u0013"},
+    {6, "\\u0014"}, {6, "\\u0015"}, {6, "\\u0016"}, {6, "\\u0017"}, {6, "\\u0018"},
+    {6, "\\u0019"}, {6, "\\u001a"}, {6, "\\u001b"}, {6, "\\u001c"}, {6, "\\u001d"},
+    {6, "\\u001e"}, {6, "\\u001f"}};
+
+/// @brief First character in [first, last) that must be escaped, or last.
+WJR_PURE WJR_INTRINSIC_INLINE const char *find_escape(const char *first,
+                                                      const char *last) noexcept {
+#if WJR_HAS_BUILTIN(JSON_FIND_ESCAPE)
+    return builtin_find_escape(first, last);
+#else
+    for (; last - first >= 8; first += 8) {
+        // Poor's man vectorization.
         //
         // It is not the case that replacing '|' with '||' would be neutral
         // performance-wise.
-        if (needs_escaping[uint8_t(first[pos])] | needs_escaping[uint8_t(first[pos + 1])] |
-            needs_escaping[uint8_t(first[pos + 2])] | needs_escaping[uint8_t(first[pos + 3])] |
-            needs_escaping[uint8_t(first[pos + 4])] | needs_escaping[uint8_t(first[pos + 5])] |
-            needs_escaping[uint8_t(first[pos + 6])] | needs_escaping[uint8_t(first[pos + 7])]) {
-            goto SLOW_PATH;
+        if (needs_escaping[uint8_t(first[0])] | needs_escaping[uint8_t(first[1])] |
+            needs_escaping[uint8_t(first[2])] | needs_escaping[uint8_t(first[3])] |
+            needs_escaping[uint8_t(first[4])] | needs_escaping[uint8_t(first[5])] |
+            needs_escaping[uint8_t(first[6])] | needs_escaping[uint8_t(first[7])]) {
+            break;
         }
     }
 
-    for (; pos < length; pos++) {
-        if (needs_escaping[uint8_t(first[pos])]) {
-            goto SMALL_SLOW_PATH;
+    for (; first != last; ++first) {
+        if (needs_escaping[uint8_t(*first)]) {
+            break;
         }
     }
 
-    // The following is also possible and omits a 256-byte table, but it is
-    // slower: for (; (pos < unescaped.length()) && (uint8_t(unescaped[pos]) >
-    // 0x1F)
-    //      && (unescaped[pos] != '\"') && (unescaped[pos] != '\\'); pos++) {}
+    return first;
+#endif
+}
 
-    // At least for long strings, the following should be fast. We could
-    // do better by integrating the checks and the insertion.
-    std::memcpy(ptr, first, length);
-    ptr += length;
-    *ptr++ = '\"';
-    return;
-
-SLOW_PATH : {
-    // If packed, this uses 8 * 32 bytes.
-    // Note that we expect most compilers to embed this code in the
-    // data section.
-    constexpr static escape_sequence escaped[32] = {
-        {6, "\\u0000"}, {6, "\\u0001"}, {6, "\\u0002"}, {6, "\\u0003"}, {6, "\\u0004"},
-        {6, "\\u0005"}, {6, "\\u0006"}, {6, "\\u0007"}, {2, "\\b"},     {2, "\\t"},
-        {2, "\\n"},     {6, "\\u000b"}, {2, "\\f"},     {2, "\\r"},     {6, "\\u000e"},
-        {6, "\\u000f"}, {6, "\\u0010"}, {6, "\\u0011"}, {6, "\\u0012"}, {6, "\\u0013"},
-        {6, "\\u0014"}, {6, "\\u0015"}, {6, "\\u0016"}, {6, "\\u0017"}, {6, "\\u0018"},
-        {6, "\\u0019"}, {6, "\\u001a"}, {6, "\\u001b"}, {6, "\\u001c"}, {6, "\\u001d"},
-        {6, "\\u001e"}, {6, "\\u001f"}};
-
-    std::memcpy(ptr, first, pos);
-    try_uninitialized_resize(cont, (ptr + pos) - cont.data());
-
-    for (int i = 0; i < 8; ++i) {
-        switch (first[pos + i]) {
-        case '\"': {
-            append_string(cont, "\\\"", 2);
-            break;
-        }
-        case '\\': {
-            append_string(cont, "\\\\", 2);
-            break;
+template <typename Container>
+WJR_INTRINSIC_INLINE void append_escape(Container &cont, char ch) {
+    switch (ch) {
+    case '\"': {
+        append_string(cont, "\\\"", 2);
+        break;
+    }
+    case '\\': {
+        append_string(cont, "\\\\", 2);
+        break;
+    }
+    default: {
+        const auto u = escaped[uint8_t(ch)];
+        if (u.length == 2) {
+            append_string(cont, u.string, 2);
+        } else {
+            append_string(cont, u.string, 6);
         }
-        default:
-            if (uint8_t(first[pos + i]) <= 0x1F) {
-                const auto u = escaped[uint8_t(first[pos + i])];
-                if (u.length == 2) {
-                    append_string(cont, u.string, 2);
-                } else {
-                    append_string(cont, u.string, 6);
-                }
-            } else {
-                cont.push_back(first[pos + i]);
-            }
-        } // switch
     }
+    }
+}
+
+template <typename Container>
+WJR_INTRINSIC_INLINE void format_string(Container &cont, std::string_view str) {
+    const char *first = str.data();
+    const char *const last = first + str.size();
+    const char *hit = find_escape(first, last);
+    const auto length = static_cast<size_t>(hit - first);
+
+    const auto old_size = cont.size();
+    try_uninitialized_append(cont, length + 2);
+    auto *ptr = cont.data() + old_size;
+    *ptr++ = '\"';
+    std::memcpy(ptr, first, length);
+    ptr += length;
 
-    pos += 8;
-
-    if (pos + 8 <= length) {
-        size_t last_pos = pos;
-
-        do {
-            if (needs_escaping[uint8_t(first[pos])] | needs_escaping[uint8_t(first[pos + 1])] |
-                needs_escaping[uint8_t(first[pos + 2])] | needs_escaping[uint8_t(first[pos + 3])] |
-                needs_escaping[uint8_t(first[pos + 4])] | needs_escaping[uint8_t(first[pos + 5])] |
-                needs_escaping[uint8_t(first[pos + 6])] | needs_escaping[uint8_t(first[pos + 7])]) {
-                append_string(cont, first + last_pos, pos - last_pos);
-                last_pos = pos + 8;
-
-                for (int i = 0; i < 8; ++i) {
-                    switch (first[pos + i]) {
-                    case '\"': {
-                        append_string(cont, "\\\"", 2);
-                        break;
-                    }
-                    case '\\': {
-                        append_string(cont, "\\\\", 2);
-                        break;
-                    }
-                    default:
-                        if (uint8_t(first[pos + i]) <= 0x1F) {
-                            const auto u = escaped[uint8_t(first[pos + i])];
-                            if (u.length == 2) {
-                                append_string(cont, u.string, 2);
-                            } else {
-                                append_string(cont, u.string, 6);
-                            }
-                        } else {
-                            cont.push_back(first[pos + i]);
-                        }
-                    } // switch
-                }
-            }
-
-            pos += 8;
-        } while (pos + 8 <= length);
-
-        append_string(cont, first + last_pos, pos - last_pos);
+    // Most strings, and nearly all keys, need no escaping.
+    if (WJR_LIKELY(hit == last)) {
+        *ptr = '\"';
+        return;
     }
 
-    goto SMALL_SLOW_PATH_NO_COPY;
-
-SMALL_SLOW_PATH:
-    std::memcpy(ptr, first, pos);
-    try_uninitialized_resize(cont, (ptr + pos) - cont.data());
-SMALL_SLOW_PATH_NO_COPY:
-
-    // We caught a control character if we enter this loop (slow).
-    // Note that we are do not restart from the beginning, but rather we
-    // continue from the point where we encountered something that requires
-    // escaping.
-    for (; pos < length; pos++) {
-        switch (first[pos]) {
-        case '\"': {
-            append_string(cont, "\\\"", 2);
-            break;
-        }
-        case '\\': {
-            append_string(cont, "\\\\", 2);
-            break;
-        }
-        default:
-            if (uint8_t(first[pos]) <= 0x1F) {
-                const auto u = escaped[uint8_t(first[pos])];
-                if (u.length == 2) {
-                    append_string(cont, u.string, 2);
-                } else {
-                    append_string(cont, u.string, 6);
-                }
-            } else {
-                cont.push_back(first[pos]);
-            }
-        } // switch
-    }     // for
+    try_uninitialized_resize(cont, ptr - cont.data());
+
+    // Copy the runs between characters that must be escaped.
+    do {
+        append_escape(cont, *hit);
+        first = hit + 1;
+        hit = find_escape(first, last);
+        append_string(cont, first, static_cast<size_t>(hit - first));
+    } while (hit != last);
 
     cont.push_back('\"');
-    return;
-}
 }
 
 } // namespace formatter_detail
@@ -0,0 +1,62 @@
+/**
+ * @file hash_document.hpp
+ * @author wjr
+ * @brief JSON document whose objects are hash maps.
+ *
+ * @details Objects of a hash_document are flat_hash_map instead of btree_map,
+ * so looking up a key hashes it once instead of comparing it with log n keys,
+ * which pays off for wide objects. Fields are iterated, and dumped, in the
+ * order of the input instead of the order of the keys.
+ *
+ * @version 0.1
+ * @date 2025-01-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_HASH_DOCUMENT_HPP__
+#define WJR_JSON_HASH_DOCUMENT_HPP__
+
+#include <wjr/container/flat_hash_map.hpp>
+#include <wjr/json/document.hpp>
+
+namespace wjr::json {
+
+namespace detail {
+
+/// @brief Hash any string-like key as a std::string_view.
+struct document_key_hash {
+    using is_transparent = void;
+
+    template <typename Key>
+    size_t operator()(const Key &key) const noexcept {
+        return std::hash<std::string_view>()(std::string_view(key));
+    }
+};
+
+/// @brief Object of basic_document_traits, the ordering Pr is not used.
+template <typename Key, typename Value, typename Pr, typename Alloc>
+using hash_object = flat_hash_map<Key, Value, document_key_hash, std::equal_to<>, Alloc>;
+
+using hash_document_traits = basic_document_traits<std::basic_string, hash_object, vector>;
+
+} // namespace detail
+
+using hash_document = basic_document<detail::hash_document_traits>;
+
+namespace visitor_detail {
+
+extern template result<void>
+parse<detail::basic_document_parser<hash_document> &>(
+    detail::basic_document_parser<hash_document> &par, const reader &rd) noexcept;
+
+extern template result<void>
+parse<detail::basic_document_parser<hash_document> &>(
+    detail::basic_document_parser<hash_document> &par, stream_reader &rd) noexcept;
+
+} // namespace visitor_detail
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_HASH_DOCUMENT_HPP__
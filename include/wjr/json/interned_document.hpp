@@ -0,0 +1,62 @@
+/**
+ * @file interned_document.hpp
+ * @author wjr
+ * @brief JSON document whose object keys can be shared through a key_pool.
+ *
+ * @details Strings of an interned_document are basic_interned_string, 16 bytes
+ * instead of the 32 bytes of std::string. When parsed with a key_pool, every
+ * key refers to the pooled characters, so documents of the same schema store
+ * each key once.
+ *
+ * @version 0.1
+ * @date 2025-01-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_INTERNED_DOCUMENT_HPP__
+#define WJR_JSON_INTERNED_DOCUMENT_HPP__
+
+#include <wjr/json/document.hpp>
+
+namespace wjr::json {
+
+namespace detail {
+
+using interned_document_traits = basic_document_traits<basic_interned_string, btree_map, vector>;
+
+} // namespace detail
+
+/**
+ * @brief A document whose keys are interned when parsed with a key_pool.
+ *
+ * @details
+ * @code
+ * json::key_pool pool;
+ * for (auto &line : lines) {
+ *     json::reader rd(line);
+ *     records.emplace_back(*json::interned_document::parse(rd, pool));
+ * }
+ * @endcode
+ * The pool must outlive the documents and their copies. Without a pool,
+ * parse() gives every key storage of its own.
+ *
+ */
+using interned_document = basic_document<detail::interned_document_traits>;
+
+namespace visitor_detail {
+
+extern template result<void>
+parse<detail::basic_document_parser<interned_document> &>(
+    detail::basic_document_parser<interned_document> &par, const reader &rd) noexcept;
+
+extern template result<void>
+parse<detail::basic_document_parser<interned_document> &>(
+    detail::basic_document_parser<interned_document> &par, stream_reader &rd) noexcept;
+
+} // namespace visitor_detail
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_INTERNED_DOCUMENT_HPP__
@@ -0,0 +1,502 @@
+/**
+ * @file interned_string.hpp
+ * @author wjr
+ * @brief Object keys shared between documents through a key pool.
+ *
+ * @details A key_pool stores every distinct key once. Documents parsed with a
+ * pool, such as interned_document, keep a pointer to the pooled characters
+ * instead of a copy of their own, so records with the same schema share their
+ * keys. Equality returns true without looking at the characters when two keys
+ * point to the same ones, other comparisons still compare the characters.
+ *
+ * @version 0.1
+ * @date 2025-01-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_INTERNED_STRING_HPP__
+#define WJR_JSON_INTERNED_STRING_HPP__
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+#include <wjr/container/flat_hash_map.hpp>
+#include <wjr/tag.hpp>
+
+namespace wjr::json {
+
+/**
+ * @brief Immutable storage of distinct keys.
+ *
+ * @details Interned characters stay at the same address until the pool is
+ * destroyed, so the pool must outlive every string interned from it. A pool
+ * is not thread-safe, parsers running concurrently need a pool each.
+ */
+class key_pool {
+    static constexpr size_t block_size = 4096;
+
+public:
+    key_pool() = default;
+    key_pool(const key_pool &) = delete;
+    key_pool(key_pool &&) = delete;
+    key_pool &operator=(const key_pool &) = delete;
+    key_pool &operator=(key_pool &&) = delete;
+    ~key_pool() = default;
+
+    /// @brief Return the pooled copy of str, copying it into the pool the first time.
+    std::string_view intern(std::string_view str) {
+        const auto iter = m_keys.find(str);
+        if (WJR_LIKELY(iter != m_keys.end())) {
+            ++iter->second;
+            return iter->first;
+        }
+
+        const std::string_view key(__copy(str), str.size());
+        m_keys.try_emplace(key, 1);
+        return key;
+    }
+
+    /// @brief Number of distinct keys.
+    size_t size() const noexcept { return m_keys.size(); }
+
+    /// @brief Number of times str has been interned, 0 if it isn't in the pool.
+    size_t count(std::string_view str) const noexcept {
+        const auto iter = m_keys.find(str);
+        return iter != m_keys.end() ? iter->second : 0;
+    }
+
+private:
+    const char *__copy(std::string_view str) {
+        const size_t n = str.size();
+
+        if (WJR_UNLIKELY(n == 0)) {
+            return "";
+        }
+
+        if (WJR_UNLIKELY(n > static_cast<size_t>(m_end - m_ptr))) {
+            if (n > block_size / 4) {
+                // long keys get a block of their own, the current block is kept
+                auto &block = m_blocks.emplace_back(std::make_unique<char[]>(n));
+                std::memcpy(block.get(), str.data(), n);
+                return block.get();
+            }
+
+            m_ptr = m_blocks.emplace_back(std::make_unique<char[]>(block_size)).get();
+            m_end = m_ptr + block_size;
+        }
+
+        char *const ptr = m_ptr;
+        std::memcpy(ptr, str.data(), n);
+        m_ptr += n;
+        return ptr;
+    }
+
+    flat_hash_map<std::string_view, size_t> m_keys;
+    vector<std::unique_ptr<char[]>> m_blocks;
+    char *m_ptr = nullptr;
+    char *m_end = nullptr;
+};
+
+struct intern_string_t {};
+inline constexpr intern_string_t intern_string{};
+
+/**
+ * @brief A 16-byte string that either refers to a key_pool or owns its characters.
+ *
+ * @details Strings created from a pool are immutable and copied by pointer.
+ * Writing to one (non-const data() or resize()) first copies it into storage
+ * of its own. Owned strings have no small string buffer. Characters aren't
+ * null-terminated.
+ */
+template <typename Char, typename Traits = std::char_traits<Char>,
+          typename Alloc = std::allocator<Char>>
+class basic_interned_string {
+    using view_type = std::basic_string_view<Char, Traits>;
+    using alloc_traits = std::allocator_traits<Alloc>;
+
+    static_assert(alloc_traits::is_always_equal::value,
+                  "basic_interned_string doesn't store its allocator.");
+
+    // m_capacity of strings referring to a pool
+    static constexpr uint32_t interned_capacity = UINT32_MAX;
+
+    template <typename T>
+    using is_string_view_like =
+        std::conjunction<std::is_convertible<const T &, view_type>,
+                         std::negation<std::is_convertible<const T &, const Char *>>>;
+
+public:
+    using value_type = Char;
+    using traits_type = Traits;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using pointer = Char *;
+    using const_pointer = const Char *;
+    using const_iterator = const Char *;
+
+    basic_interned_string() = default;
+
+    basic_interned_string(const basic_interned_string &other) {
+        if (other.is_interned()) {
+            __copy_interned(other);
+        } else {
+            __assign(other.data(), other.size());
+        }
+    }
+
+    basic_interned_string(basic_interned_string &&other) noexcept
+        : m_data(other.m_data), m_size(other.m_size), m_capacity(other.m_capacity) {
+        other.__reset();
+    }
+
+    basic_interned_string &operator=(const basic_interned_string &other) {
+        if (WJR_UNLIKELY(this == std::addressof(other))) {
+            return *this;
+        }
+
+        if (other.is_interned()) {
+            __deallocate();
+            __copy_interned(other);
+        } else {
+            __assign(other.data(), other.size());
+        }
+
+        return *this;
+    }
+
+    basic_interned_string &operator=(basic_interned_string &&other) noexcept {
+        if (WJR_UNLIKELY(this == std::addressof(other))) {
+            return *this;
+        }
+
+        __deallocate();
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+        other.__reset();
+        return *this;
+    }
+
+    ~basic_interned_string() { __deallocate(); }
+
+    /// @brief Refer to str, which must stay at its address as long as this string.
+    basic_interned_string(intern_string_t, view_type str) noexcept
+        : m_data(str.empty() ? __empty() : const_cast<Char *>(str.data())),
+          m_size(__check_size(str.size())), m_capacity(interned_capacity) {}
+
+    /// @brief Intern str into pool and refer to the pooled characters.
+    basic_interned_string(key_pool &pool, view_type str)
+        : basic_interned_string(intern_string, pool.intern(str)) {}
+
+    basic_interned_string(const Char *str) { __assign(str, Traits::length(str)); }
+    basic_interned_string(const Char *str, size_type n) { __assign(str, n); }
+
+    template <typename T, WJR_REQUIRES(is_string_view_like<T>::value)>
+    explicit basic_interned_string(const T &str) {
+        const view_type view(str);
+        __assign(view.data(), view.size());
+    }
+
+    template <typename T, WJR_REQUIRES(is_string_view_like<T>::value)>
+    basic_interned_string &operator=(const T &str) {
+        const view_type view(str);
+        __assign(view.data(), view.size());
+        return *this;
+    }
+
+    /// @brief Return true if the characters belong to a key_pool.
+    bool is_interned() const noexcept { return m_capacity == interned_capacity; }
+
+    const Char *data() const noexcept { return m_data; }
+    size_type size() const noexcept { return m_size; }
+    size_type length() const noexcept { return size(); }
+    bool empty() const noexcept { return m_size == 0; }
+
+    /// @brief Writable characters, an interned string is copied first.
+    Char *data() {
+        __detach();
+        return m_data;
+    }
+
+    /// @brief The string is copied first if it's interned.
+    void resize(size_type n) {
+        const size_type old_size = m_size;
+        resize(n, default_construct);
+
+        if (n > old_size) {
+            Traits::assign(m_data + old_size, n - old_size, Char());
+        }
+    }
+
+    /// @brief Like resize(n), but new characters are left uninitialized.
+    void resize(size_type n, default_construct_t) {
+        __detach();
+
+        if (n > m_capacity) {
+            __reallocate(std::max<size_type>(n, m_size == 0 ? 0 : size_type(m_capacity) * 2));
+        }
+
+        m_size = __check_size(n);
+    }
+
+    void clear() noexcept {
+        if (is_interned()) {
+            __reset();
+        } else {
+            m_size = 0;
+        }
+    }
+
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + size(); }
+
+    const Char &operator[](size_type pos) const noexcept { return data()[pos]; }
+
+    view_type view() const noexcept { return view_type(data(), size()); }
+    operator view_type() const noexcept { return view(); }
+
+    friend bool operator==(const basic_interned_string &lhs,
+                           const basic_interned_string &rhs) noexcept {
+        return __equal(lhs.view(), rhs.view());
+    }
+
+    friend bool operator==(const basic_interned_string &lhs, view_type rhs) noexcept {
+        return __equal(lhs.view(), rhs);
+    }
+
+    friend bool operator==(view_type lhs, const basic_interned_string &rhs) noexcept {
+        return __equal(lhs, rhs.view());
+    }
+
+    friend bool operator==(const basic_interned_string &lhs, const Char *rhs) noexcept {
+        return __equal(lhs.view(), view_type(rhs));
+    }
+
+    friend bool operator==(const Char *lhs, const basic_interned_string &rhs) noexcept {
+        return __equal(view_type(lhs), rhs.view());
+    }
+
+    friend bool operator!=(const basic_interned_string &lhs,
+                           const basic_interned_string &rhs) noexcept {
+        return !__equal(lhs.view(), rhs.view());
+    }
+
+    friend bool operator!=(const basic_interned_string &lhs, view_type rhs) noexcept {
+        return !__equal(lhs.view(), rhs);
+    }
+
+    friend bool operator!=(view_type lhs, const basic_interned_string &rhs) noexcept {
+        return !__equal(lhs, rhs.view());
+    }
+
+    friend bool operator!=(const basic_interned_string &lhs, const Char *rhs) noexcept {
+        return !__equal(lhs.view(), view_type(rhs));
+    }
+
+    friend bool operator!=(const Char *lhs, const basic_interned_string &rhs) noexcept {
+        return !__equal(view_type(lhs), rhs.view());
+    }
+
+    friend bool operator<(const basic_interned_string &lhs,
+                          const basic_interned_string &rhs) noexcept {
+        return __less(lhs.view(), rhs.view());
+    }
+
+    friend bool operator<(const basic_interned_string &lhs, view_type rhs) noexcept {
+        return __less(lhs.view(), rhs);
+    }
+
+    friend bool operator<(view_type lhs, const basic_interned_string &rhs) noexcept {
+        return __less(lhs, rhs.view());
+    }
+
+    friend bool operator<(const basic_interned_string &lhs, const Char *rhs) noexcept {
+        return __less(lhs.view(), view_type(rhs));
+    }
+
+    friend bool operator<(const Char *lhs, const basic_interned_string &rhs) noexcept {
+        return __less(view_type(lhs), rhs.view());
+    }
+
+    friend bool operator>(const basic_interned_string &lhs,
+                          const basic_interned_string &rhs) noexcept {
+        return __less(rhs.view(), lhs.view());
+    }
+
+    friend bool operator>(const basic_interned_string &lhs, view_type rhs) noexcept {
+        return __less(rhs, lhs.view());
+    }
+
+    friend bool operator>(view_type lhs, const basic_interned_string &rhs) noexcept {
+        return __less(rhs.view(), lhs);
+    }
+
+    friend bool operator>(const basic_interned_string &lhs, const Char *rhs) noexcept {
+        return __less(view_type(rhs), lhs.view());
+    }
+
+    friend bool operator>(const Char *lhs, const basic_interned_string &rhs) noexcept {
+        return __less(rhs.view(), view_type(lhs));
+    }
+
+    friend bool operator<=(const basic_interned_string &lhs,
+                           const basic_interned_string &rhs) noexcept {
+        return !__less(rhs.view(), lhs.view());
+    }
+
+    friend bool operator<=(const basic_interned_string &lhs, view_type rhs) noexcept {
+        return !__less(rhs, lhs.view());
+    }
+
+    friend bool operator<=(view_type lhs, const basic_interned_string &rhs) noexcept {
+        return !__less(rhs.view(), lhs);
+    }
+
+    friend bool operator<=(const basic_interned_string &lhs, const Char *rhs) noexcept {
+        return !__less(view_type(rhs), lhs.view());
+    }
+
+    friend bool operator<=(const Char *lhs, const basic_interned_string &rhs) noexcept {
+        return !__less(rhs.view(), view_type(lhs));
+    }
+
+    friend bool operator>=(const basic_interned_string &lhs,
+                           const basic_interned_string &rhs) noexcept {
+        return !__less(lhs.view(), rhs.view());
+    }
+
+    friend bool operator>=(const basic_interned_string &lhs, view_type rhs) noexcept {
+        return !__less(lhs.view(), rhs);
+    }
+
+    friend bool operator>=(view_type lhs, const basic_interned_string &rhs) noexcept {
+        return !__less(lhs, rhs.view());
+    }
+
+    friend bool operator>=(const basic_interned_string &lhs, const Char *rhs) noexcept {
+        return !__less(lhs.view(), view_type(rhs));
+    }
+
+    friend bool operator>=(const Char *lhs, const basic_interned_string &rhs) noexcept {
+        return !__less(view_type(lhs), rhs.view());
+    }
+
+private:
+    // Keys of the same pool are equal only if they share their characters.
+    static bool __equal(view_type lhs, view_type rhs) noexcept {
+        return lhs.size() == rhs.size() &&
+               (lhs.data() == rhs.data() ||
+                Traits::compare(lhs.data(), rhs.data(), lhs.size()) == 0);
+    }
+
+    static bool __less(view_type lhs, view_type rhs) noexcept {
+        if (lhs.data() == rhs.data()) {
+            return lhs.size() < rhs.size();
+        }
+
+        return lhs < rhs;
+    }
+
+    static uint32_t __check_size(size_type n) noexcept {
+        WJR_ASSERT(n < interned_capacity);
+        return static_cast<uint32_t>(n);
+    }
+
+    void __copy_interned(const basic_interned_string &other) noexcept {
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+    }
+
+    // data() is never null, like std::basic_string
+    static Char *__empty() noexcept {
+        static Char buf[1] = {};
+        return buf;
+    }
+
+    void __reset() noexcept {
+        m_data = __empty();
+        m_size = 0;
+        m_capacity = 0;
+    }
+
+    // str may point into the current characters, they are released after the copy
+    void __assign(const Char *str, size_type n) {
+        const uint32_t size = __check_size(n);
+
+        if (is_interned() || n > m_capacity) {
+            Char *ptr = __empty();
+            if (n != 0) {
+                Alloc al;
+                ptr = alloc_traits::allocate(al, n);
+                Traits::copy(ptr, str, n);
+            }
+
+            __deallocate();
+            m_data = ptr;
+            m_capacity = size;
+        } else if (n != 0) {
+            Traits::move(m_data, str, n);
+        }
+
+        m_size = size;
+    }
+
+    void __detach() {
+        if (is_interned()) {
+            const Char *const str = m_data;
+            const uint32_t n = m_size;
+            __reset();
+            __reallocate(n);
+            if (n != 0) {
+                Traits::copy(m_data, str, n);
+            }
+            m_size = n;
+        }
+    }
+
+    // keeps the characters, m_data must be owned or null
+    void __reallocate(size_type n) {
+        if (n == 0) {
+            return;
+        }
+
+        Alloc al;
+        Char *const ptr = alloc_traits::allocate(al, n);
+        if (m_size != 0) {
+            Traits::copy(ptr, m_data, m_size);
+        }
+
+        __deallocate();
+        m_data = ptr;
+        m_capacity = __check_size(n);
+    }
+
+    void __deallocate() noexcept {
+        if (m_capacity != 0 && !is_interned()) {
+            Alloc al;
+            alloc_traits::deallocate(al, m_data, m_capacity);
+        }
+    }
+
+    Char *m_data = __empty();
+    uint32_t m_size = 0;
+    uint32_t m_capacity = 0;
+};
+
+template <typename T>
+struct is_interned_string : std::false_type {};
+
+template <typename Char, typename Traits, typename Alloc>
+struct is_interned_string<basic_interned_string<Char, Traits, Alloc>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool is_interned_string_v = is_interned_string<T>::value;
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_INTERNED_STRING_HPP__
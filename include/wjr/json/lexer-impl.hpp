@@ -3,6 +3,7 @@
 
 #include <wjr/crtp/class_base.hpp>
 #include <wjr/span.hpp>
+#include <wjr/vector.hpp>
 
 namespace wjr::json {
 
@@ -17,6 +18,34 @@ WJR_CONST WJR_INLINE_CONSTEXPR uint64_t calc_backslash(uint64_t B) noexcept {
     return even_series_codes_and_odd_bits ^ 0xAAAAAAAAAAAAAAAAULL;
 }
 
+/**
+ * @brief Whether the input ends inside a UTF-8 sequence.
+ *
+ * @param tail The last four bytes of the input, the last one in the highest byte.
+ */
+WJR_CONST WJR_INLINE_CONSTEXPR bool is_incomplete_utf8(uint32_t tail) noexcept {
+    return (tail >> 24) >= 0xC0 || ((tail >> 16) & 0xFF) >= 0xE0 || ((tail >> 8) & 0xFF) >= 0xF0;
+}
+
+/**
+ * @brief Lex a part of an input for both string states at its beginning.
+ *
+ * @details The part must begin at a multiple of 64 bytes from the beginning of the
+ * input, offset is that distance. prev_is_escape and prev_is_ws are the carry
+ * of the bytes before the part, they don't depend on the string state. \n
+ * Tokens are appended to tokens[0] as if the part begins outside a string, and to
+ * tokens[1] as if it begins inside one. \n
+ * prev_utf8 holds the four bytes before the part (0 for the first part), UTF-8
+ * errors of the part are or'ed into utf8_error. A sequence that is cut at the end
+ * of the part is checked by the next one, the end of the whole input is not
+ * checked.
+ *
+ * @return Whether the part ends inside a string when it begins outside one.
+ */
+bool read_speculative(const char *first, const char *last, uint32_t offset,
+                      uint64_t prev_is_escape, uint64_t prev_is_ws, uint32_t prev_utf8,
+                      bool &utf8_error, vector<uint32_t> (&tokens)[2]) noexcept;
+
 } // namespace lexer_detail
 
 class lexer {
@@ -58,6 +87,32 @@ public:
      */
     result_type read(uint32_t *token_buf, size_type token_buf_size) noexcept;
 
+    /**
+     * @brief Continue lexing on the input that directly follows the current one.
+     *
+     * @details The state carried between blocks (in string, escape, whitespace) is
+     * kept and token positions restart from offset, which must be a multiple of
+     * 64. The current input must have been read completely and its size must be a
+     * multiple of 64.
+     *
+     */
+    constexpr void rebind(span<const char> input, uint32_t offset = 0) noexcept {
+        first = input.data();
+        last = input.data() + input.size();
+        idx = offset;
+    }
+
+    /**
+     * @brief Whether the bytes read so far are valid UTF-8.
+     *
+     * @details Every block is validated while it is lexed. A sequence cut at the
+     * end is only an error once the whole input is read, so rebind() can continue
+     * it.
+     */
+    constexpr bool is_valid_utf8() const noexcept {
+        return !utf8_error && !lexer_detail::is_incomplete_utf8(prev_utf8);
+    }
+
     constexpr const char *begin() const noexcept { return first; }
     constexpr const char *end() const noexcept { return last; }
 
@@ -69,6 +124,9 @@ private:
     uint64_t prev_is_escape = 0;
     uint64_t prev_is_ws = ~0ull;
     uint32_t idx = 0;
+    // last four bytes of the previous block
+    uint32_t prev_utf8 = 0;
+    bool utf8_error = false;
 };
 
 extern WJR_ALL_NONNULL WJR_RETURNS_NONNULL char *minify(char *dst, const char *first,
@@ -0,0 +1,92 @@
+/**
+ * @file mapped_file.hpp
+ * @author wjr
+ * @brief Read-only view of a whole file, padded for vector loads.
+ *
+ * @details On Linux and other unices the file is mapped with mmap, so parsing
+ * it needs neither a copy nor a heap buffer of its size. At least padding zero
+ * bytes are readable after the end of the file, blocks of SIMD loads that
+ * cross the end never touch an unmapped page. Elsewhere the file is read into
+ * a padded heap buffer.
+ *
+ * @version 0.1
+ * @date 2025-01-20
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_MAPPED_FILE_HPP__
+#define WJR_JSON_MAPPED_FILE_HPP__
+
+#include <wjr/json/detail.hpp>
+#include <wjr/span.hpp>
+
+namespace wjr::json {
+
+class mapped_file {
+public:
+    /// @brief Readable zero bytes after the end of the file.
+    static constexpr size_t padding = 64;
+
+    mapped_file() = default;
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    mapped_file(mapped_file &&other) noexcept
+        : m_data(other.m_data), m_size(other.m_size), m_capacity(other.m_capacity) {
+        other.m_data = nullptr;
+        other.m_size = other.m_capacity = 0;
+    }
+
+    mapped_file &operator=(mapped_file &&other) noexcept {
+        if (WJR_LIKELY(this != std::addressof(other))) {
+            close();
+            m_data = other.m_data;
+            m_size = other.m_size;
+            m_capacity = other.m_capacity;
+            other.m_data = nullptr;
+            other.m_size = other.m_capacity = 0;
+        }
+
+        return *this;
+    }
+
+    ~mapped_file() noexcept { close(); }
+
+    /**
+     * @brief Map the file at path.
+     *
+     * @details The kernel is advised that the file is read sequentially.
+     * Return IO_ERROR if the file can't be opened, examined or mapped, and
+     * CAPACITY without mapping it if it's larger than max_size bytes.
+     */
+    WJR_NODISCARD static result<mapped_file> open(const char *path,
+                                                  size_t max_size = SIZE_MAX) noexcept;
+
+    /// @brief Unmap the file, it can no longer be read.
+    void close() noexcept;
+
+    bool is_open() const noexcept { return m_data != nullptr; }
+
+    const char *data() const noexcept { return m_data; }
+    size_t size() const noexcept { return m_size; }
+
+    const char *begin() const noexcept { return m_data; }
+    const char *end() const noexcept { return m_data + m_size; }
+
+    operator span<const char>() const noexcept { return span<const char>(m_data, m_size); }
+
+private:
+    mapped_file(char *data, size_t size, size_t capacity) noexcept
+        : m_data(data), m_size(size), m_capacity(capacity) {}
+
+    char *m_data = nullptr;
+    size_t m_size = 0;
+    // bytes of the mapping, or of the heap buffer
+    size_t m_capacity = 0;
+};
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_MAPPED_FILE_HPP__
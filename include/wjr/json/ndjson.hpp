@@ -0,0 +1,162 @@
+/**
+ * @file ndjson.hpp
+ * @author wjr
+ * @brief Parse newline-delimited JSON on several threads.
+ * @version 0.1
+ * @date 2025-01-12
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_NDJSON_HPP__
+#define WJR_JSON_NDJSON_HPP__
+
+#include <thread>
+
+#include <wjr/json/document.hpp>
+
+namespace wjr::json {
+
+namespace ndjson_detail {
+
+/// @brief Chunks smaller than this are not worth a thread.
+inline constexpr size_t min_chunk_size = 64_KB;
+
+/**
+ * @brief Split the input into at most n chunks, each of them ends after a newline
+ * or at the end of the input.
+ *
+ * @details A raw newline can't appear inside a valid JSON value, so records never
+ * cross chunks.
+ */
+inline vector<span<const char>> split_chunks(span<const char> input, unsigned int n) noexcept {
+    n = static_cast<unsigned int>(
+        std::max<size_t>(1, std::min<size_t>(n, input.size() / min_chunk_size)));
+
+    vector<span<const char>> chunks;
+    chunks.reserve(n);
+
+    const char *first = input.data();
+    const char *const last = input.data() + input.size();
+
+    for (unsigned int i = 1; i < n && first != last; ++i) {
+        const size_t rest = static_cast<size_t>(last - first);
+        const char *mid = first + rest / (n - i + 1);
+        const auto *const nl = static_cast<const char *>(
+            std::memchr(mid, '\n', static_cast<size_t>(last - mid)));
+        mid = nl == nullptr ? last : nl + 1;
+        chunks.emplace_back(first, static_cast<size_t>(mid - first));
+        first = mid;
+    }
+
+    if (first != last) {
+        chunks.emplace_back(first, static_cast<size_t>(last - first));
+    }
+
+    return chunks;
+}
+
+/// @brief Call func(rd) for every non-blank line of the chunk.
+template <typename Func>
+void for_each_record(span<const char> chunk, Func &func) noexcept {
+    const char *first = chunk.data();
+    const char *const last = chunk.data() + chunk.size();
+    reader rd;
+
+    while (first != last) {
+        const auto *nl =
+            static_cast<const char *>(std::memchr(first, '\n', static_cast<size_t>(last - first)));
+        if (nl == nullptr) {
+            nl = last;
+        }
+
+        rd.read(span<const char>(first, static_cast<size_t>(nl - first)));
+        // Lines with only whitespace have no token.
+        if (rd.begin() != rd.end()) {
+            func(rd);
+        }
+
+        first = nl == last ? last : nl + 1;
+    }
+}
+
+} // namespace ndjson_detail
+
+/**
+ * @brief Parse newline-delimited JSON (JSON lines) on several threads.
+ *
+ * @details The input is split at newlines into one contiguous chunk of records
+ * per thread. func(const reader &) is called once for every non-blank line,
+ * concurrently from several threads, and its return values are returned in input
+ * order. \n
+ * If threads is 0, std::thread::hardware_concurrency() is used. Inputs smaller than
+ * 64 KiB per thread use fewer threads.
+ *
+ */
+template <typename Func>
+vector<std::invoke_result_t<const Func &, const reader &>>
+parse_ndjson(span<const char> input, unsigned int threads, const Func &func) noexcept {
+    using value_type = std::invoke_result_t<const Func &, const reader &>;
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    const auto chunks = ndjson_detail::split_chunks(input, threads);
+    const size_t n = chunks.size();
+    vector<vector<value_type>> results(n);
+
+    auto work = [&chunks, &results, &func](size_t i) {
+        auto &result = results[i];
+        auto callback = [&result, &func](const reader &rd) { result.emplace_back(func(rd)); };
+        ndjson_detail::for_each_record(chunks[i], callback);
+    };
+
+    vector<std::thread> workers;
+    workers.reserve(n);
+    for (size_t i = 1; i < n; ++i) {
+        workers.emplace_back(work, i);
+    }
+
+    if (n != 0) {
+        work(0);
+    }
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    if (n == 1) {
+        return std::move(results[0]);
+    }
+
+    size_t count = 0;
+    for (const auto &result : results) {
+        count += result.size();
+    }
+
+    vector<value_type> ret;
+    ret.reserve(count);
+    for (auto &result : results) {
+        for (auto &value : result) {
+            ret.emplace_back(std::move(value));
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Parse every record of newline-delimited JSON into a document.
+ *
+ * @return Results of all records in input order.
+ */
+template <typename Document = document>
+vector<result<Document>> parse_ndjson(span<const char> input, unsigned int threads = 0) noexcept {
+    return parse_ndjson(input, threads, [](const reader &rd) { return Document::parse(rd); });
+}
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_NDJSON_HPP__
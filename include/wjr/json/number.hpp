@@ -83,6 +83,70 @@ WJR_PURE WJR_INTRINSIC_INLINE result<void> check_number(const char *first,
     return parse_number(first, last, value);
 }
 
+/**
+ * @brief Check the grammar of the number in [first, last) without converting it.
+ *
+ * @details Unlike check_number, a number that doesn't fit a double isn't an
+ * error, and nothing but the number may be in [first, last).
+ */
+WJR_PURE inline result<void> check_number_syntax(const char *first, const char *last) noexcept {
+    const auto digits = [last](const char *ptr) noexcept {
+        while (ptr != last && static_cast<uint8_t>(*ptr - '0') < 10) {
+            ++ptr;
+        }
+
+        return ptr;
+    };
+
+    if (first != last && *first == '-') {
+        ++first;
+    }
+
+    if (WJR_UNLIKELY(first == last)) {
+        return unexpected(error_code::TAPE_ERROR);
+    }
+
+    if (*first == '0') {
+        ++first;
+    } else {
+        const char *const ptr = digits(first);
+        if (WJR_UNLIKELY(ptr == first)) {
+            return unexpected(error_code::TAPE_ERROR);
+        }
+
+        first = ptr;
+    }
+
+    if (first != last && *first == '.') {
+        const char *const ptr = digits(++first);
+        if (WJR_UNLIKELY(ptr == first)) {
+            return unexpected(error_code::TAPE_ERROR);
+        }
+
+        first = ptr;
+    }
+
+    if (first != last && (*first == 'e' || *first == 'E')) {
+        ++first;
+        if (first != last && (*first == '+' || *first == '-')) {
+            ++first;
+        }
+
+        const char *const ptr = digits(first);
+        if (WJR_UNLIKELY(ptr == first)) {
+            return unexpected(error_code::TAPE_ERROR);
+        }
+
+        first = ptr;
+    }
+
+    if (WJR_UNLIKELY(first != last)) {
+        return unexpected(error_code::TAPE_ERROR);
+    }
+
+    return {};
+}
+
 } // namespace detail
 
 } // namespace wjr::json
@@ -0,0 +1,867 @@
+/**
+ * @file ondemand.hpp
+ * @author wjr
+ * @brief Lazy, forward-only access to a JSON text through the tokens of a
+ * json::reader.
+ *
+ * @details Nothing is materialized up front. A value is only a pointer into the
+ * token array of the reader, and numbers and strings are decoded when they are
+ * asked for. Skipping an unread object or array walks its tokens and counts the
+ * bracket depth, so the bytes inside the subtree are never touched. \n
+ * Only the parts that are visited are validated. Use json::check when the whole
+ * input must be known to be valid JSON.
+ *
+ * @version 0.1
+ * @date 2025-01-06
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_ONDEMAND_HPP__
+#define WJR_JSON_ONDEMAND_HPP__
+
+#include <memory>
+
+#include <wjr/json/visitor.hpp>
+
+namespace wjr::json::ondemand {
+
+class document;
+class value;
+class object;
+class array;
+
+enum class json_type : uint8_t {
+    null,
+    boolean,
+    number,
+    string,
+    object,
+    array,
+};
+
+namespace detail {
+
+struct cursor {
+    using token_pointer = const uint32_t *;
+
+    WJR_PURE uint8_t get(token_pointer iter) const noexcept {
+        return static_cast<uint8_t>(ptr[*iter]);
+    }
+
+    WJR_PURE const char *begin_of(token_pointer iter) const noexcept { return ptr + *iter; }
+
+    /// @brief The end of a scalar is the position of the token that follows it.
+    WJR_PURE const char *end_of(token_pointer iter) const noexcept {
+        return iter + 1 != last ? ptr + iter[1] : ptr + size;
+    }
+
+    /// @brief Check that the atom at @a iter is exactly @a length characters.
+    WJR_PURE bool is_invalid_atom(token_pointer iter, uint32_t length) const noexcept {
+        const uint32_t end = iter + 1 != last ? iter[1] : size;
+        return json::detail::is_invalid_token(ptr, *iter, end, length);
+    }
+
+    /**
+     * @brief Return the token after the value that starts at @a iter, or nullptr
+     * if the tokens end before the value is closed.
+     *
+     * @details Inside an object or array only the bracket depth is tracked. A
+     * quote always comes with its closing quote as the next token, so both are
+     * stepped over together.
+     */
+    WJR_PURE token_pointer skip(token_pointer iter) const noexcept {
+        switch (get(iter)) {
+        case '"': {
+            return last - iter >= 2 ? iter + 2 : nullptr;
+        }
+        case '{':
+        case '[': {
+            break;
+        }
+        default: {
+            return iter + 1;
+        }
+        }
+
+        unsigned int depth = 1;
+        ++iter;
+
+        while (iter != last) {
+            switch (get(iter++)) {
+            case '"': {
+                if (WJR_UNLIKELY(iter == last)) {
+                    return nullptr;
+                }
+
+                ++iter;
+                break;
+            }
+            case '{':
+            case '[': {
+                ++depth;
+                break;
+            }
+            case '}':
+            case ']': {
+                if (--depth == 0) {
+                    return iter;
+                }
+
+                break;
+            }
+            default: {
+                break;
+            }
+            }
+        }
+
+        return nullptr;
+    }
+
+    const char *ptr;
+    uint32_t size;
+    token_pointer first;
+    token_pointer last;
+};
+
+} // namespace detail
+
+class field;
+
+/**
+ * @brief A lazily decoded JSON value.
+ *
+ * @details Copying a value is cheap, it's only a pair of pointers. A value is
+ * valid as long as the document it comes from.
+ */
+class value {
+    friend class document;
+    friend class object;
+    friend class array;
+    friend class field;
+
+    using token_pointer = const uint32_t *;
+
+public:
+    value() = default;
+    value(const value &) = default;
+    value &operator=(const value &) = default;
+    ~value() = default;
+
+    json_type type() const noexcept;
+
+    bool is_null() const noexcept;
+
+    result<bool> get_bool() const noexcept;
+    result<uint64_t> get_uint64() const noexcept;
+    result<int64_t> get_int64() const noexcept;
+    result<double> get_double() const noexcept;
+
+    /**
+     * @brief Get the decoded string.
+     *
+     * @details Strings without escape sequences are returned as a view into the
+     * input. Others are decoded into a buffer owned by the document.
+     */
+    result<std::string_view> get_string_view() const noexcept;
+
+    result<object> get_object() const noexcept;
+    result<array> get_array() const noexcept;
+
+    /// @brief The raw text of the value, including quotes and brackets.
+    result<std::string_view> raw_json() const noexcept;
+
+    /// @brief Same as get_object().find_field_unordered(key).
+    result<value> operator[](std::string_view key) const noexcept;
+
+private:
+    value(document *doc, token_pointer iter) noexcept : m_doc(doc), m_iter(iter) {}
+
+    const detail::cursor &__cursor() const noexcept;
+    uint8_t __get() const noexcept;
+    result<void> __parse_number(basic_value &val) const noexcept;
+
+    document *m_doc = nullptr;
+    token_pointer m_iter = nullptr;
+};
+
+/**
+ * @brief A field of an object: the raw key and its value.
+ *
+ * @details The key is the text between the quotes as it appears in the input,
+ * escape sequences are not decoded.
+ */
+class field {
+    friend class object;
+
+public:
+    field() = default;
+
+    std::string_view key() const noexcept { return m_key; }
+    const ondemand::value &value() const noexcept { return m_value; }
+
+private:
+    field(std::string_view key, ondemand::value val) noexcept : m_key(key), m_value(val) {}
+
+    std::string_view m_key;
+    ondemand::value m_value;
+};
+
+/**
+ * @brief A JSON object that is iterated or searched without decoding it.
+ *
+ * @details find_field only searches forward from the last found field, so
+ * looking up fields in document order visits every token at most once.
+ * find_field_unordered wraps around to the first field when needed. \n
+ * A field that isn't followed by ',' and a key, or by '}', is an error: lookups
+ * and count_fields return it, and iteration stops with it, see iterator::error.
+ */
+class object {
+    friend class value;
+
+    using token_pointer = const uint32_t *;
+
+public:
+    class iterator {
+        friend class object;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ondemand::field;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type *;
+        using reference = const value_type &;
+
+        iterator() = default;
+
+        reference operator*() const noexcept { return m_field; }
+        pointer operator->() const noexcept { return std::addressof(m_field); }
+
+        iterator &operator++() noexcept {
+            if (auto next = object::__next(m_doc, m_iter); WJR_LIKELY(next)) {
+                m_iter = *next;
+            } else {
+                m_iter = nullptr;
+                m_error = next.error();
+            }
+
+            __load();
+            return *this;
+        }
+
+        iterator operator++(int) noexcept {
+            iterator tmp(*this);
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const iterator &other) const noexcept { return m_iter == other.m_iter; }
+        bool operator!=(const iterator &other) const noexcept { return m_iter != other.m_iter; }
+
+        /**
+         * @brief Why the iteration ended.
+         *
+         * @details SUCCESS if the last field is followed by '}', otherwise the
+         * error of the malformed or truncated field that ended it.
+         */
+        error_code error() const noexcept { return m_error; }
+
+    private:
+        iterator(document *doc, token_pointer iter) noexcept : m_doc(doc), m_iter(iter) {
+            __load();
+        }
+
+        void __load() noexcept {
+            if (m_iter != nullptr) {
+                m_field = object::__field(m_doc, m_iter);
+            }
+        }
+
+        document *m_doc = nullptr;
+        token_pointer m_iter = nullptr;
+        ondemand::field m_field;
+        error_code m_error = error_code::SUCCESS;
+    };
+
+    object() = default;
+
+    iterator begin() const noexcept { return iterator(m_doc, m_first); }
+    iterator end() const noexcept { return iterator(m_doc, nullptr); }
+
+    bool empty() const noexcept { return m_first == nullptr; }
+
+    /// @brief Number of fields, this walks over every field.
+    result<size_t> count_fields() const noexcept;
+
+    /**
+     * @brief Find a field after the last one found.
+     *
+     * @details The key is compared with the raw key in the input.
+     */
+    result<value> find_field(std::string_view key) noexcept;
+
+    /// @brief Find a field anywhere in the object.
+    result<value> find_field_unordered(std::string_view key) noexcept;
+
+    result<value> operator[](std::string_view key) noexcept { return find_field_unordered(key); }
+
+    /// @brief Restart find_field from the first field.
+    void reset() noexcept { m_iter = m_first; }
+
+private:
+    object(document *doc, token_pointer first) noexcept
+        : m_doc(doc), m_first(first), m_iter(first) {}
+
+    static const detail::cursor &__cursor(const document *doc) noexcept;
+
+    static std::string_view __key(const document *doc, token_pointer iter) noexcept {
+        return std::string_view(__cursor(doc).begin_of(iter) + 1, iter[1] - iter[0] - 1);
+    }
+
+    static field __field(document *doc, token_pointer iter) noexcept {
+        return field(__key(doc, iter), value(doc, iter + 3));
+    }
+
+    /**
+     * @brief Return the next key token, or nullptr if the field is the last one.
+     *
+     * @details A field followed by anything else than ',' and a key, or '}', is
+     * an error, so a malformed object is never taken for its end.
+     */
+    static result<token_pointer> __next(const document *doc, token_pointer iter) noexcept;
+
+    result<value> __find(token_pointer &iter, token_pointer last, std::string_view key) noexcept;
+
+    document *m_doc = nullptr;
+    // key token of the first field, nullptr if empty
+    token_pointer m_first = nullptr;
+    token_pointer m_iter = nullptr;
+};
+
+class array {
+    friend class value;
+
+    using token_pointer = const uint32_t *;
+
+public:
+    class iterator {
+        friend class array;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ondemand::value;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type *;
+        using reference = const value_type &;
+
+        iterator() = default;
+
+        reference operator*() const noexcept { return m_value; }
+        pointer operator->() const noexcept { return std::addressof(m_value); }
+
+        iterator &operator++() noexcept {
+            if (auto next = array::__next(m_value.m_doc, m_value.m_iter); WJR_LIKELY(next)) {
+                m_value.m_iter = *next;
+            } else {
+                m_value.m_iter = nullptr;
+                m_error = next.error();
+            }
+
+            return *this;
+        }
+
+        iterator operator++(int) noexcept {
+            iterator tmp(*this);
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const iterator &other) const noexcept {
+            return m_value.m_iter == other.m_value.m_iter;
+        }
+
+        bool operator!=(const iterator &other) const noexcept {
+            return m_value.m_iter != other.m_value.m_iter;
+        }
+
+        /// @brief Why the iteration ended, see object::iterator::error.
+        error_code error() const noexcept { return m_error; }
+
+    private:
+        iterator(document *doc, token_pointer iter) noexcept : m_value(doc, iter) {}
+
+        ondemand::value m_value;
+        error_code m_error = error_code::SUCCESS;
+    };
+
+    array() = default;
+
+    iterator begin() const noexcept { return iterator(m_doc, m_first); }
+    iterator end() const noexcept { return iterator(m_doc, nullptr); }
+
+    bool empty() const noexcept { return m_first == nullptr; }
+
+    /// @brief Number of elements, this walks over every element.
+    result<size_t> count_elements() const noexcept;
+
+    result<value> at(size_t index) const noexcept;
+
+private:
+    array(document *doc, token_pointer first) noexcept : m_doc(doc), m_first(first) {}
+
+    static const detail::cursor &__cursor(const document *doc) noexcept;
+
+    /// @brief Tokens that can't start an element.
+    static constexpr bool __is_close(uint8_t ch) noexcept {
+        return ch == ',' || ch == ':' || ch == ']' || ch == '}';
+    }
+
+    /// @brief Return the next element, or nullptr if the element is the last one.
+    static result<token_pointer> __next(const document *doc, token_pointer iter) noexcept;
+
+    document *m_doc = nullptr;
+    token_pointer m_first = nullptr;
+};
+
+/**
+ * @brief Entry point of the on-demand API.
+ *
+ * @details The reader (and the input it was read from) must outlive the document
+ * and every value obtained from it. Decoded strings are kept until the document
+ * is destroyed. Values point to their document, so it can't be moved.
+ */
+class document {
+    friend class value;
+    friend class object;
+    friend class array;
+
+    using token_pointer = const uint32_t *;
+
+public:
+    document() = delete;
+    document(const document &) = delete;
+    document(document &&) = delete;
+    document &operator=(const document &) = delete;
+    document &operator=(document &&) = delete;
+    ~document() = default;
+
+    explicit document(const reader &rd) noexcept
+        : m_cursor{rd.data(), rd.size(), wjr::to_address(rd.begin()), wjr::to_address(rd.end())},
+          m_valid_utf8(rd.is_valid_utf8()) {}
+
+    result<value> root() noexcept {
+        if (WJR_UNLIKELY(!m_valid_utf8)) {
+            return unexpected(error_code::UTF8_ERROR);
+        }
+
+        if (WJR_UNLIKELY(m_cursor.first == m_cursor.last)) {
+            return unexpected(error_code::EMPTY);
+        }
+
+        return value(this, m_cursor.first);
+    }
+
+    result<object> get_object() noexcept {
+        WJR_EXPECTED_INIT(ret, root());
+        return ret->get_object();
+    }
+
+    result<array> get_array() noexcept {
+        WJR_EXPECTED_INIT(ret, root());
+        return ret->get_array();
+    }
+
+    result<value> operator[](std::string_view key) noexcept {
+        WJR_EXPECTED_INIT(ret, root());
+        return (*ret)[key];
+    }
+
+private:
+    result<std::string_view> __decode_string(const char *first, const char *last) noexcept;
+
+    detail::cursor m_cursor;
+    bool m_valid_utf8;
+    // decoded strings are never moved, so views into them stay valid
+    vector<std::unique_ptr<char[]>> m_blocks;
+    char *m_buffer = nullptr;
+    size_t m_rest = 0;
+    size_t m_block_size = 4096;
+};
+
+inline const detail::cursor &value::__cursor() const noexcept { return m_doc->m_cursor; }
+inline const detail::cursor &object::__cursor(const document *doc) noexcept {
+    return doc->m_cursor;
+}
+
+inline const detail::cursor &array::__cursor(const document *doc) noexcept {
+    return doc->m_cursor;
+}
+
+inline uint8_t value::__get() const noexcept { return __cursor().get(m_iter); }
+
+inline json_type value::type() const noexcept {
+    switch (__get()) {
+    case '{':
+        return json_type::object;
+    case '[':
+        return json_type::array;
+    case '"':
+        return json_type::string;
+    case 't':
+    case 'f':
+        return json_type::boolean;
+    case 'n':
+        return json_type::null;
+    default:
+        return json_type::number;
+    }
+}
+
+inline bool value::is_null() const noexcept {
+    const auto &cur = __cursor();
+    return cur.get(m_iter) == 'n' && !cur.is_invalid_atom(m_iter, 4) &&
+           json::detail::check_null(cur.begin_of(m_iter)).has_value();
+}
+
+inline result<bool> value::get_bool() const noexcept {
+    const auto &cur = __cursor();
+    const char *const first = cur.begin_of(m_iter);
+
+    switch (*first) {
+    case 't': {
+        if (WJR_UNLIKELY(cur.is_invalid_atom(m_iter, 4))) {
+            return unexpected(error_code::T_ATOM_ERROR);
+        }
+
+        WJR_EXPECTED_TRY(json::detail::check_true(first));
+        return true;
+    }
+    case 'f': {
+        if (WJR_UNLIKELY(cur.is_invalid_atom(m_iter, 5))) {
+            return unexpected(error_code::F_ATOM_ERROR);
+        }
+
+        WJR_EXPECTED_TRY(json::detail::check_false(first));
+        return false;
+    }
+    default: {
+        return unexpected(error_code::INCORRECT_TYPE);
+    }
+    }
+}
+
+inline result<void> value::__parse_number(basic_value &val) const noexcept {
+    const auto &cur = __cursor();
+    const uint8_t ch = cur.get(m_iter);
+    if (WJR_UNLIKELY(ch != '-' && (ch < '0' || ch > '9'))) {
+        return unexpected(error_code::INCORRECT_TYPE);
+    }
+
+    return json::detail::parse_number(cur.begin_of(m_iter), cur.end_of(m_iter), val);
+}
+
+inline result<uint64_t> value::get_uint64() const noexcept {
+    basic_value val(default_construct);
+    WJR_EXPECTED_TRY(__parse_number(val));
+
+    if (WJR_UNLIKELY(val.m_type != value_t::number_unsigned)) {
+        return unexpected(error_code::NUMBER_OUT_OF_RANGE);
+    }
+
+    return val.m_number_unsigned;
+}
+
+inline result<int64_t> value::get_int64() const noexcept {
+    basic_value val(default_construct);
+    WJR_EXPECTED_TRY(__parse_number(val));
+
+    switch (val.m_type) {
+    case value_t::number_signed: {
+        return val.m_number_signed;
+    }
+    case value_t::number_unsigned: {
+        if (WJR_UNLIKELY(val.m_number_unsigned >
+                         static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))) {
+            return unexpected(error_code::NUMBER_OUT_OF_RANGE);
+        }
+
+        return static_cast<int64_t>(val.m_number_unsigned);
+    }
+    default: {
+        return unexpected(error_code::NUMBER_OUT_OF_RANGE);
+    }
+    }
+}
+
+inline result<double> value::get_double() const noexcept {
+    basic_value val(default_construct);
+    WJR_EXPECTED_TRY(__parse_number(val));
+
+    switch (val.m_type) {
+    case value_t::number_unsigned: {
+        return static_cast<double>(val.m_number_unsigned);
+    }
+    case value_t::number_signed: {
+        return static_cast<double>(val.m_number_signed);
+    }
+    default: {
+        return val.m_number_float;
+    }
+    }
+}
+
+inline result<std::string_view> value::get_string_view() const noexcept {
+    const auto &cur = __cursor();
+    if (WJR_UNLIKELY(cur.get(m_iter) != '"')) {
+        return unexpected(error_code::INCORRECT_TYPE);
+    }
+
+    if (WJR_UNLIKELY(cur.last - m_iter < 2 || cur.get(m_iter + 1) != '"')) {
+        return unexpected(error_code::UNCLOSED_STRING);
+    }
+
+    const char *const first = cur.begin_of(m_iter) + 1;
+    const char *const last = cur.begin_of(m_iter + 1);
+    const size_t length = static_cast<size_t>(last - first);
+
+    if (std::memchr(first, '\\', length) == nullptr) {
+        return std::string_view(first, length);
+    }
+
+    return m_doc->__decode_string(first, last);
+}
+
+inline result<object> value::get_object() const noexcept {
+    const auto &cur = __cursor();
+    if (WJR_UNLIKELY(cur.get(m_iter) != '{')) {
+        return unexpected(error_code::INCORRECT_TYPE);
+    }
+
+    if (WJR_UNLIKELY(m_iter + 1 == cur.last)) {
+        return unexpected(error_code::INCOMPLETE_ARRAY_OR_OBJECT);
+    }
+
+    switch (cur.get(m_iter + 1)) {
+    case '}': {
+        return object(m_doc, nullptr);
+    }
+    case '"': {
+        if (WJR_UNLIKELY(cur.last - m_iter < 5 || cur.get(m_iter + 3) != ':')) {
+            return unexpected(error_code::TAPE_ERROR);
+        }
+
+        return object(m_doc, m_iter + 1);
+    }
+    default: {
+        return unexpected(error_code::TAPE_ERROR);
+    }
+    }
+}
+
+inline result<array> value::get_array() const noexcept {
+    const auto &cur = __cursor();
+    if (WJR_UNLIKELY(cur.get(m_iter) != '[')) {
+        return unexpected(error_code::INCORRECT_TYPE);
+    }
+
+    if (WJR_UNLIKELY(m_iter + 1 == cur.last)) {
+        return unexpected(error_code::INCOMPLETE_ARRAY_OR_OBJECT);
+    }
+
+    const uint8_t ch = cur.get(m_iter + 1);
+    if (ch == ']') {
+        return array(m_doc, nullptr);
+    }
+
+    if (WJR_UNLIKELY(array::__is_close(ch))) {
+        return unexpected(error_code::TAPE_ERROR);
+    }
+
+    return array(m_doc, m_iter + 1);
+}
+
+inline result<std::string_view> value::raw_json() const noexcept {
+    const auto &cur = __cursor();
+    const token_pointer next = cur.skip(m_iter);
+    if (WJR_UNLIKELY(next == nullptr)) {
+        return unexpected(error_code::INCOMPLETE_ARRAY_OR_OBJECT);
+    }
+
+    const char *const first = cur.begin_of(m_iter);
+    const char *last;
+
+    switch (cur.get(m_iter)) {
+    case '"':
+    case '{':
+    case '[': {
+        last = cur.begin_of(next - 1) + 1;
+        break;
+    }
+    default: {
+        last = cur.end_of(m_iter);
+        while (last != first && charconv_detail::isspace(last[-1])) {
+            --last;
+        }
+        break;
+    }
+    }
+
+    return std::string_view(first, static_cast<size_t>(last - first));
+}
+
+inline result<value> value::operator[](std::string_view key) const noexcept {
+    WJR_EXPECTED_INIT(obj, get_object());
+    return obj->find_field_unordered(key);
+}
+
+inline result<object::token_pointer> object::__next(const document *doc,
+                                                    token_pointer iter) noexcept {
+    const auto &cur = __cursor(doc);
+    const token_pointer next = cur.skip(iter + 3);
+
+    if (WJR_UNLIKELY(next == nullptr || next == cur.last)) {
+        return unexpected(error_code::INCOMPLETE_ARRAY_OR_OBJECT);
+    }
+
+    // a well-formed field is followed by ',' and the next key, or by '}'
+    switch (cur.get(next)) {
+    case ',': {
+        if (WJR_UNLIKELY(cur.last - next < 5)) {
+            return unexpected(error_code::INCOMPLETE_ARRAY_OR_OBJECT);
+        }
+
+        if (WJR_UNLIKELY(cur.get(next + 1) != '"' || cur.get(next + 3) != ':')) {
+            return unexpected(error_code::TAPE_ERROR);
+        }
+
+        return next + 1;
+    }
+    case '}': {
+        return nullptr;
+    }
+    default: {
+        return unexpected(error_code::TAPE_ERROR);
+    }
+    }
+}
+
+inline result<size_t> object::count_fields() const noexcept {
+    size_t count = 0;
+    for (auto iter = m_first; iter != nullptr; ++count) {
+        WJR_EXPECTED_INIT(next, __next(m_doc, iter));
+        iter = *next;
+    }
+
+    return count;
+}
+
+inline result<value> object::__find(token_pointer &iter, token_pointer last,
+                                    std::string_view key) noexcept {
+    while (iter != last) {
+        const token_pointer current = iter;
+        WJR_EXPECTED_INIT(next, __next(m_doc, iter));
+        iter = *next;
+
+        if (__key(m_doc, current) == key) {
+            return value(m_doc, current + 3);
+        }
+    }
+
+    return unexpected(error_code::NO_SUCH_FIELD);
+}
+
+inline result<value> object::find_field(std::string_view key) noexcept {
+    return __find(m_iter, nullptr, key);
+}
+
+inline result<value> object::find_field_unordered(std::string_view key) noexcept {
+    const token_pointer start = m_iter;
+    if (auto ret = __find(m_iter, nullptr, key); ret || ret.error() != error_code::NO_SUCH_FIELD) {
+        return ret;
+    }
+
+    m_iter = m_first;
+    return __find(m_iter, start, key);
+}
+
+inline result<array::token_pointer> array::__next(const document *doc,
+                                                  token_pointer iter) noexcept {
+    const auto &cur = __cursor(doc);
+    const token_pointer next = cur.skip(iter);
+
+    if (WJR_UNLIKELY(next == nullptr || next == cur.last)) {
+        return unexpected(error_code::INCOMPLETE_ARRAY_OR_OBJECT);
+    }
+
+    // a well-formed element is followed by ',' and the next value, or by ']'
+    switch (cur.get(next)) {
+    case ',': {
+        if (WJR_UNLIKELY(next + 1 == cur.last)) {
+            return unexpected(error_code::INCOMPLETE_ARRAY_OR_OBJECT);
+        }
+
+        if (WJR_UNLIKELY(__is_close(cur.get(next + 1)))) {
+            return unexpected(error_code::TAPE_ERROR);
+        }
+
+        return next + 1;
+    }
+    case ']': {
+        return nullptr;
+    }
+    default: {
+        return unexpected(error_code::TAPE_ERROR);
+    }
+    }
+}
+
+inline result<size_t> array::count_elements() const noexcept {
+    size_t count = 0;
+    for (auto iter = m_first; iter != nullptr; ++count) {
+        WJR_EXPECTED_INIT(next, __next(m_doc, iter));
+        iter = *next;
+    }
+
+    return count;
+}
+
+inline result<value> array::at(size_t index) const noexcept {
+    auto iter = m_first;
+    for (; iter != nullptr && index != 0; --index) {
+        WJR_EXPECTED_INIT(next, __next(m_doc, iter));
+        iter = *next;
+    }
+
+    if (WJR_UNLIKELY(iter == nullptr)) {
+        return unexpected(error_code::INDEX_OUT_OF_BOUNDS);
+    }
+
+    return value(m_doc, iter);
+}
+
+inline result<std::string_view> document::__decode_string(const char *first,
+                                                          const char *last) noexcept {
+    const size_t length = static_cast<size_t>(last - first);
+
+    if (m_rest < length) {
+        // blocks grow geometrically from 4 KiB, a longer string gets a block of its own size
+        const size_t capacity = std::max(m_block_size, length);
+        m_block_size *= 2;
+        m_blocks.emplace_back(new char[capacity]);
+        m_buffer = m_blocks.back().get();
+        m_rest = capacity;
+    }
+
+    WJR_EXPECTED_INIT(ret, json::detail::parse_string(m_buffer, first, last));
+    const size_t size = static_cast<size_t>(*ret - m_buffer);
+    std::string_view str(m_buffer, size);
+    m_buffer += size;
+    m_rest -= size;
+    return str;
+}
+
+} // namespace wjr::json::ondemand
+
+#endif // WJR_JSON_ONDEMAND_HPP__
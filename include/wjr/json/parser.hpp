@@ -0,0 +1,84 @@
+/**
+ * @file parser.hpp
+ * @author wjr
+ * @brief Parse many documents one after another without allocating.
+ *
+ * @details json::parser keeps a reader and an arena_document between calls.
+ * The token buffer and the arena only grow to the largest document seen so
+ * far, so parsing a stream of similar documents stops allocating after the
+ * first few.
+ *
+ * @version 0.1
+ * @date 2025-01-20
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_PARSER_HPP__
+#define WJR_JSON_PARSER_HPP__
+
+#include <wjr/json/arena_document.hpp>
+
+namespace wjr::json {
+
+/**
+ * @brief A reusable parser owning its reader and document arena.
+ *
+ * @details The document returned by parse() is valid until the next call of
+ * parse(), shrink_to_fit() or the destruction of the parser:
+ * @code
+ * json::parser par;
+ * for (auto &str : inputs) {
+ *     if (auto doc = par.parse(str)) {
+ *         use(**doc);
+ *     }
+ * }
+ * @endcode
+ * Like arena_document, values must not be copied out of the document into
+ * containers that outlive it, convert them with to_string() or
+ * json::deserialize instead.
+ *
+ */
+class parser {
+public:
+    using document_type = arena_document::document_type;
+
+    parser() = default;
+    explicit parser(size_t block_size) noexcept : m_doc(block_size) {}
+
+    parser(const parser &) = delete;
+    parser &operator=(const parser &) = delete;
+    parser(parser &&) = default;
+    parser &operator=(parser &&) = default;
+    ~parser() = default;
+
+    /// @brief Parse sp into the recycled document, sp must outlive the result.
+    WJR_NODISCARD result<const document_type *> parse(span<const char> sp) noexcept {
+        m_reader.read(sp);
+        WJR_EXPECTED_TRY(m_doc.read(m_reader));
+        return std::addressof(m_doc.root());
+    }
+
+    /// @brief The document of the latest parse(), null if it failed.
+    const document_type &root() const noexcept { return m_doc.root(); }
+
+    const reader &get_reader() const noexcept { return m_reader; }
+    const arena &get_arena() const noexcept { return m_doc.get_arena(); }
+
+    /// @brief Give back the memory kept for the largest document.
+    void shrink_to_fit() noexcept {
+        m_doc.reset();
+        m_doc.get_arena().release();
+        m_reader.clear();
+        m_reader.shrink_to_fit();
+    }
+
+private:
+    reader m_reader;
+    arena_document m_doc;
+};
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_PARSER_HPP__
@@ -0,0 +1,397 @@
+/**
+ * @file patch.hpp
+ * @author wjr
+ * @brief Apply JSON Merge Patch (RFC 7386) and JSON Patch (RFC 6902) in place.
+ *
+ * @details Both walk the patch and only the paths of the document it names:
+ * fields are found with the lookup of the object type, values are moved out of
+ * the patch, and the rest of the document is left untouched. The cost depends
+ * on the size of the patch and the depth of its paths, not on the size of the
+ * document.
+ *
+ * @version 0.1
+ * @date 2025-01-28
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_PATCH_HPP__
+#define WJR_JSON_PATCH_HPP__
+
+#include <algorithm>
+#include <string>
+
+#include <wjr/json/document.hpp>
+
+namespace wjr::json {
+
+namespace patch_detail {
+
+WJR_REGISTER_HAS_TYPE(object_find,
+                      std::declval<Object &>().find(
+                          std::declval<const typename Object::key_type &>()),
+                      Object);
+
+/// @brief Find a field with the lookup of the object, btree_map has lower_bound only.
+template <typename Object>
+auto find_field(Object &obj, const typename std::remove_const_t<Object>::key_type &key) {
+    if constexpr (has_object_find_v<std::remove_const_t<Object>>) {
+        return obj.find(key);
+    } else {
+        auto iter = obj.lower_bound(key);
+        if (iter != obj.end() && obj.key_comp()(key, iter->first)) {
+            iter = obj.end();
+        }
+
+        return iter;
+    }
+}
+
+/// @brief Decode the reference tokens of a JSON Pointer (RFC 6901).
+inline result<void> parse_pointer(std::string_view str, vector<std::string> &tokens) noexcept {
+    tokens.clear();
+
+    if (str.empty()) {
+        return {};
+    }
+
+    if (WJR_UNLIKELY(str.front() != '/')) {
+        return unexpected(error_code::INVALID_JSON_POINTER);
+    }
+
+    size_t pos = 1;
+
+    while (true) {
+        const size_t end = std::min(str.find('/', pos), str.size());
+        std::string &token = tokens.emplace_back();
+
+        for (size_t i = pos; i < end; ++i) {
+            if (str[i] != '~') {
+                token.push_back(str[i]);
+                continue;
+            }
+
+            if (WJR_UNLIKELY(i + 1 == end || (str[i + 1] != '0' && str[i + 1] != '1'))) {
+                return unexpected(error_code::INVALID_JSON_POINTER);
+            }
+
+            token.push_back(str[++i] == '0' ? '~' : '/');
+        }
+
+        if (end == str.size()) {
+            break;
+        }
+
+        pos = end + 1;
+    }
+
+    return {};
+}
+
+/**
+ * @brief Index of an element of an array of size elements.
+ *
+ * @details When inserting, "-" and size name the end of the array.
+ */
+inline result<size_t> parse_index(const std::string &token, size_t size, bool insert) noexcept {
+    if (insert && token == "-") {
+        return size;
+    }
+
+    if (WJR_UNLIKELY(token.empty() || token.size() > 9 || (token[0] == '0' && token.size() != 1) ||
+                     !std::all_of(token.begin(), token.end(),
+                                  [](char ch) { return ch >= '0' && ch <= '9'; }))) {
+        return unexpected(error_code::INVALID_JSON_POINTER);
+    }
+
+    size_t idx = 0;
+    for (const char ch : token) {
+        idx = idx * 10 + static_cast<size_t>(ch - '0');
+    }
+
+    if (WJR_UNLIKELY(idx > size || (idx == size && !insert))) {
+        return unexpected(error_code::INDEX_OUT_OF_BOUNDS);
+    }
+
+    return idx;
+}
+
+/**
+ * @brief The value at the path [first, last) of doc.
+ *
+ * @details Document may be const, a non-const document clones the shared nodes
+ * of the path, see shared_document.
+ */
+template <typename Document>
+result<Document *> resolve(Document &doc, const std::string *first,
+                           const std::string *last) noexcept {
+    using string_type = typename std::remove_const_t<Document>::string_type;
+
+    Document *current = std::addressof(doc);
+
+    for (; first != last; ++first) {
+        switch (current->type()) {
+        case value_t::object: {
+            auto &obj = current->template get_unsafe<object_t>();
+            const auto iter = find_field(obj, string_type(first->data(), first->size()));
+            if (WJR_UNLIKELY(iter == obj.end())) {
+                return unexpected(error_code::NO_SUCH_FIELD);
+            }
+
+            current = std::addressof(iter->second);
+            break;
+        }
+        case value_t::array: {
+            auto &arr = current->template get_unsafe<array_t>();
+            WJR_EXPECTED_INIT(idx, parse_index(*first, arr.size(), false));
+            current = std::addressof(arr[*idx]);
+            break;
+        }
+        default: {
+            return unexpected(error_code::NO_SUCH_FIELD);
+        }
+        }
+    }
+
+    return current;
+}
+
+template <typename Document>
+result<void> add_value(Document &doc, const vector<std::string> &path, Document &&value) {
+    if (path.empty()) {
+        doc = std::move(value);
+        return {};
+    }
+
+    WJR_EXPECTED_INIT(parent, resolve(doc, path.data(), path.data() + path.size() - 1));
+    const std::string &last = path.back();
+
+    switch ((*parent)->type()) {
+    case value_t::object: {
+        auto &obj = (*parent)->template get_unsafe<object_t>();
+        obj.try_emplace(typename Document::string_type(last.data(), last.size())).first->second =
+            std::move(value);
+        return {};
+    }
+    case value_t::array: {
+        auto &arr = (*parent)->template get_unsafe<array_t>();
+        WJR_EXPECTED_INIT(idx, parse_index(last, arr.size(), true));
+        arr.insert(arr.begin() + *idx, std::move(value));
+        return {};
+    }
+    default: {
+        return unexpected(error_code::NO_SUCH_FIELD);
+    }
+    }
+}
+
+/// @brief Remove the value at path and return it, removing the root leaves null.
+template <typename Document>
+result<Document> remove_value(Document &doc, const vector<std::string> &path) {
+    if (path.empty()) {
+        return Document(std::move(doc));
+    }
+
+    WJR_EXPECTED_INIT(parent, resolve(doc, path.data(), path.data() + path.size() - 1));
+    const std::string &last = path.back();
+
+    switch ((*parent)->type()) {
+    case value_t::object: {
+        auto &obj = (*parent)->template get_unsafe<object_t>();
+        const auto iter =
+            find_field(obj, typename Document::string_type(last.data(), last.size()));
+        if (WJR_UNLIKELY(iter == obj.end())) {
+            return unexpected(error_code::NO_SUCH_FIELD);
+        }
+
+        Document value(std::move(iter->second));
+        obj.erase(iter);
+        return value;
+    }
+    case value_t::array: {
+        auto &arr = (*parent)->template get_unsafe<array_t>();
+        WJR_EXPECTED_INIT(idx, parse_index(last, arr.size(), false));
+        Document value(std::move(arr[*idx]));
+        arr.erase(arr.begin() + *idx);
+        return value;
+    }
+    default: {
+        return unexpected(error_code::NO_SUCH_FIELD);
+    }
+    }
+}
+
+/// @brief A member of an operation, nullptr if it's missing.
+template <typename Document>
+Document *member(Document &op, const char *name) {
+    auto &obj = op.template get_unsafe<object_t>();
+    const auto iter = find_field(obj, typename Document::string_type(name));
+    return iter == obj.end() ? nullptr : std::addressof(iter->second);
+}
+
+/// @brief Decode the pointer of a string member.
+template <typename Document>
+result<void> member_pointer(Document &op, const char *name, vector<std::string> &tokens) {
+    const Document *const ptr = member(op, name);
+    if (WJR_UNLIKELY(ptr == nullptr || !ptr->is_string())) {
+        return unexpected(error_code::INVALID_PATCH);
+    }
+
+    const auto &str = ptr->template get_unsafe<string_t>();
+    return parse_pointer(std::string_view(str.data(), str.size()), tokens);
+}
+
+template <typename Document>
+result<void> apply_operation(Document &doc, Document &op, vector<std::string> &path,
+                             vector<std::string> &from) {
+    if (WJR_UNLIKELY(!op.is_object())) {
+        return unexpected(error_code::INVALID_PATCH);
+    }
+
+    const Document *const name_ptr = member(op, "op");
+    if (WJR_UNLIKELY(name_ptr == nullptr || !name_ptr->is_string())) {
+        return unexpected(error_code::INVALID_PATCH);
+    }
+
+    const auto &name_str = name_ptr->template get_unsafe<string_t>();
+    const std::string_view name(name_str.data(), name_str.size());
+    WJR_EXPECTED_TRY(member_pointer(op, "path", path));
+
+    if (name == "remove") {
+        WJR_EXPECTED_TRY(remove_value(doc, path));
+        return {};
+    }
+
+    if (name == "move" || name == "copy") {
+        WJR_EXPECTED_TRY(member_pointer(op, "from", from));
+
+        if (name == "copy") {
+            const Document &cdoc = doc;
+            WJR_EXPECTED_INIT(source, resolve(cdoc, from.data(), from.data() + from.size()));
+            return add_value(doc, path, Document(**source));
+        }
+
+        if (from.size() <= path.size() && std::equal(from.begin(), from.end(), path.begin())) {
+            // a value can't be moved into one of its children
+            if (WJR_UNLIKELY(from.size() != path.size())) {
+                return unexpected(error_code::INVALID_PATCH);
+            }
+
+            return {};
+        }
+
+        WJR_EXPECTED_INIT(value, remove_value(doc, from));
+        return add_value(doc, path, *std::move(value));
+    }
+
+    Document *const value = member(op, "value");
+    if (WJR_UNLIKELY(value == nullptr)) {
+        return unexpected(error_code::INVALID_PATCH);
+    }
+
+    if (name == "add") {
+        return add_value(doc, path, std::move(*value));
+    }
+
+    if (name == "replace") {
+        WJR_EXPECTED_INIT(target, resolve(doc, path.data(), path.data() + path.size()));
+        **target = std::move(*value);
+        return {};
+    }
+
+    if (name == "test") {
+        const Document &cdoc = doc;
+        WJR_EXPECTED_INIT(target, resolve(cdoc, path.data(), path.data() + path.size()));
+        if (WJR_UNLIKELY(**target != *value)) {
+            return unexpected(error_code::PATCH_TEST_FAILED);
+        }
+
+        return {};
+    }
+
+    return unexpected(error_code::INVALID_PATCH);
+}
+
+} // namespace patch_detail
+
+/**
+ * @brief Apply a JSON Merge Patch (RFC 7386) to doc.
+ *
+ * @details Fields of an object patch are merged into doc, a null field removes
+ * the field of doc. Any other patch replaces doc. Values are moved out of patch.
+ */
+template <typename Traits>
+void apply_merge_patch(basic_document<Traits> &doc, basic_document<Traits> &&patch) {
+    if (!patch.is_object()) {
+        doc = std::move(patch);
+        return;
+    }
+
+    if (!doc.is_object()) {
+        doc.emplace_object();
+    }
+
+    auto &obj = doc.template get_unsafe<object_t>();
+
+    for (auto &[key, value] : patch.template get_unsafe<object_t>()) {
+        const auto iter = patch_detail::find_field(obj, key);
+
+        if (value.is_null()) {
+            if (iter != obj.end()) {
+                obj.erase(iter);
+            }
+
+            continue;
+        }
+
+        if (iter != obj.end()) {
+            apply_merge_patch(iter->second, std::move(value));
+        } else if (value.is_object()) {
+            // nulls of a new object are removed too
+            apply_merge_patch(obj.try_emplace(key).first->second, std::move(value));
+        } else {
+            obj.try_emplace(key).first->second = std::move(value);
+        }
+    }
+}
+
+template <typename Traits>
+void apply_merge_patch(basic_document<Traits> &doc, const basic_document<Traits> &patch) {
+    apply_merge_patch(doc, basic_document<Traits>(patch));
+}
+
+/**
+ * @brief Apply a JSON Patch (RFC 6902) to doc.
+ *
+ * @details The operations are applied in order: add, remove, replace, move,
+ * copy and test. Values of add and replace are moved out of patch.
+ * @return INVALID_PATCH if patch or an operation is malformed,
+ * PATCH_TEST_FAILED if a test fails, and NO_SUCH_FIELD, INDEX_OUT_OF_BOUNDS or
+ * INVALID_JSON_POINTER if a path doesn't name a value of doc. The operations
+ * before the failed one stay applied. To apply all or nothing, patch a copy
+ * and swap it in on success, which is cheap for a shared_document.
+ */
+template <typename Traits>
+result<void> apply_patch(basic_document<Traits> &doc, basic_document<Traits> &&patch) {
+    if (WJR_UNLIKELY(!patch.is_array())) {
+        return unexpected(error_code::INVALID_PATCH);
+    }
+
+    vector<std::string> path, from;
+
+    for (auto &op : patch.template get_unsafe<array_t>()) {
+        WJR_EXPECTED_TRY(patch_detail::apply_operation(doc, op, path, from));
+    }
+
+    return {};
+}
+
+template <typename Traits>
+result<void> apply_patch(basic_document<Traits> &doc, const basic_document<Traits> &patch) {
+    return apply_patch(doc, basic_document<Traits>(patch));
+}
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_PATCH_HPP__
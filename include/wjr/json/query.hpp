@@ -0,0 +1,358 @@
+/**
+ * @file query.hpp
+ * @author wjr
+ * @brief JSON Pointer and simple JSONPath queries over on-demand documents.
+ *
+ * @details A query is compiled once and then matched against any number of
+ * ondemand::document. Matching only walks the tokens of the reader: fields and
+ * elements that don't match are skipped by bracket depth, and nothing is
+ * allocated. Results are ondemand::value, so strings and numbers are decoded
+ * only when they are asked for.
+ *
+ * @version 0.1
+ * @date 2025-01-14
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_QUERY_HPP__
+#define WJR_JSON_QUERY_HPP__
+
+#include <algorithm>
+#include <string>
+
+#include <wjr/json/ondemand.hpp>
+
+namespace wjr::json {
+
+/**
+ * @brief A compiled path.
+ *
+ * @details Two syntaxes are supported:
+ * - JSON Pointer (RFC 6901), such as `/user/id` or `/statuses/0/text`. Every
+ *   segment is a key or an index, a segment `*` is the field named `*`.
+ * - A subset of JSONPath: `$`, `.name`, `['name']`, `["name"]`, `[0]`, `.*` and
+ *   `[*]`, such as `$.entities.hashtags[*].text`. Only JSONPath has wildcards.
+ *
+ * Keys are compared with the raw keys of the input, escape sequences in the input
+ * are not decoded.
+ *
+ */
+class query {
+    struct step {
+        static constexpr uint8_t has_key = 1;
+        static constexpr uint8_t has_index = 2;
+        static constexpr uint8_t wildcard = 4;
+
+        std::string key;
+        uint32_t index = 0;
+        uint8_t kind = 0;
+    };
+
+public:
+    /// @brief The empty query matches the root.
+    query() = default;
+    query(const query &) = default;
+    query(query &&) = default;
+    query &operator=(const query &) = default;
+    query &operator=(query &&) = default;
+    ~query() = default;
+
+    /// @brief Compile a JSON Pointer, the empty string is the root.
+    WJR_NODISCARD static result<query> pointer(std::string_view str) noexcept;
+
+    /// @brief Compile a JSONPath, it must start with `$`.
+    WJR_NODISCARD static result<query> path(std::string_view str) noexcept;
+
+    /// @brief Number of steps from the root.
+    size_t size() const noexcept { return m_steps.size(); }
+
+    /// @brief Return true if the query may match more than one value.
+    bool has_wildcard() const noexcept {
+        return std::any_of(m_steps.begin(), m_steps.end(),
+                           [](const step &s) { return (s.kind & step::wildcard) != 0; });
+    }
+
+    /**
+     * @brief Return the first match in document order.
+     *
+     * @return NO_SUCH_FIELD if nothing matches.
+     */
+    result<ondemand::value> find(ondemand::document &doc) const noexcept {
+        ondemand::value ret;
+        bool found = false;
+
+        WJR_EXPECTED_TRY(for_each(doc, [&ret, &found](ondemand::value val) {
+            ret = val;
+            found = true;
+            return false;
+        }));
+
+        if (!found) {
+            return unexpected(error_code::NO_SUCH_FIELD);
+        }
+
+        return ret;
+    }
+
+    /**
+     * @brief Call func(ondemand::value) for every match in document order.
+     *
+     * @details If func returns bool, returning false stops the search. A subtree
+     * whose type doesn't fit the path is not a match. A malformed or truncated
+     * object or array on the way to a match is reported as an error, see
+     * ondemand::object.
+     */
+    template <typename Func>
+    result<void> for_each(ondemand::document &doc, Func &&func) const noexcept {
+        WJR_EXPECTED_INIT(root, doc.root());
+        WJR_EXPECTED_TRY(__match(*root, 0, func));
+        return {};
+    }
+
+private:
+    /// @return false if the search should stop.
+    template <typename Func>
+    result<bool> __match(ondemand::value val, size_t idx, Func &func) const noexcept;
+
+    vector<step> m_steps;
+};
+
+inline result<query> query::pointer(std::string_view str) noexcept {
+    query ret;
+
+    if (str.empty()) {
+        return ret;
+    }
+
+    if (WJR_UNLIKELY(str.front() != '/')) {
+        return unexpected(error_code::INVALID_JSON_POINTER);
+    }
+
+    size_t pos = 1;
+
+    while (true) {
+        const size_t end = std::min(str.find('/', pos), str.size());
+        const std::string_view seg = str.substr(pos, end - pos);
+        step s;
+        s.key.reserve(seg.size());
+
+        for (size_t i = 0; i < seg.size(); ++i) {
+            if (seg[i] != '~') {
+                s.key.push_back(seg[i]);
+                continue;
+            }
+
+            if (WJR_UNLIKELY(i + 1 == seg.size() || (seg[i + 1] != '0' && seg[i + 1] != '1'))) {
+                return unexpected(error_code::INVALID_JSON_POINTER);
+            }
+
+            s.key.push_back(seg[++i] == '0' ? '~' : '/');
+        }
+
+        s.kind = step::has_key;
+
+        // "0" or digits without a leading zero may also index an array
+        if (!seg.empty() && seg.size() <= 9 && (seg[0] != '0' || seg.size() == 1) &&
+            std::all_of(seg.begin(), seg.end(), [](char ch) { return ch >= '0' && ch <= '9'; })) {
+            for (const char ch : seg) {
+                s.index = s.index * 10 + static_cast<uint32_t>(ch - '0');
+            }
+
+            s.kind |= step::has_index;
+        }
+
+        ret.m_steps.emplace_back(std::move(s));
+
+        if (end == str.size()) {
+            break;
+        }
+
+        pos = end + 1;
+    }
+
+    return ret;
+}
+
+inline result<query> query::path(std::string_view str) noexcept {
+    query ret;
+
+    if (WJR_UNLIKELY(str.empty() || str.front() != '$')) {
+        return unexpected(error_code::INVALID_JSON_POINTER);
+    }
+
+    size_t pos = 1;
+
+    while (pos != str.size()) {
+        step s;
+
+        if (str[pos] == '.') {
+            ++pos;
+
+            if (pos != str.size() && str[pos] == '*') {
+                s.kind = step::wildcard;
+                ++pos;
+            } else {
+                const size_t end = std::min(str.find_first_of(".[", pos), str.size());
+                if (WJR_UNLIKELY(end == pos)) {
+                    return unexpected(error_code::INVALID_JSON_POINTER);
+                }
+
+                s.key.assign(str.data() + pos, end - pos);
+                s.kind = step::has_key;
+                pos = end;
+            }
+        } else if (str[pos] == '[') {
+            ++pos;
+
+            if (WJR_UNLIKELY(pos == str.size())) {
+                return unexpected(error_code::INVALID_JSON_POINTER);
+            }
+
+            const char ch = str[pos];
+
+            if (ch == '*') {
+                s.kind = step::wildcard;
+                ++pos;
+            } else if (ch == '\'' || ch == '"') {
+                ++pos;
+
+                while (true) {
+                    if (WJR_UNLIKELY(pos == str.size())) {
+                        return unexpected(error_code::INVALID_JSON_POINTER);
+                    }
+
+                    if (str[pos] == ch) {
+                        ++pos;
+                        break;
+                    }
+
+                    if (str[pos] == '\\' && pos + 1 != str.size()) {
+                        ++pos;
+                    }
+
+                    s.key.push_back(str[pos++]);
+                }
+
+                s.kind = step::has_key;
+            } else {
+                const size_t first = pos;
+
+                while (pos != str.size() && str[pos] >= '0' && str[pos] <= '9') {
+                    s.index = s.index * 10 + static_cast<uint32_t>(str[pos++] - '0');
+                }
+
+                if (WJR_UNLIKELY(pos == first || pos - first > 9)) {
+                    return unexpected(error_code::INVALID_JSON_POINTER);
+                }
+
+                s.kind = step::has_index;
+            }
+
+            if (WJR_UNLIKELY(pos == str.size() || str[pos] != ']')) {
+                return unexpected(error_code::INVALID_JSON_POINTER);
+            }
+
+            ++pos;
+        } else {
+            return unexpected(error_code::INVALID_JSON_POINTER);
+        }
+
+        ret.m_steps.emplace_back(std::move(s));
+    }
+
+    return ret;
+}
+
+template <typename Func>
+result<bool> query::__match(ondemand::value val, size_t idx, Func &func) const noexcept {
+    if (idx == m_steps.size()) {
+        if constexpr (std::is_same_v<std::invoke_result_t<Func &, ondemand::value>, bool>) {
+            return func(val);
+        } else {
+            func(val);
+            return true;
+        }
+    }
+
+    const step &s = m_steps[idx];
+
+    switch (val.type()) {
+    case ondemand::json_type::object: {
+        if (!(s.kind & (step::has_key | step::wildcard))) {
+            return true;
+        }
+
+        WJR_EXPECTED_INIT(obj, val.get_object());
+
+        if (s.kind & step::wildcard) {
+            auto iter = obj->begin();
+            for (; iter != obj->end(); ++iter) {
+                WJR_EXPECTED_INIT(ret, __match(iter->value(), idx + 1, func));
+                if (!*ret) {
+                    return false;
+                }
+            }
+
+            if (WJR_UNLIKELY(iter.error() != error_code::SUCCESS)) {
+                return unexpected(iter.error());
+            }
+
+            return true;
+        }
+
+        auto ret = obj->find_field(s.key);
+        if (!ret) {
+            if (ret.error() == error_code::NO_SUCH_FIELD) {
+                return true;
+            }
+
+            return unexpected(std::move(ret).error());
+        }
+
+        return __match(*ret, idx + 1, func);
+    }
+    case ondemand::json_type::array: {
+        if (!(s.kind & (step::has_index | step::wildcard))) {
+            return true;
+        }
+
+        WJR_EXPECTED_INIT(arr, val.get_array());
+
+        if (s.kind & step::wildcard) {
+            auto iter = arr->begin();
+            for (; iter != arr->end(); ++iter) {
+                WJR_EXPECTED_INIT(ret, __match(*iter, idx + 1, func));
+                if (!*ret) {
+                    return false;
+                }
+            }
+
+            if (WJR_UNLIKELY(iter.error() != error_code::SUCCESS)) {
+                return unexpected(iter.error());
+            }
+
+            return true;
+        }
+
+        auto ret = arr->at(s.index);
+        if (!ret) {
+            if (ret.error() == error_code::INDEX_OUT_OF_BOUNDS) {
+                return true;
+            }
+
+            return unexpected(std::move(ret).error());
+        }
+
+        return __match(*ret, idx + 1, func);
+    }
+    default: {
+        return true;
+    }
+    }
+}
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_QUERY_HPP__
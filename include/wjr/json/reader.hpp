@@ -1,7 +1,11 @@
 #ifndef WJR_JSON_READER_HPP__
 #define WJR_JSON_READER_HPP__
 
+#include <memory>
+
+#include <wjr/json/chunk_lexer.hpp>
 #include <wjr/json/lexer.hpp>
+#include <wjr/json/mapped_file.hpp>
 #include <wjr/vector.hpp>
 
 namespace wjr::json {
@@ -30,11 +34,76 @@ public:
     WJR_CONSTEXPR20 size_type size() const noexcept { return static_cast<size_type>(m_str.size()); }
 
     void read(span<const char> sp) noexcept {
+        m_file.reset();
+        __read(sp);
+    }
+
+    /**
+     * @brief Take the tokens of a finished chunk_lexer instead of lexing sp.
+     *
+     * @details sp must be the chunks fed to lex, in one piece.
+     */
+    void read(span<const char> sp, chunk_lexer &&lex) noexcept {
+        WJR_ASSERT(lex.is_finished() && sp.size() == lex.size(),
+                   "sp must be the input of a finished chunk_lexer");
+
+        m_file.reset();
+        m_str = sp;
+        m_tokens = std::move(lex.m_tokens);
+        m_valid_utf8 = lex.is_valid_utf8();
+        lex.reset();
+    }
+
+    /**
+     * @brief Map the file at path with mapped_file and read it.
+     *
+     * @details The reader keeps the file mapped until the next read, copies of
+     * the reader share the mapping. \n
+     * Tokens are 32-bit positions, so a file larger than 4 GiB fails with
+     * CAPACITY and leaves the reader unchanged, read it with stream_reader.
+     */
+    result<void> read_file(const char *path) noexcept {
+        WJR_EXPECTED_INIT(file, mapped_file::open(path, UINT32_MAX));
+        m_file = std::make_shared<const mapped_file>(std::move(*file));
+        __read(*m_file);
+        return {};
+    }
+
+    /**
+     * @brief Read tokens on several threads.
+     *
+     * @details The input is split into parts of at least 256 KiB, which are lexed
+     * at the same time for both string states at their beginning. A prefix pass
+     * over the string state at the end of each part selects the right tokens,
+     * which are then concatenated. The tokens are the same as read(sp). \n
+     * If threads is 0, std::thread::hardware_concurrency() is used.
+     *
+     */
+    void read_parallel(span<const char> sp, unsigned int threads = 0) noexcept;
+
+    /**
+     * @brief Whether the input is valid UTF-8.
+     *
+     * @details The lexer validates the input while it reads the tokens, parsing
+     * a reader of invalid input fails with UTF8_ERROR.
+     */
+    bool is_valid_utf8() const noexcept { return m_valid_utf8; }
+
+    void clear() noexcept { m_tokens.clear(); }
+    void shrink_to_fit() noexcept { m_tokens.shrink_to_fit(); }
+
+private:
+    void __read(span<const char> sp) noexcept {
         m_str = sp;
 
         lexer lex(m_str);
         const size_type n = static_cast<size_type>(m_str.size());
         size_type capacity = n <= 2048 ? n : (n <= 16 * 2048 ? 2048 : n / 16);
+        // A reused reader lexes into all the room it already has.
+        if (m_tokens.capacity() > capacity + 64) {
+            capacity = static_cast<size_type>(m_tokens.capacity() - 64);
+        }
+
         size_type buf_size = capacity;
         typename lexer::result_type result;
         m_tokens.clear();
@@ -46,14 +115,15 @@ public:
             buf_size = capacity;
             capacity <<= 1;
         } while (!result.done());
-    }
 
-    void clear() noexcept { m_tokens.clear(); }
-    void shrink_to_fit() noexcept { m_tokens.shrink_to_fit(); }
+        m_valid_utf8 = lex.is_valid_utf8();
+    }
 
-private:
     span<const char> m_str;
     Vector m_tokens;
+    bool m_valid_utf8 = true;
+    // set by read_file
+    std::shared_ptr<const mapped_file> m_file;
 };
 
 } // namespace wjr::json
@@ -0,0 +1,373 @@
+/**
+ * @file sax.hpp
+ * @author wjr
+ * @brief Parse JSON into callbacks of a handler, without building a document.
+ *
+ * @details sax_parse runs the same stage 2 as document::parse, but every value
+ * is passed to a handler instead of being stored. Dispatch is resolved at
+ * compile time, callbacks the handler doesn't have cost nothing, so aggregations
+ * such as counting or summing fields run at the speed of the token walk and never
+ * allocate.
+ *
+ * @version 0.1
+ * @date 2025-01-22
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_SAX_HPP__
+#define WJR_JSON_SAX_HPP__
+
+#include <wjr/json/visitor.hpp>
+
+namespace wjr::json {
+
+namespace sax_detail {
+
+WJR_REGISTER_HAS_TYPE(sax_visit_start_object, std::declval<Handler &>().visit_start_object(),
+                      Handler);
+WJR_REGISTER_HAS_TYPE(sax_visit_end_object, std::declval<Handler &>().visit_end_object(),
+                      Handler);
+WJR_REGISTER_HAS_TYPE(sax_visit_start_array, std::declval<Handler &>().visit_start_array(),
+                      Handler);
+WJR_REGISTER_HAS_TYPE(sax_visit_end_array, std::declval<Handler &>().visit_end_array(),
+                      Handler);
+WJR_REGISTER_HAS_TYPE(sax_visit_key,
+                      std::declval<Handler &>().visit_key(std::declval<std::string_view>()),
+                      Handler);
+WJR_REGISTER_HAS_TYPE(sax_visit_string,
+                      std::declval<Handler &>().visit_string(std::declval<std::string_view>()),
+                      Handler);
+WJR_REGISTER_HAS_TYPE(sax_visit_number,
+                      std::declval<Handler &>().visit_number(std::declval<std::string_view>()),
+                      Handler);
+WJR_REGISTER_HAS_TYPE(sax_visit_null, std::declval<Handler &>().visit_null(), Handler);
+WJR_REGISTER_HAS_TYPE(sax_visit_bool, std::declval<Handler &>().visit_bool(true), Handler);
+
+/// @brief Call func, a callback returning void never fails.
+template <typename Func>
+WJR_INTRINSIC_INLINE result<void> invoke(Func &&func) noexcept {
+    if constexpr (std::is_void_v<std::invoke_result_t<Func &&>>) {
+        std::forward<Func>(func)();
+        return {};
+    } else {
+        return std::forward<Func>(func)();
+    }
+}
+
+WJR_PURE WJR_INTRINSIC_INLINE std::string_view make_number(const char *first,
+                                                           const char *last) noexcept {
+    // The number token ends at the next token, after any whitespace.
+    while (charconv_detail::isspace(last[-1])) {
+        --last;
+    }
+
+    return std::string_view(first, static_cast<size_t>(last - first));
+}
+
+/**
+ * @brief Adapt a handler to the parser interface of visitor_detail::parse_impl.
+ *
+ * @details The position in the tree (root, object or array) is dropped, a
+ * handler that needs it keeps its own stack.
+ */
+template <typename Handler>
+class sax_parser {
+public:
+    explicit sax_parser(Handler &handler) noexcept : m_handler(handler) {}
+
+    template <typename Token>
+    WJR_INTRINSIC_INLINE result<void> visit_root_start_object(Token) noexcept {
+        return start_object();
+    }
+
+    template <typename Token>
+    WJR_INTRINSIC_INLINE result<void> visit_object_start_object(Token) noexcept {
+        return start_object();
+    }
+
+    template <typename Token>
+    WJR_INTRINSIC_INLINE result<void> visit_array_start_object(Token) noexcept {
+        return start_object();
+    }
+
+    template <typename Token>
+    WJR_INTRINSIC_INLINE result<void> visit_root_start_array(Token) noexcept {
+        return start_array();
+    }
+
+    template <typename Token>
+    WJR_INTRINSIC_INLINE result<void> visit_object_start_array(Token) noexcept {
+        return start_array();
+    }
+
+    template <typename Token>
+    WJR_INTRINSIC_INLINE result<void> visit_array_start_array(Token) noexcept {
+        return start_array();
+    }
+
+    template <typename Token>
+    WJR_INTRINSIC_INLINE result<void> visit_end_object_to_root(Token) noexcept {
+        return end_object();
+    }
+
+    template <typename Token>
+    WJR_INTRINSIC_INLINE result<void> visit_end_object_to_object(Token) noexcept {
+        return end_object();
+    }
+
+    template <typename Token>
+    WJR_INTRINSIC_INLINE result<void> visit_end_object_to_array(Token) noexcept {
+        return end_object();
+    }
+
+    template <typename Token>
+    WJR_INTRINSIC_INLINE result<void> visit_end_array_to_root(Token) noexcept {
+        return end_array();
+    }
+
+    template <typename Token>
+    WJR_INTRINSIC_INLINE result<void> visit_end_array_to_object(Token) noexcept {
+        return end_array();
+    }
+
+    template <typename Token>
+    WJR_INTRINSIC_INLINE result<void> visit_end_array_to_array(Token) noexcept {
+        return end_array();
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_object_key_string(const char *first,
+                                                              const char *last) noexcept {
+        WJR_EXPECTED_TRY(detail::check_string(first, last));
+
+        if constexpr (has_sax_visit_key_v<Handler>) {
+            const std::string_view raw(first, static_cast<size_t>(last - first));
+            return invoke([this, raw] { return m_handler.visit_key(raw); });
+        } else {
+            return {};
+        }
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_root_string(const char *first,
+                                                        const char *last) noexcept {
+        return string(first, last);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_object_string(const char *first,
+                                                          const char *last) noexcept {
+        return string(first, last);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_array_string(const char *first,
+                                                         const char *last) noexcept {
+        return string(first, last);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_root_number(const char *first,
+                                                        const char *last) noexcept {
+        return number(first, last);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_object_number(const char *first,
+                                                          const char *last) noexcept {
+        return number(first, last);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_array_number(const char *first,
+                                                         const char *last) noexcept {
+        return number(first, last);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_root_null(const char *first) noexcept {
+        return null(first);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_object_null(const char *first) noexcept {
+        return null(first);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_array_null(const char *first) noexcept {
+        return null(first);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_root_true(const char *first) noexcept {
+        return boolean<true>(first);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_object_true(const char *first) noexcept {
+        return boolean<true>(first);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_array_true(const char *first) noexcept {
+        return boolean<true>(first);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_root_false(const char *first) noexcept {
+        return boolean<false>(first);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_object_false(const char *first) noexcept {
+        return boolean<false>(first);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_array_false(const char *first) noexcept {
+        return boolean<false>(first);
+    }
+
+private:
+    WJR_INTRINSIC_INLINE result<void> start_object() noexcept {
+        if constexpr (has_sax_visit_start_object_v<Handler>) {
+            return invoke([this] { return m_handler.visit_start_object(); });
+        } else {
+            return {};
+        }
+    }
+
+    WJR_INTRINSIC_INLINE result<void> end_object() noexcept {
+        if constexpr (has_sax_visit_end_object_v<Handler>) {
+            return invoke([this] { return m_handler.visit_end_object(); });
+        } else {
+            return {};
+        }
+    }
+
+    WJR_INTRINSIC_INLINE result<void> start_array() noexcept {
+        if constexpr (has_sax_visit_start_array_v<Handler>) {
+            return invoke([this] { return m_handler.visit_start_array(); });
+        } else {
+            return {};
+        }
+    }
+
+    WJR_INTRINSIC_INLINE result<void> end_array() noexcept {
+        if constexpr (has_sax_visit_end_array_v<Handler>) {
+            return invoke([this] { return m_handler.visit_end_array(); });
+        } else {
+            return {};
+        }
+    }
+
+    WJR_INTRINSIC_INLINE result<void> string(const char *first, const char *last) noexcept {
+        WJR_EXPECTED_TRY(detail::check_string(first, last));
+
+        if constexpr (has_sax_visit_string_v<Handler>) {
+            const std::string_view raw(first, static_cast<size_t>(last - first));
+            return invoke([this, raw] { return m_handler.visit_string(raw); });
+        } else {
+            return {};
+        }
+    }
+
+    WJR_INTRINSIC_INLINE result<void> number(const char *first, const char *last) noexcept {
+        const std::string_view raw = make_number(first, last);
+        WJR_EXPECTED_TRY(detail::check_number_syntax(raw.data(), raw.data() + raw.size()));
+
+        if constexpr (has_sax_visit_number_v<Handler>) {
+            return invoke([this, raw] { return m_handler.visit_number(raw); });
+        } else {
+            return {};
+        }
+    }
+
+    WJR_INTRINSIC_INLINE result<void> null(const char *first) noexcept {
+        WJR_EXPECTED_TRY(detail::check_null(first));
+
+        if constexpr (has_sax_visit_null_v<Handler>) {
+            return invoke([this] { return m_handler.visit_null(); });
+        } else {
+            return {};
+        }
+    }
+
+    template <bool Value>
+    WJR_INTRINSIC_INLINE result<void> boolean(const char *first) noexcept {
+        if constexpr (Value) {
+            WJR_EXPECTED_TRY(detail::check_true(first));
+        } else {
+            WJR_EXPECTED_TRY(detail::check_false(first));
+        }
+
+        if constexpr (has_sax_visit_bool_v<Handler>) {
+            return invoke([this] { return m_handler.visit_bool(Value); });
+        } else {
+            return {};
+        }
+    }
+
+    Handler &m_handler;
+};
+
+} // namespace sax_detail
+
+/**
+ * @brief Parse the tokens of rd into the callbacks of handler.
+ *
+ * @details A handler may have any of these callbacks, each returning void or
+ * result<void>. An error returned by a callback stops the parse and is returned.
+ * - visit_start_object(), visit_end_object()
+ * - visit_start_array(), visit_end_array()
+ * - visit_key(std::string_view raw) : a key, followed by its value.
+ * - visit_string(std::string_view raw)
+ * - visit_number(std::string_view raw)
+ * - visit_null(), visit_bool(bool)
+ *
+ * Keys and strings are the raw bytes between the quotes, escapes are checked but
+ * not decoded, see sax_decode_string. Numbers are the raw token, its grammar is
+ * checked but it isn't converted, see sax_decode_number. Both point into the
+ * input of rd. Every value is checked before its callback, also when the handler
+ * has no callback for it, so sax_parse fails on the same input as check(), except
+ * that a number out of the range of double is only reported by sax_decode_number. \n
+ * For example, summing the numbers of all "count" fields:
+ * @code
+ * struct count_sum {
+ *     bool is_count = false;
+ *     uint64_t sum = 0;
+ *
+ *     void visit_key(std::string_view key) { is_count = key == "count"; }
+ *     result<void> visit_number(std::string_view raw) {
+ *         if (is_count) {
+ *             WJR_EXPECTED_INIT(value, sax_decode_number(raw));
+ *             sum += value->m_number_unsigned;
+ *         }
+ *         return {};
+ *     }
+ * };
+ *
+ * count_sum handler;
+ * auto ret = json::sax_parse(json::reader(str), handler);
+ * @endcode
+ *
+ */
+template <typename Handler>
+WJR_NODISCARD result<void> sax_parse(const reader &rd, Handler &handler) noexcept {
+    return visitor_detail::parse(sax_detail::sax_parser<Handler>(handler), rd);
+}
+
+/// @brief Parse the tokens of a stream_reader, which is consumed.
+template <typename Handler>
+WJR_NODISCARD result<void> sax_parse(stream_reader &rd, Handler &handler) noexcept {
+    return visitor_detail::parse(sax_detail::sax_parser<Handler>(handler), rd);
+}
+
+/// @brief Decode the raw number of visit_number.
+WJR_PURE inline result<basic_value> sax_decode_number(std::string_view raw) noexcept {
+    basic_value value(default_construct);
+    WJR_EXPECTED_TRY(detail::parse_number(raw.data(), raw.data() + raw.size(), value));
+    return value;
+}
+
+/**
+ * @brief Decode the escapes of a raw key or string into dst.
+ *
+ * @details dst must have room for raw.size() bytes.
+ *
+ * @return The end of the decoded string.
+ */
+inline result<char *> sax_decode_string(char *dst, std::string_view raw) noexcept {
+    return detail::parse_string(dst, raw.data(), raw.data() + raw.size());
+}
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_SAX_HPP__
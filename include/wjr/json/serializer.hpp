@@ -0,0 +1,318 @@
+/**
+ * @file serializer.hpp
+ * @author wjr
+ * @brief Write C++ objects directly as JSON text.
+ *
+ * @details json::serialize walks the fields of a registered object and emits
+ * text through the formatter_detail helpers, no basic_document is built. The
+ * `{"name":` and `,"name":` fragments in front of every field are escaped at
+ * compile time, so each key costs a single copy. \n
+ * Objects registered with WJR_REGISTER_DOCUMENT_OBJECT_SERIALIZER (or
+ * WJR_REGISTER_FROM_READER_OBJECT_SERIALIZER) are supported, as well as
+ * bool, integers, floating points, std::basic_string, std::string_view,
+ * std::optional, std::vector, wjr::vector and basic_document. Other types can
+ * specialize json::serializer. \n
+ * The output is minified, and fields are written in the order they are
+ * registered.
+ *
+ * @version 0.1
+ * @date 2025-01-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_SERIALIZER_HPP__
+#define WJR_JSON_SERIALIZER_HPP__
+
+#include <array>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include <wjr/json/document.hpp>
+
+namespace wjr::json {
+
+/**
+ * @brief Write a value of type T as JSON text.
+ *
+ * @details A specialization provides
+ * `template <typename Container> static void write(Container &cont, const T &val)`,
+ * which appends to cont. Container is any container of char supported by
+ * try_uninitialized_append.
+ */
+template <typename T, typename Enable = void>
+struct serializer {};
+
+WJR_REGISTER_HAS_TYPE(
+    serializer, serializer<T>::write(std::declval<std::string &>(), std::declval<const T &>()), T);
+
+namespace serializer_detail {
+
+/// @brief Append at most n characters with a writer returning the new end.
+template <typename Container, typename Func>
+WJR_INTRINSIC_INLINE void append_with(Container &cont, size_t n, Func func) {
+    const auto old_size = cont.size();
+    try_uninitialized_append(cont, n);
+    auto *const ptr = cont.data() + old_size;
+    try_uninitialized_resize(cont, func(ptr) - cont.data());
+}
+
+/// @brief Length of str after escaping, computed at compile time for keys.
+constexpr size_t escaped_length(std::string_view str) noexcept {
+    size_t ret = 0;
+
+    for (const char ch : str) {
+        if (!formatter_detail::needs_escaping[uint8_t(ch)]) {
+            ret += 1;
+        } else if (ch == '\"' || ch == '\\' || ch == '\b' || ch == '\t' || ch == '\n' ||
+                   ch == '\f' || ch == '\r') {
+            ret += 2;
+        } else {
+            ret += 6;
+        }
+    }
+
+    return ret;
+}
+
+constexpr char *escape_to(char *ptr, std::string_view str) noexcept {
+    constexpr char hex[] = "0123456789abcdef";
+
+    for (const char ch : str) {
+        if (!formatter_detail::needs_escaping[uint8_t(ch)]) {
+            *ptr++ = ch;
+            continue;
+        }
+
+        *ptr++ = '\\';
+
+        switch (ch) {
+        case '\"':
+        case '\\': {
+            *ptr++ = ch;
+            break;
+        }
+        case '\b': {
+            *ptr++ = 'b';
+            break;
+        }
+        case '\t': {
+            *ptr++ = 't';
+            break;
+        }
+        case '\n': {
+            *ptr++ = 'n';
+            break;
+        }
+        case '\f': {
+            *ptr++ = 'f';
+            break;
+        }
+        case '\r': {
+            *ptr++ = 'r';
+            break;
+        }
+        default: {
+            *ptr++ = 'u';
+            *ptr++ = '0';
+            *ptr++ = '0';
+            *ptr++ = hex[uint8_t(ch) >> 4];
+            *ptr++ = hex[uint8_t(ch) & 15];
+            break;
+        }
+        }
+    }
+
+    return ptr;
+}
+
+/**
+ * @brief `{"name":` for the first field of T and `,"name":` for the others.
+ */
+template <typename T, size_t I>
+struct key_fragment {
+    static constexpr std::string_view name = std::get<I>(T::__wjr_reader_fields()).first;
+    static constexpr size_t size = escaped_length(name) + 4;
+
+    static constexpr std::array<char, size> __make() noexcept {
+        std::array<char, size> ret{};
+        char *ptr = ret.data();
+        *ptr++ = I == 0 ? '{' : ',';
+        *ptr++ = '\"';
+        ptr = escape_to(ptr, name);
+        *ptr++ = '\"';
+        *ptr++ = ':';
+        return ret;
+    }
+
+    static constexpr std::array<char, size> value = __make();
+};
+
+template <typename Container, typename T, size_t... Is>
+WJR_INTRINSIC_INLINE void write_fields(Container &cont, const T &val, std::index_sequence<Is...>) {
+    constexpr auto fields = T::__wjr_reader_fields();
+
+    (void)((formatter_detail::append_string(cont, key_fragment<T, Is>::value.data(),
+                                            key_fragment<T, Is>::size),
+            serializer<remove_cvref_t<decltype(val.*(std::get<Is>(fields).second))>>::write(
+                cont, val.*(std::get<Is>(fields).second))),
+           ...);
+}
+
+template <typename Container, typename Array>
+void write_array(Container &cont, const Array &arr) {
+    using value_type = typename Array::value_type;
+
+    auto begin = arr.begin();
+    const auto end = arr.end();
+
+    if (begin == end) {
+        formatter_detail::append_string(cont, "[]", 2);
+        return;
+    }
+
+    cont.push_back('[');
+    serializer<value_type>::write(cont, *begin);
+
+    while (++begin != end) {
+        cont.push_back(',');
+        serializer<value_type>::write(cont, *begin);
+    }
+
+    cont.push_back(']');
+}
+
+} // namespace serializer_detail
+
+template <>
+struct serializer<bool> {
+    template <typename Container>
+    static void write(Container &cont, bool val) {
+        if (val) {
+            formatter_detail::append_string(cont, "true", 4);
+        } else {
+            formatter_detail::append_string(cont, "false", 5);
+        }
+    }
+};
+
+template <typename T>
+struct serializer<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+    template <typename Container>
+    static void write(Container &cont, T val) {
+        // sign and 19 digits of int64_t, or 20 digits of uint64_t
+        serializer_detail::append_with(cont, 20, [val](char *ptr) {
+            if constexpr (std::is_signed_v<T>) {
+                return to_chars_unchecked(ptr, static_cast<int64_t>(val));
+            } else {
+                return to_chars_unchecked(ptr, static_cast<uint64_t>(val));
+            }
+        });
+    }
+};
+
+template <typename T>
+struct serializer<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+    template <typename Container>
+    static void write(Container &cont, T val) {
+        serializer_detail::append_with(
+            cont, dragonbox::max_output_string_length_of<double>,
+            [val](char *ptr) { return dragonbox::to_chars(static_cast<double>(val), ptr); });
+    }
+};
+
+template <typename Traits, typename Alloc>
+struct serializer<std::basic_string<char, Traits, Alloc>> {
+    template <typename Container>
+    static void write(Container &cont, const std::basic_string<char, Traits, Alloc> &val) {
+        formatter_detail::format_string(cont, std::string_view(val.data(), val.size()));
+    }
+};
+
+template <>
+struct serializer<std::string_view> {
+    template <typename Container>
+    static void write(Container &cont, std::string_view val) {
+        formatter_detail::format_string(cont, val);
+    }
+};
+
+template <typename T>
+struct serializer<std::optional<T>, std::enable_if_t<has_serializer_v<T>>> {
+    template <typename Container>
+    static void write(Container &cont, const std::optional<T> &val) {
+        if (!val.has_value()) {
+            formatter_detail::append_string(cont, "null", 4);
+            return;
+        }
+
+        serializer<T>::write(cont, *val);
+    }
+};
+
+template <typename T, typename Alloc>
+struct serializer<std::vector<T, Alloc>, std::enable_if_t<has_serializer_v<T>>> {
+    template <typename Container>
+    static void write(Container &cont, const std::vector<T, Alloc> &val) {
+        serializer_detail::write_array(cont, val);
+    }
+};
+
+template <typename Storage>
+struct serializer<basic_vector<Storage>,
+                  std::enable_if_t<has_serializer_v<typename Storage::value_type>>> {
+    template <typename Container>
+    static void write(Container &cont, const basic_vector<Storage> &val) {
+        serializer_detail::write_array(cont, val);
+    }
+};
+
+template <typename Traits>
+struct serializer<basic_document<Traits>> {
+    template <typename Container>
+    static void write(Container &cont, const basic_document<Traits> &val) {
+        val.dump_impl(cont);
+    }
+};
+
+/**
+ * @brief Objects registered with WJR_REGISTER_FROM_READER_OBJECT_SERIALIZER.
+ *
+ * @details Field names are written as they are spelled in the registration.
+ */
+template <typename T>
+struct serializer<T, std::enable_if_t<has_reader_fields_v<T>>> {
+    template <typename Container>
+    static void write(Container &cont, const T &val) {
+        constexpr size_t size = std::tuple_size_v<decltype(T::__wjr_reader_fields())>;
+
+        if constexpr (size == 0) {
+            formatter_detail::append_string(cont, "{}", 2);
+        } else {
+            serializer_detail::write_fields(cont, val, std::make_index_sequence<size>());
+            cont.push_back('}');
+        }
+    }
+};
+
+/**
+ * @brief Append the minified JSON text of val to cont.
+ */
+template <typename T, typename Container, WJR_REQUIRES(has_serializer_v<T>)>
+void serialize(const T &val, Container &cont) {
+    static_assert(std::is_same_v<typename Container::value_type, char>);
+    serializer<T>::write(cont, val);
+}
+
+template <typename String = std::string, typename T, WJR_REQUIRES(has_serializer_v<T>)>
+String serialize(const T &val) {
+    String str;
+    serialize(val, str);
+    return str;
+}
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_SERIALIZER_HPP__
@@ -0,0 +1,68 @@
+/**
+ * @file shared_document.hpp
+ * @author wjr
+ * @brief JSON document whose copies share objects and arrays.
+ *
+ * @details Objects and arrays of a shared_document are reference counted.
+ * Copying a document only increments the count of its root, and a node is
+ * cloned when it's written while other documents still refer to it. Cloning an
+ * object or an array shares its children, so writing a value clones the
+ * containers on its path and nothing else.
+ *
+ * @version 0.1
+ * @date 2025-01-27
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_SHARED_DOCUMENT_HPP__
+#define WJR_JSON_SHARED_DOCUMENT_HPP__
+
+#include <wjr/json/document.hpp>
+
+namespace wjr::json {
+
+namespace detail {
+
+using shared_document_traits =
+    basic_document_traits<std::basic_string, btree_map, vector, memory_pool, true>;
+
+} // namespace detail
+
+/**
+ * @brief A document that is cheap to copy and then modify a little.
+ *
+ * @details
+ * @code
+ * const auto base = *json::shared_document::parse(rd);
+ * // for each request
+ * json::shared_document config = base;
+ * config["limits"]["timeout"] = 30;
+ * @endcode
+ * Only the root and "limits" of config are cloned, base is not modified. \n
+ * Any non-const access to an object or an array clones it if it's shared, so
+ * read through a const document to avoid needless clones. A reference taken
+ * by non-const access must not be used to write after the document is copied,
+ * it would write into the node shared with the copy. \n
+ * Documents may be copied, read and destroyed from different threads while
+ * they share nodes, each document itself is not thread safe.
+ *
+ */
+using shared_document = basic_document<detail::shared_document_traits>;
+
+namespace visitor_detail {
+
+extern template result<void>
+parse<detail::basic_document_parser<shared_document> &>(
+    detail::basic_document_parser<shared_document> &par, const reader &rd) noexcept;
+
+extern template result<void>
+parse<detail::basic_document_parser<shared_document> &>(
+    detail::basic_document_parser<shared_document> &par, stream_reader &rd) noexcept;
+
+} // namespace visitor_detail
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_SHARED_DOCUMENT_HPP__
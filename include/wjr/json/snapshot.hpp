@@ -0,0 +1,129 @@
+/**
+ * @file snapshot.hpp
+ * @author wjr
+ * @brief Binary images of tape documents that are read in place.
+ *
+ * @details A tape already refers to its values by index and to its strings by
+ * offset, so it is position independent. A snapshot is a header followed by the
+ * tape and the string buffer:
+ * - magic "WJRTAPE\0", version and a byte order tag.
+ * - number of tape words and size of the string buffer.
+ * - a checksum of the tape and the string buffer.
+ *
+ * The string buffer is padded with zeros to a multiple of 8 bytes. Loading a
+ * snapshot validates the header and maps the file, values are then read in
+ * place, without lexing, decoding or allocating per value.
+ *
+ * @version 0.1
+ * @date 2025-01-23
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_SNAPSHOT_HPP__
+#define WJR_JSON_SNAPSHOT_HPP__
+
+#include <memory>
+
+#include <wjr/json/mapped_file.hpp>
+#include <wjr/json/tape_document.hpp>
+
+namespace wjr::json {
+
+namespace snapshot_detail {
+
+inline constexpr char magic[8] = {'W', 'J', 'R', 'T', 'A', 'P', 'E', '\0'};
+inline constexpr uint32_t byte_order = 0x01020304;
+
+struct header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t tape_size;
+    uint64_t strings_size;
+    uint64_t checksum;
+};
+
+static_assert(sizeof(header) % sizeof(uint64_t) == 0, "The tape must stay aligned.");
+
+} // namespace snapshot_detail
+
+/**
+ * @brief A tape document read in place from a snapshot.
+ *
+ * @details Save a parsed document once, then load it at every start:
+ * @code
+ * auto doc = *json::tape_document::parse(json::reader(str));
+ * json::tape_snapshot::save(doc, "config.snapshot");
+ * // later
+ * auto snap = json::tape_snapshot::open("config.snapshot");
+ * if (snap) {
+ *     use(snap->root());
+ * }
+ * @endcode
+ * Copies of a tape_snapshot share the mapped file. A snapshot is trusted data,
+ * the checksum finds damaged files but the tape itself isn't validated.
+ *
+ */
+class tape_snapshot {
+public:
+    static constexpr uint32_t version = 1;
+
+    tape_snapshot() = default;
+    tape_snapshot(const tape_snapshot &) = default;
+    tape_snapshot(tape_snapshot &&) = default;
+    tape_snapshot &operator=(const tape_snapshot &) = default;
+    tape_snapshot &operator=(tape_snapshot &&) = default;
+    ~tape_snapshot() = default;
+
+    /**
+     * @brief Serialize a document into a snapshot image.
+     *
+     * @details Numbers of a lazy document are decoded, so the image doesn't
+     * refer to the input. Return EMPTY for a document that was never parsed,
+     * or the error of a malformed lazy number.
+     */
+    WJR_NODISCARD static result<vector<char>> write(const tape_document &doc) noexcept;
+
+    /// @brief Write the snapshot of doc to the file at path.
+    WJR_NODISCARD static result<void> save(const tape_document &doc, const char *path) noexcept;
+
+    /**
+     * @brief Read an image in place.
+     *
+     * @details image must be 8-byte aligned and outlive the snapshot. Return
+     * SNAPSHOT_ERROR if the header, the size or, when verify is true, the
+     * checksum is wrong.
+     */
+    WJR_NODISCARD static result<tape_snapshot> view(span<const char> image,
+                                                    bool verify = true) noexcept;
+
+    /// @brief Map the snapshot file at path with mapped_file and read it in place.
+    WJR_NODISCARD static result<tape_snapshot> open(const char *path,
+                                                    bool verify = true) noexcept;
+
+    tape_value root() const noexcept { return tape_value(m_tape, m_strings, 0); }
+
+    span<const uint64_t> tape() const noexcept { return span<const uint64_t>(m_tape, m_tape_size); }
+    span<const char> strings() const noexcept {
+        return span<const char>(m_strings, m_strings_size);
+    }
+
+private:
+    tape_snapshot(const uint64_t *tape, size_t tape_size, const char *strings,
+                  size_t strings_size) noexcept
+        : m_tape(tape), m_tape_size(tape_size), m_strings(strings), m_strings_size(strings_size) {
+    }
+
+    const uint64_t *m_tape = nullptr;
+    size_t m_tape_size = 0;
+    const char *m_strings = nullptr;
+    size_t m_strings_size = 0;
+    // set by open
+    std::shared_ptr<const mapped_file> m_file;
+};
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_SNAPSHOT_HPP__
@@ -0,0 +1,159 @@
+/**
+ * @file stream_reader.hpp
+ * @author wjr
+ * @brief Read tokens of inputs larger than 4 GiB with bounded memory.
+ * @version 0.1
+ * @date 2025-01-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_STREAM_READER_HPP__
+#define WJR_JSON_STREAM_READER_HPP__
+
+#include <wjr/json/lexer.hpp>
+#include <wjr/math/literals.hpp>
+#include <wjr/vector.hpp>
+
+namespace wjr::json {
+
+/**
+ * @brief Lex a large input window by window.
+ *
+ * @details The input is split into windows whose size is a multiple of 64 bytes.
+ * The lexer produces 32-bit tokens relative to the current window, and a 64-bit
+ * window base turns them into positions of the whole input. Tokens are lexed in
+ * batches of at most buffer_size (+ 64) tokens when stage 2 asks for them, so
+ * memory doesn't depend on the size of the input. \n
+ * The whole input must stay addressable (for example mapped by mmap) while
+ * parsing, because strings and numbers are read from it.
+ *
+ * A stream_reader is consumed by parsing, call reset() to parse it again.
+ *
+ */
+class stream_reader {
+    using Vector = vector<uint32_t>;
+
+public:
+    using value_type = uint64_t;
+    using const_pointer = const char *;
+    using size_type = uint64_t;
+
+    static constexpr size_t default_window_size = 64_MB;
+    static constexpr size_t max_window_size = 1_GB;
+    static constexpr uint32_t default_buffer_size = 16_KB;
+
+    stream_reader() = delete;
+    stream_reader(const stream_reader &) = delete;
+    stream_reader(stream_reader &&) = default;
+    stream_reader &operator=(const stream_reader &) = delete;
+    stream_reader &operator=(stream_reader &&) = default;
+    ~stream_reader() = default;
+
+    stream_reader(span<const char> sp, size_t window_size = default_window_size,
+                  uint32_t buffer_size = default_buffer_size) noexcept
+        : m_lexer(span<const char>()) {
+        read(sp, window_size, buffer_size);
+    }
+
+    void read(span<const char> sp, size_t window_size = default_window_size,
+              uint32_t buffer_size = default_buffer_size) noexcept {
+        WJR_ASSERT(window_size != 0 && window_size % 64 == 0 && window_size <= max_window_size,
+                   "window size must be a multiple of 64 and no more than 1 GiB");
+        WJR_ASSERT(buffer_size != 0);
+
+        m_str = sp;
+        m_window_size = window_size;
+        m_buffer_size = buffer_size;
+        m_tokens.clear();
+        m_tokens.reserve(buffer_size + 64);
+        reset();
+    }
+
+    /// @brief Restart from the beginning of the input.
+    void reset() noexcept {
+        const size_t n = std::min<size_t>(m_window_size, m_str.size());
+        m_lexer = lexer(span<const char>(m_str.data(), n));
+        m_base = m_window_base = 0;
+        m_next_window = n;
+        m_first = m_last = m_tokens.data();
+        m_done = n == 0;
+    }
+
+    WJR_PURE const_pointer data() const noexcept { return m_str.data(); }
+    WJR_PURE size_type size() const noexcept { return m_str.size(); }
+
+    /// @brief Base position of the tokens in the buffer.
+    WJR_PURE size_type base() const noexcept { return m_base; }
+
+    size_t window_size() const noexcept { return m_window_size; }
+
+    /**
+     * @brief Whether the bytes lexed so far are valid UTF-8.
+     *
+     * @details The end of the input is only checked once it is lexed.
+     */
+    bool is_valid_utf8() const noexcept { return m_lexer.is_valid_utf8(); }
+
+    WJR_INTRINSIC_INLINE bool next(value_type &token) noexcept {
+        if (WJR_UNLIKELY(m_first == m_last)) {
+            if (WJR_UNLIKELY(!__refill())) {
+                return false;
+            }
+        }
+
+        token = m_base + *m_first++;
+        return true;
+    }
+
+private:
+    WJR_NOINLINE bool __refill() noexcept {
+        while (!m_done) {
+            uint32_t *const buf = m_tokens.data();
+            const auto result = m_lexer.read(buf, m_buffer_size);
+
+            m_base = m_window_base;
+            m_first = buf;
+            m_last = buf + result.get();
+
+            if (result.done()) {
+                __next_window();
+            }
+
+            if (m_first != m_last) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void __next_window() noexcept {
+        if (m_next_window == m_str.size()) {
+            m_done = true;
+            return;
+        }
+
+        const size_t n = std::min<size_t>(m_window_size, m_str.size() - m_next_window);
+        m_lexer.rebind(span<const char>(m_str.data() + m_next_window, n));
+        m_window_base = m_next_window;
+        m_next_window += n;
+    }
+
+    span<const char> m_str;
+    size_t m_window_size;
+    uint32_t m_buffer_size;
+    lexer m_lexer;
+    Vector m_tokens;
+    const uint32_t *m_first;
+    const uint32_t *m_last;
+    size_type m_base;
+    size_type m_window_base;
+    size_type m_next_window;
+    bool m_done;
+};
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_STREAM_READER_HPP__
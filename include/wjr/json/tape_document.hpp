@@ -0,0 +1,868 @@
+/**
+ * @file tape_document.hpp
+ * @author wjr
+ * @brief Immutable JSON document stored as a flat tape.
+ *
+ * @details Every value is one 64-bit word on the tape, numbers take one more
+ * word for their bits. The top 8 bits of a word are its type, the low 56 bits
+ * are its payload:
+ * - '{' / '[' : index after the matching close word (low 32 bits) and the
+ * number of fields or elements (bits 32 ~ 55, saturated).
+ * - '}' / ']' : index of the matching open word.
+ * - '"' : offset into the string buffer, which stores a 32-bit length, the
+ * decoded bytes and a terminating zero.
+ * - 'u' / 'l' / 'd' : followed by the bits of a uint64_t / int64_t / double.
+ * - 'r' : a number that isn't decoded yet, see lazy_numbers. Its type (bits
+ * 32 ~ 39) and length (low 32 bits), followed by a pointer to its characters.
+ * - 't' / 'f' / 'n' : no payload.
+ *
+ * Object fields are stored as a key word followed by the value. Skipping a
+ * container is O(1) by jumping to the stored end index.
+ *
+ * @version 0.1
+ * @date 2025-01-08
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_TAPE_DOCUMENT_HPP__
+#define WJR_JSON_TAPE_DOCUMENT_HPP__
+
+#include <wjr/json/visitor.hpp>
+
+namespace wjr::json {
+
+class tape_value;
+class tape_object;
+class tape_array;
+class tape_document;
+class tape_snapshot;
+
+namespace tape_detail {
+
+enum tape_type : uint8_t {
+    start_object = '{',
+    end_object = '}',
+    start_array = '[',
+    end_array = ']',
+    string = '"',
+    number_unsigned = 'u',
+    number_signed = 'l',
+    number_float = 'd',
+    number_raw = 'r',
+    true_value = 't',
+    false_value = 'f',
+    null_value = 'n',
+};
+
+inline constexpr uint64_t payload_mask = (static_cast<uint64_t>(1) << 56) - 1;
+inline constexpr uint32_t count_mask = (static_cast<uint32_t>(1) << 24) - 1;
+
+WJR_CONST WJR_INTRINSIC_CONSTEXPR uint64_t make_word(uint8_t type, uint64_t payload) noexcept {
+    return static_cast<uint64_t>(type) << 56 | payload;
+}
+
+WJR_CONST WJR_INTRINSIC_CONSTEXPR uint8_t get_type(uint64_t word) noexcept {
+    return static_cast<uint8_t>(word >> 56);
+}
+
+WJR_CONST WJR_INTRINSIC_CONSTEXPR uint64_t get_payload(uint64_t word) noexcept {
+    return word & payload_mask;
+}
+
+/// @brief Index after the value at @a index.
+WJR_PURE WJR_INTRINSIC_INLINE uint32_t next_index(const uint64_t *tape, uint32_t index) noexcept {
+    const uint64_t word = tape[index];
+    switch (get_type(word)) {
+    case start_object:
+    case start_array: {
+        return static_cast<uint32_t>(word);
+    }
+    case number_unsigned:
+    case number_signed:
+    case number_float:
+    case number_raw: {
+        return index + 2;
+    }
+    default: {
+        return index + 1;
+    }
+    }
+}
+
+/**
+ * @brief The type a number decodes to, from its characters only.
+ *
+ * @details Exact for valid numbers. Integers out of the range of 64 bits are
+ * decoded as doubles.
+ */
+WJR_PURE inline value_t guess_number_type(const char *first, const char *last) noexcept {
+    for (const char *ptr = first; ptr != last; ++ptr) {
+        if (*ptr == '.' || *ptr == 'e' || *ptr == 'E') {
+            return value_t::number_float;
+        }
+    }
+
+    const bool negative = *first == '-';
+    const std::string_view digits(first + negative, static_cast<size_t>(last - first - negative));
+    const std::string_view max = negative ? "9223372036854775808" : "18446744073709551615";
+    if (digits.size() > max.size() || (digits.size() == max.size() && digits > max)) {
+        return value_t::number_float;
+    }
+
+    return negative ? value_t::number_signed : value_t::number_unsigned;
+}
+
+struct tape_ref {
+    const uint64_t *tape;
+    const char *strings;
+};
+
+} // namespace tape_detail
+
+/// @brief Parse numbers of a tape_document only when they are read.
+struct lazy_numbers_t {};
+inline constexpr lazy_numbers_t lazy_numbers{};
+
+/**
+ * @brief A value on a tape.
+ *
+ * @details It's only a view, valid as long as the tape it points to.
+ */
+class tape_value {
+    friend class tape_object;
+    friend class tape_array;
+    friend class tape_document;
+    friend class tape_snapshot;
+
+public:
+    tape_value() = default;
+    tape_value(const tape_value &) = default;
+    tape_value &operator=(const tape_value &) = default;
+    ~tape_value() = default;
+
+    tape_value(const uint64_t *tape, const char *strings, uint32_t index) noexcept
+        : m_ref{tape, strings}, m_index(index) {}
+
+    value_t type() const noexcept {
+        switch (__get_type()) {
+        case tape_detail::start_object:
+            return value_t::object;
+        case tape_detail::start_array:
+            return value_t::array;
+        case tape_detail::string:
+            return value_t::string;
+        case tape_detail::number_unsigned:
+            return value_t::number_unsigned;
+        case tape_detail::number_signed:
+            return value_t::number_signed;
+        case tape_detail::number_float:
+            return value_t::number_float;
+        case tape_detail::number_raw:
+            return static_cast<value_t>(__get_word() >> 32);
+        case tape_detail::true_value:
+        case tape_detail::false_value:
+            return value_t::boolean;
+        default:
+            return value_t::null;
+        }
+    }
+
+    bool is_null() const noexcept { return __get_type() == tape_detail::null_value; }
+    bool is_boolean() const noexcept {
+        return __get_type() == tape_detail::true_value || __get_type() == tape_detail::false_value;
+    }
+    bool is_number() const noexcept {
+        const auto type = __get_type();
+        return type == tape_detail::number_unsigned || type == tape_detail::number_signed ||
+               type == tape_detail::number_float || type == tape_detail::number_raw;
+    }
+    bool is_string() const noexcept { return __get_type() == tape_detail::string; }
+    bool is_object() const noexcept { return __get_type() == tape_detail::start_object; }
+    bool is_array() const noexcept { return __get_type() == tape_detail::start_array; }
+
+    result<bool> get_bool() const noexcept {
+        switch (__get_type()) {
+        case tape_detail::true_value:
+            return true;
+        case tape_detail::false_value:
+            return false;
+        default:
+            return unexpected(error_code::INCORRECT_TYPE);
+        }
+    }
+
+    result<uint64_t> get_uint64() const noexcept {
+        uint64_t bits;
+        WJR_EXPECTED_INIT(type, __get_number(bits));
+
+        switch (*type) {
+        case tape_detail::number_unsigned: {
+            return bits;
+        }
+        case tape_detail::number_signed: {
+            return unexpected(error_code::NUMBER_OUT_OF_RANGE);
+        }
+        default: {
+            return unexpected(error_code::INCORRECT_TYPE);
+        }
+        }
+    }
+
+    result<int64_t> get_int64() const noexcept {
+        uint64_t bits;
+        WJR_EXPECTED_INIT(type, __get_number(bits));
+
+        switch (*type) {
+        case tape_detail::number_unsigned: {
+            const uint64_t value = bits;
+            if (WJR_UNLIKELY(value > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))) {
+                return unexpected(error_code::NUMBER_OUT_OF_RANGE);
+            }
+
+            return static_cast<int64_t>(value);
+        }
+        case tape_detail::number_signed: {
+            return static_cast<int64_t>(bits);
+        }
+        default: {
+            return unexpected(error_code::INCORRECT_TYPE);
+        }
+        }
+    }
+
+    result<double> get_double() const noexcept {
+        uint64_t bits;
+        WJR_EXPECTED_INIT(type, __get_number(bits));
+
+        switch (*type) {
+        case tape_detail::number_unsigned: {
+            return static_cast<double>(bits);
+        }
+        case tape_detail::number_signed: {
+            return static_cast<double>(static_cast<int64_t>(bits));
+        }
+        case tape_detail::number_float: {
+            return bit_cast<double>(bits);
+        }
+        default: {
+            return unexpected(error_code::INCORRECT_TYPE);
+        }
+        }
+    }
+
+    result<std::string_view> get_string_view() const noexcept {
+        if (WJR_UNLIKELY(__get_type() != tape_detail::string)) {
+            return unexpected(error_code::INCORRECT_TYPE);
+        }
+
+        return __get_string();
+    }
+
+    result<tape_object> get_object() const noexcept;
+    result<tape_array> get_array() const noexcept;
+
+    /// @brief Same as get_object()->find(key).
+    result<tape_value> operator[](std::string_view key) const noexcept;
+
+    /// @brief Index of the value on the tape.
+    uint32_t index() const noexcept { return m_index; }
+
+    /// @brief Index after the value on the tape.
+    uint32_t next_index() const noexcept { return tape_detail::next_index(m_ref.tape, m_index); }
+
+private:
+    tape_value(tape_detail::tape_ref ref, uint32_t index) noexcept : m_ref(ref), m_index(index) {}
+
+    uint64_t __get_word() const noexcept { return m_ref.tape[m_index]; }
+    uint8_t __get_type() const noexcept { return tape_detail::get_type(__get_word()); }
+    uint64_t __get_next() const noexcept { return m_ref.tape[m_index + 1]; }
+
+    /**
+     * @brief Type of the value and, for a number, its bits.
+     *
+     * @details A raw number is decoded every time, its errors are returned.
+     */
+    result<uint8_t> __get_number(uint64_t &bits) const noexcept {
+        bits = 0;
+        const uint8_t type = __get_type();
+        switch (type) {
+        case tape_detail::number_unsigned:
+        case tape_detail::number_signed:
+        case tape_detail::number_float: {
+            bits = __get_next();
+            return type;
+        }
+        case tape_detail::number_raw: {
+            const auto *const first =
+                reinterpret_cast<const char *>(static_cast<uintptr_t>(__get_next()));
+            const auto length = static_cast<uint32_t>(__get_word());
+            basic_value value(default_construct);
+            WJR_EXPECTED_TRY(detail::parse_number(first, first + length, value));
+
+            bits = value.m_number_unsigned;
+            switch (value.m_type) {
+            case value_t::number_unsigned: {
+                return tape_detail::number_unsigned;
+            }
+            case value_t::number_signed: {
+                return tape_detail::number_signed;
+            }
+            default: {
+                return tape_detail::number_float;
+            }
+            }
+        }
+        default: {
+            return type;
+        }
+        }
+    }
+
+    std::string_view __get_string() const noexcept {
+        const char *const ptr = m_ref.strings + tape_detail::get_payload(__get_word());
+        uint32_t length;
+        std::memcpy(&length, ptr, sizeof(uint32_t));
+        return std::string_view(ptr + sizeof(uint32_t), length);
+    }
+
+    tape_detail::tape_ref m_ref = {nullptr, nullptr};
+    uint32_t m_index = 0;
+};
+
+class tape_object {
+    friend class tape_value;
+
+public:
+    using value_type = std::pair<std::string_view, tape_value>;
+
+    class iterator {
+        friend class tape_object;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = tape_object::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type *;
+        using reference = value_type;
+
+        iterator() = default;
+
+        reference operator*() const noexcept {
+            const tape_value key(m_ref, m_index);
+            return {key.__get_string(), tape_value(m_ref, m_index + 1)};
+        }
+
+        iterator &operator++() noexcept {
+            m_index = tape_detail::next_index(m_ref.tape, m_index + 1);
+            return *this;
+        }
+
+        iterator operator++(int) noexcept {
+            iterator tmp(*this);
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const iterator &other) const noexcept { return m_index == other.m_index; }
+        bool operator!=(const iterator &other) const noexcept { return m_index != other.m_index; }
+
+    private:
+        iterator(tape_detail::tape_ref ref, uint32_t index) noexcept : m_ref(ref), m_index(index) {}
+
+        tape_detail::tape_ref m_ref = {nullptr, nullptr};
+        uint32_t m_index = 0;
+    };
+
+    tape_object() = default;
+
+    iterator begin() const noexcept { return iterator(m_ref, m_index + 1); }
+    iterator end() const noexcept {
+        return iterator(m_ref, static_cast<uint32_t>(m_ref.tape[m_index]) - 1);
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    /// @brief O(1) unless the object has more than 2^24 - 1 fields.
+    size_t size() const noexcept {
+        const uint32_t count =
+            static_cast<uint32_t>(m_ref.tape[m_index] >> 32) & tape_detail::count_mask;
+        if (WJR_LIKELY(count != tape_detail::count_mask)) {
+            return count;
+        }
+
+        return static_cast<size_t>(std::distance(begin(), end()));
+    }
+
+    /// @brief Linear search of the keys. Values of other fields are skipped in O(1).
+    result<tape_value> find(std::string_view key) const noexcept {
+        for (auto iter = begin(), last = end(); iter != last; ++iter) {
+            const tape_value field(m_ref, iter.m_index);
+            if (field.__get_string() == key) {
+                return tape_value(m_ref, iter.m_index + 1);
+            }
+        }
+
+        return unexpected(error_code::NO_SUCH_FIELD);
+    }
+
+    result<tape_value> operator[](std::string_view key) const noexcept { return find(key); }
+
+private:
+    tape_object(tape_detail::tape_ref ref, uint32_t index) noexcept : m_ref(ref), m_index(index) {}
+
+    tape_detail::tape_ref m_ref = {nullptr, nullptr};
+    uint32_t m_index = 0;
+};
+
+class tape_array {
+    friend class tape_value;
+
+public:
+    using value_type = tape_value;
+
+    class iterator {
+        friend class tape_array;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = tape_value;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type *;
+        using reference = value_type;
+
+        iterator() = default;
+
+        reference operator*() const noexcept { return tape_value(m_ref, m_index); }
+
+        iterator &operator++() noexcept {
+            m_index = tape_detail::next_index(m_ref.tape, m_index);
+            return *this;
+        }
+
+        iterator operator++(int) noexcept {
+            iterator tmp(*this);
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const iterator &other) const noexcept { return m_index == other.m_index; }
+        bool operator!=(const iterator &other) const noexcept { return m_index != other.m_index; }
+
+    private:
+        iterator(tape_detail::tape_ref ref, uint32_t index) noexcept : m_ref(ref), m_index(index) {}
+
+        tape_detail::tape_ref m_ref = {nullptr, nullptr};
+        uint32_t m_index = 0;
+    };
+
+    tape_array() = default;
+
+    iterator begin() const noexcept { return iterator(m_ref, m_index + 1); }
+    iterator end() const noexcept {
+        return iterator(m_ref, static_cast<uint32_t>(m_ref.tape[m_index]) - 1);
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    /// @brief O(1) unless the array has more than 2^24 - 1 elements.
+    size_t size() const noexcept {
+        const uint32_t count =
+            static_cast<uint32_t>(m_ref.tape[m_index] >> 32) & tape_detail::count_mask;
+        if (WJR_LIKELY(count != tape_detail::count_mask)) {
+            return count;
+        }
+
+        return static_cast<size_t>(std::distance(begin(), end()));
+    }
+
+    /// @brief Elements before @a idx are skipped in O(1) each.
+    result<tape_value> at(size_t idx) const noexcept {
+        for (auto iter = begin(), last = end(); iter != last; ++iter, --idx) {
+            if (idx == 0) {
+                return *iter;
+            }
+        }
+
+        return unexpected(error_code::INDEX_OUT_OF_BOUNDS);
+    }
+
+private:
+    tape_array(tape_detail::tape_ref ref, uint32_t index) noexcept : m_ref(ref), m_index(index) {}
+
+    tape_detail::tape_ref m_ref = {nullptr, nullptr};
+    uint32_t m_index = 0;
+};
+
+inline result<tape_object> tape_value::get_object() const noexcept {
+    if (WJR_UNLIKELY(__get_type() != tape_detail::start_object)) {
+        return unexpected(error_code::INCORRECT_TYPE);
+    }
+
+    return tape_object(m_ref, m_index);
+}
+
+inline result<tape_array> tape_value::get_array() const noexcept {
+    if (WJR_UNLIKELY(__get_type() != tape_detail::start_array)) {
+        return unexpected(error_code::INCORRECT_TYPE);
+    }
+
+    return tape_array(m_ref, m_index);
+}
+
+inline result<tape_value> tape_value::operator[](std::string_view key) const noexcept {
+    WJR_EXPECTED_INIT(obj, get_object());
+    return obj->find(key);
+}
+
+namespace detail {
+class tape_document_parser;
+}
+
+/**
+ * @brief Immutable document that owns a tape and a string buffer.
+ *
+ * @details Parsing needs two allocations, both sized from the reader up front,
+ * and destruction frees them without walking the values.
+ */
+class tape_document {
+    friend class detail::tape_document_parser;
+
+public:
+    tape_document() = default;
+    tape_document(const tape_document &) = default;
+    tape_document(tape_document &&) = default;
+    tape_document &operator=(const tape_document &) = default;
+    tape_document &operator=(tape_document &&) = default;
+    ~tape_document() = default;
+
+    static result<tape_document> parse(const reader &rd) noexcept;
+
+    /**
+     * @brief Parse without decoding numbers.
+     *
+     * @details Numbers are stored as their position in the input and a type
+     * guessed from their characters ('-', '.', 'e' or 'E'). They are decoded
+     * each time get_uint64(), get_int64() or get_double() reads them, so the
+     * input must outlive the document, and a malformed number is only reported
+     * by these getters. Inputs with many numbers that are never read, such as
+     * coordinates or ids, parse much faster.
+     */
+    static result<tape_document> parse(const reader &rd, lazy_numbers_t) noexcept;
+
+    tape_value root() const noexcept { return tape_value(m_tape.data(), m_strings.data(), 0); }
+
+    span<const uint64_t> tape() const noexcept { return m_tape; }
+    span<const char> strings() const noexcept { return m_strings; }
+
+private:
+    vector<uint64_t> m_tape;
+    vector<char> m_strings;
+};
+
+namespace detail {
+
+class tape_document_parser {
+    template <typename Parser, typename TokenSource>
+    friend result<void> visitor_detail::parse_impl(Parser &&par, TokenSource &src) noexcept;
+
+    struct scope {
+        uint32_t index;
+        uint32_t count;
+    };
+
+public:
+    tape_document_parser(tape_document &doc, bool lazy = false) noexcept
+        : m_doc(doc), m_lazy(lazy) {}
+
+    WJR_INTRINSIC_INLINE result<void> parse(const reader &rd) noexcept {
+        const size_t tokens = static_cast<size_t>(rd.end() - rd.begin());
+
+        // A token adds at most two words, and a string needs at most its
+        // length plus 5 bytes.
+        m_doc.m_tape.clear();
+        m_doc.m_tape.reserve(tokens * 2 + 2);
+        m_doc.m_strings.clear();
+        m_doc.m_strings.reserve(rd.size() + tokens * 3 + 8);
+        m_tape = m_doc.m_tape.data();
+        m_strings = m_doc.m_strings.data();
+        m_current = {0, 0};
+
+        auto ret = visitor_detail::parse(*this, rd);
+        m_doc.m_tape.get_storage().size() = static_cast<size_t>(m_tape - m_doc.m_tape.data());
+        m_doc.m_strings.get_storage().size() =
+            static_cast<size_t>(m_strings - m_doc.m_strings.data());
+        return ret;
+    }
+
+protected:
+    WJR_INTRINSIC_INLINE void __append(uint8_t type, uint64_t payload = 0) noexcept {
+        *m_tape++ = tape_detail::make_word(type, payload);
+    }
+
+    WJR_INTRINSIC_INLINE uint32_t __size() const noexcept {
+        return static_cast<uint32_t>(m_tape - m_doc.m_tape.data());
+    }
+
+    WJR_INTRINSIC_INLINE void __append_raw_number(const char *first, const char *last) noexcept {
+        // The token ends at the next token, after any whitespace.
+        while (charconv_detail::isspace(last[-1])) {
+            --last;
+        }
+
+        const value_t type = tape_detail::guess_number_type(first, last);
+        __append(tape_detail::number_raw,
+                 static_cast<uint64_t>(type) << 32 | static_cast<uint32_t>(last - first));
+        *m_tape++ = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(first));
+    }
+
+    WJR_INTRINSIC_INLINE result<void> __append_number(const char *first,
+                                                      const char *last) noexcept {
+        if (m_lazy) {
+            __append_raw_number(first, last);
+            return {};
+        }
+
+        basic_value value(default_construct);
+        WJR_EXPECTED_TRY(parse_number(first, last, value));
+
+        switch (value.m_type) {
+        case value_t::number_unsigned: {
+            __append(tape_detail::number_unsigned);
+            break;
+        }
+        case value_t::number_signed: {
+            __append(tape_detail::number_signed);
+            break;
+        }
+        default: {
+            __append(tape_detail::number_float);
+            break;
+        }
+        }
+
+        *m_tape++ = value.m_number_unsigned;
+        return {};
+    }
+
+    WJR_INTRINSIC_INLINE result<void> __append_string(const char *first,
+                                                      const char *last) noexcept {
+        __append(tape_detail::string,
+                 static_cast<uint64_t>(m_strings - m_doc.m_strings.data()));
+        char *const dst = m_strings + sizeof(uint32_t);
+        WJR_EXPECTED_INIT(ret, parse_string(dst, first, last));
+        const auto length = static_cast<uint32_t>(*ret - dst);
+        std::memcpy(m_strings, &length, sizeof(uint32_t));
+        *(*ret) = '\0';
+        m_strings = *ret + 1;
+        return {};
+    }
+
+    WJR_INTRINSIC_INLINE void __start(uint8_t type) noexcept {
+        m_stk.emplace_back(m_current);
+        m_current = {__size(), 0};
+        __append(type);
+    }
+
+    WJR_INTRINSIC_INLINE void __end(uint8_t start, uint8_t end) noexcept {
+        const uint32_t index = m_current.index;
+        __append(end, index);
+        const uint32_t count = std::min(m_current.count, tape_detail::count_mask);
+        m_doc.m_tape.data()[index] =
+            tape_detail::make_word(start, static_cast<uint64_t>(count) << 32 | __size());
+    }
+
+    WJR_INTRINSIC_INLINE void __pop() noexcept {
+        m_current = m_stk.back();
+        m_stk.pop_back();
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_root_null(const char *first) noexcept {
+        __append(tape_detail::null_value);
+        return check_null(first);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_object_null(const char *first) noexcept {
+        __append(tape_detail::null_value);
+        return check_null(first);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_array_null(const char *first) noexcept {
+        ++m_current.count;
+        __append(tape_detail::null_value);
+        return check_null(first);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_root_true(const char *first) noexcept {
+        __append(tape_detail::true_value);
+        return check_true(first);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_object_true(const char *first) noexcept {
+        __append(tape_detail::true_value);
+        return check_true(first);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_array_true(const char *first) noexcept {
+        ++m_current.count;
+        __append(tape_detail::true_value);
+        return check_true(first);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_root_false(const char *first) noexcept {
+        __append(tape_detail::false_value);
+        return check_false(first);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_object_false(const char *first) noexcept {
+        __append(tape_detail::false_value);
+        return check_false(first);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_array_false(const char *first) noexcept {
+        ++m_current.count;
+        __append(tape_detail::false_value);
+        return check_false(first);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_root_number(const char *first,
+                                                        const char *last) noexcept {
+        return __append_number(first, last);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_object_number(const char *first,
+                                                          const char *last) noexcept {
+        return __append_number(first, last);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_array_number(const char *first,
+                                                         const char *last) noexcept {
+        ++m_current.count;
+        return __append_number(first, last);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_root_string(const char *first,
+                                                        const char *last) noexcept {
+        return __append_string(first, last);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_object_string(const char *first,
+                                                          const char *last) noexcept {
+        return __append_string(first, last);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_array_string(const char *first,
+                                                         const char *last) noexcept {
+        ++m_current.count;
+        return __append_string(first, last);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_object_key_string(const char *first,
+                                                              const char *last) noexcept {
+        ++m_current.count;
+        return __append_string(first, last);
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_root_start_object(uint32_t) noexcept {
+        __append(tape_detail::start_object);
+        return {};
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_object_start_object(uint32_t) noexcept {
+        __start(tape_detail::start_object);
+        return {};
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_array_start_object(uint32_t) noexcept {
+        ++m_current.count;
+        __start(tape_detail::start_object);
+        return {};
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_root_start_array(uint32_t) noexcept {
+        __append(tape_detail::start_array);
+        return {};
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_object_start_array(uint32_t) noexcept {
+        __start(tape_detail::start_array);
+        return {};
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_array_start_array(uint32_t) noexcept {
+        ++m_current.count;
+        __start(tape_detail::start_array);
+        return {};
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_end_object_to_object(uint32_t) noexcept {
+        __end(tape_detail::start_object, tape_detail::end_object);
+        __pop();
+        return {};
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_end_object_to_array(uint32_t) noexcept {
+        __end(tape_detail::start_object, tape_detail::end_object);
+        __pop();
+        return {};
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_end_object_to_root(uint32_t) noexcept {
+        __end(tape_detail::start_object, tape_detail::end_object);
+        return {};
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_end_array_to_object(uint32_t) noexcept {
+        __end(tape_detail::start_array, tape_detail::end_array);
+        __pop();
+        return {};
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_end_array_to_array(uint32_t) noexcept {
+        __end(tape_detail::start_array, tape_detail::end_array);
+        __pop();
+        return {};
+    }
+
+    WJR_INTRINSIC_INLINE result<void> visit_end_array_to_root(uint32_t) noexcept {
+        __end(tape_detail::start_array, tape_detail::end_array);
+        return {};
+    }
+
+private:
+    tape_document &m_doc;
+    bool m_lazy;
+    uint64_t *m_tape;
+    char *m_strings;
+    scope m_current;
+    inplace_vector<scope, 256> m_stk;
+};
+
+} // namespace detail
+
+namespace visitor_detail {
+
+extern template result<void>
+parse<detail::tape_document_parser &>(detail::tape_document_parser &par,
+                                      const reader &rd) noexcept;
+
+} // namespace visitor_detail
+
+inline result<tape_document> tape_document::parse(const reader &rd) noexcept {
+    tape_document doc;
+    detail::tape_document_parser par(doc);
+    WJR_EXPECTED_TRY(par.parse(rd));
+    return doc;
+}
+
+inline result<tape_document> tape_document::parse(const reader &rd, lazy_numbers_t) noexcept {
+    tape_document doc;
+    detail::tape_document_parser par(doc, true);
+    WJR_EXPECTED_TRY(par.parse(rd));
+    return doc;
+}
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_TAPE_DOCUMENT_HPP__
@@ -0,0 +1,61 @@
+/**
+ * @file view_document.hpp
+ * @author wjr
+ * @brief JSON document whose strings refer to the input when possible.
+ *
+ * @details Strings and keys of a view_document without escape sequences are
+ * views of the input buffer, so parsing them neither allocates nor copies.
+ * Only strings that must be unescaped get storage of their own.
+ *
+ * @version 0.1
+ * @date 2025-01-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_JSON_VIEW_DOCUMENT_HPP__
+#define WJR_JSON_VIEW_DOCUMENT_HPP__
+
+#include <wjr/json/document.hpp>
+
+namespace wjr::json {
+
+namespace detail {
+
+using view_document_traits = basic_document_traits<basic_borrowed_string, btree_map, vector>;
+
+} // namespace detail
+
+/**
+ * @brief A document that borrows strings from the input.
+ *
+ * @details The input buffer of the reader must outlive the document, or
+ * detach() must be called before the buffer is released or modified:
+ * @code
+ * auto doc = *json::view_document::parse(rd);
+ * // use doc while the input is alive
+ * doc.detach();
+ * // doc no longer refers to the input
+ * @endcode
+ * Copies of a view_document borrow from the same input. Strings assigned
+ * after parsing always own their characters.
+ *
+ */
+using view_document = basic_document<detail::view_document_traits>;
+
+namespace visitor_detail {
+
+extern template result<void>
+parse<detail::basic_document_parser<view_document> &>(
+    detail::basic_document_parser<view_document> &par, const reader &rd) noexcept;
+
+extern template result<void>
+parse<detail::basic_document_parser<view_document> &>(
+    detail::basic_document_parser<view_document> &par, stream_reader &rd) noexcept;
+
+} // namespace visitor_detail
+
+} // namespace wjr::json
+
+#endif // WJR_JSON_VIEW_DOCUMENT_HPP__
@@ -2,10 +2,16 @@
  * @file visitor.hpp
  * @author wjr
  * @brief
+ * @details The public handler interface over parse_impl is json::sax_parse in
+ * sax.hpp.
  * @todo \
- * 1. Virtual visitor, this is faster than document.    \
- * 2. Just like simdjson, parse struct by using iterator. In my test, \
- * this is slightly slower than first one.
+ * Just like simdjson, parse struct by using iterator. In my test, \
+ * this is slightly slower than sax_parse.
+ * @note \
+ * parse_impl reads the first byte of every token from the input. Writing that \
+ * byte to a tag array beside the tokens in the lexer and dispatching on it \
+ * doesn't pay off. In my test, check() was no faster and reading the tokens \
+ * was about 45% slower, so a reader keeps only the positions.
  * @version 0.1
  * @date 2024-10-09
  *
@@ -19,13 +25,15 @@
 #include <wjr/container/bitset.hpp>
 #include <wjr/json/number.hpp>
 #include <wjr/json/reader.hpp>
+#include <wjr/json/stream_reader.hpp>
 #include <wjr/json/string.hpp>
 
 namespace wjr::json {
 
 namespace detail {
 
-WJR_PURE WJR_INTRINSIC_INLINE bool is_invalid_token(const char *ptr, uint32_t start, uint32_t end,
+template <typename T>
+WJR_PURE WJR_INTRINSIC_INLINE bool is_invalid_token(const char *ptr, T start, T end,
                                                     uint32_t size) noexcept {
     const auto length = end - start;
     return length < size || (length > size && !charconv_detail::isspace(ptr[start + size]));
@@ -59,8 +67,53 @@ WJR_PURE WJR_INTRINSIC_INLINE result<void> check_false(const char *first) noexce
 
 namespace visitor_detail {
 
-template <typename Parser>
-WJR_NOINLINE result<void> parse(Parser &&par, const reader &rd) noexcept {
+/**
+ * @brief Tokens of a reader.
+ *
+ * @details A token source gives the positions of tokens one by one. It has:
+ * - value_type : type of token positions.
+ * - data() : the input, every token position is relative to it.
+ * - size() : length of the input.
+ * - next(token) : read the next token, return false if there is none.
+ *
+ */
+class reader_token_source {
+public:
+    using value_type = uint32_t;
+
+    explicit reader_token_source(const reader &rd) noexcept
+        : m_first(wjr::to_address(rd.begin())), m_last(wjr::to_address(rd.end())),
+          m_data(rd.data()), m_size(rd.size()) {}
+
+    WJR_PURE const char *data() const noexcept { return m_data; }
+    WJR_PURE value_type size() const noexcept { return m_size; }
+
+    WJR_INTRINSIC_INLINE bool next(value_type &token) noexcept {
+        if (WJR_LIKELY(m_first != m_last)) {
+            token = *m_first++;
+            return true;
+        }
+
+        return false;
+    }
+
+private:
+    const uint32_t *m_first;
+    const uint32_t *m_last;
+    const char *m_data;
+    value_type m_size;
+};
+
+/**
+ * @brief Parse tokens of any token source.
+ *
+ * @details Tokens passed to visit_*_start_* and visit_end_* have the value_type of
+ * the token source.
+ *
+ */
+template <typename Parser, typename TokenSource>
+WJR_INTRINSIC_INLINE result<void> parse_impl(Parser &&par, TokenSource &src) noexcept {
+    using value_type = typename TokenSource::value_type;
     constexpr unsigned int max_depth = 256;
 
     bitset<max_depth> stk(default_construct);
@@ -68,24 +121,19 @@ WJR_NOINLINE result<void> parse(Parser &&par, const reader &rd) noexcept {
     uint8_t type;
 
     // token reader
-    auto read = [&rd]() {
-        auto __begin = rd.begin();
-        auto __end = rd.end();
-        return [__begin, __end](uint32_t &token,
-                                error_code err = error_code::TAPE_ERROR) mutable -> result<void> {
-            if (WJR_LIKELY(__begin != __end)) {
-                token = *__begin++;
-                return {};
-            }
+    auto read = [&src](value_type &token,
+                       error_code err = error_code::TAPE_ERROR) -> result<void> {
+        if (WJR_LIKELY(src.next(token))) {
+            return {};
+        }
 
-            return unexpected(err);
-        };
-    }();
+        return unexpected(err);
+    };
 
-    uint32_t token;
-    uint32_t next_token;
+    value_type token;
+    value_type next_token;
 
-    const char *const ptr = rd.data();
+    const char *const ptr = src.data();
     WJR_EXPECTED_TRY(read(token, error_code::TAPE_ERROR));
 
     if (uint8_t ch = ptr[token]; WJR_LIKELY(ch == '{')) {
@@ -113,7 +161,7 @@ WJR_NOINLINE result<void> parse(Parser &&par, const reader &rd) noexcept {
 
         goto ARRAY_ELEMENT;
     } else {
-        const auto size = rd.size();
+        const value_type size = src.size();
 
         if (ch == '"') {
             if (WJR_UNLIKELY(!read(next_token))) {
@@ -450,6 +498,27 @@ ARRAY_ELEMENT:
 }
 }
 
+template <typename Parser>
+WJR_NOINLINE result<void> parse(Parser &&par, const reader &rd) noexcept {
+    if (WJR_UNLIKELY(!rd.is_valid_utf8())) {
+        return unexpected(error_code::UTF8_ERROR);
+    }
+
+    reader_token_source src(rd);
+    return parse_impl(std::forward<Parser>(par), src);
+}
+
+template <typename Parser>
+WJR_NOINLINE result<void> parse(Parser &&par, stream_reader &rd) noexcept {
+    auto ret = parse_impl(std::forward<Parser>(par), rd);
+    // The stream is validated while it is parsed.
+    if (WJR_UNLIKELY(!rd.is_valid_utf8())) {
+        return unexpected(error_code::UTF8_ERROR);
+    }
+
+    return ret;
+}
+
 } // namespace visitor_detail
 
 } // namespace wjr::json
@@ -0,0 +1,267 @@
+/**
+ * @file arena.hpp
+ * @author wjr
+ * @brief Bump allocator whose memory is released all at once.
+ * @version 0.1
+ * @date 2025-01-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef WJR_MEMORY_ARENA_HPP__
+#define WJR_MEMORY_ARENA_HPP__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+
+#include <wjr/math/literals.hpp>
+#include <wjr/memory/align.hpp>
+
+namespace wjr {
+
+/**
+ * @brief A bump allocator.
+ *
+ * @details Allocation only moves a pointer inside the current block, a new block
+ * is taken from malloc when it's full. Memory is given back by reset() or
+ * release(), never piece by piece. \n
+ * reset() keeps the memory as one block, so an arena that is reset and reused
+ * stops allocating once it reached its high-water mark.
+ *
+ */
+class arena {
+    struct block {
+        block *prev;
+        size_t size;
+    };
+
+    static_assert(sizeof(block) % alignof(std::max_align_t) == 0, "");
+
+public:
+    static constexpr size_t default_block_size = 16_KB;
+    static constexpr size_t max_block_size = 64_MB;
+
+    arena() = default;
+    explicit arena(size_t block_size) noexcept : m_next_size(block_size) {}
+
+    arena(const arena &) = delete;
+    arena &operator=(const arena &) = delete;
+
+    arena(arena &&other) noexcept
+        : m_ptr(other.m_ptr), m_end(other.m_end), m_head(other.m_head),
+          m_next_size(other.m_next_size) {
+        other.m_ptr = other.m_end = nullptr;
+        other.m_head = nullptr;
+    }
+
+    arena &operator=(arena &&other) noexcept {
+        if (WJR_LIKELY(this != std::addressof(other))) {
+            release();
+            m_ptr = other.m_ptr;
+            m_end = other.m_end;
+            m_head = other.m_head;
+            m_next_size = other.m_next_size;
+            other.m_ptr = other.m_end = nullptr;
+            other.m_head = nullptr;
+        }
+
+        return *this;
+    }
+
+    ~arena() noexcept { release(); }
+
+    WJR_NODISCARD WJR_MALLOC WJR_INTRINSIC_INLINE void *
+    allocate(size_t n, size_t alignment = alignof(std::max_align_t)) noexcept {
+        const auto ptr = align_up(reinterpret_cast<uintptr_t>(m_ptr), alignment);
+        if (WJR_UNLIKELY(reinterpret_cast<uintptr_t>(m_end) - ptr < n ||
+                         ptr > reinterpret_cast<uintptr_t>(m_end))) {
+            return __allocate_slow(n, alignment);
+        }
+
+        m_ptr = reinterpret_cast<char *>(ptr + n);
+        return reinterpret_cast<void *>(ptr);
+    }
+
+    /// @brief Only the latest allocation can be given back.
+    WJR_INTRINSIC_INLINE void deallocate(void *ptr, size_t n) noexcept {
+        if (static_cast<char *>(ptr) + n == m_ptr) {
+            m_ptr = static_cast<char *>(ptr);
+        }
+    }
+
+    /**
+     * @brief Release every allocation.
+     *
+     * @details The blocks are merged into one block of their total size, which is
+     * kept for later allocations.
+     */
+    void reset() noexcept {
+        if (m_head == nullptr) {
+            return;
+        }
+
+        if (m_head->prev != nullptr) {
+            const size_t total = capacity();
+            __free_blocks();
+            __new_block(total);
+        }
+
+        m_ptr = reinterpret_cast<char *>(m_head + 1);
+    }
+
+    /// @brief Release every allocation and every block.
+    void release() noexcept {
+        __free_blocks();
+        m_ptr = m_end = nullptr;
+    }
+
+    /// @brief Bytes of all blocks.
+    size_t capacity() const noexcept {
+        size_t total = 0;
+        for (block *node = m_head; node != nullptr; node = node->prev) {
+            total += node->size;
+        }
+
+        return total;
+    }
+
+    /// @brief The arena used by arena_allocator in this thread, or nullptr.
+    static arena *current() noexcept { return __current(); }
+
+private:
+    friend class arena_scope;
+
+    static arena *&__current() noexcept {
+        static thread_local arena *instance = nullptr;
+        return instance;
+    }
+
+    void __new_block(size_t size) noexcept {
+        auto *const node = static_cast<block *>(std::malloc(sizeof(block) + size));
+        if (WJR_UNLIKELY(node == nullptr)) {
+            std::abort();
+        }
+
+        node->prev = m_head;
+        node->size = size;
+        m_head = node;
+        m_ptr = reinterpret_cast<char *>(node + 1);
+        m_end = m_ptr + size;
+    }
+
+    void __free_blocks() noexcept {
+        block *node = m_head;
+        while (node != nullptr) {
+            block *const prev = node->prev;
+            std::free(node);
+            node = prev;
+        }
+
+        m_head = nullptr;
+    }
+
+    WJR_NOINLINE void *__allocate_slow(size_t n, size_t alignment) noexcept {
+        const size_t size = std::max(m_next_size, n + alignment);
+        m_next_size = std::min(std::max(m_next_size, size) * 2, max_block_size);
+        __new_block(size);
+        const auto ptr = align_up(reinterpret_cast<uintptr_t>(m_ptr), alignment);
+        m_ptr = reinterpret_cast<char *>(ptr + n);
+        return reinterpret_cast<void *>(ptr);
+    }
+
+    char *m_ptr = nullptr;
+    char *m_end = nullptr;
+    block *m_head = nullptr;
+    size_t m_next_size = default_block_size;
+};
+
+/**
+ * @brief Make an arena the current arena of this thread during the lifetime of
+ * the scope.
+ *
+ * @details Scopes can be nested, the previous arena is restored on destruction.
+ */
+class arena_scope {
+public:
+    explicit arena_scope(arena &al) noexcept : m_prev(arena::__current()) {
+        arena::__current() = std::addressof(al);
+    }
+
+    arena_scope(const arena_scope &) = delete;
+    arena_scope &operator=(const arena_scope &) = delete;
+
+    ~arena_scope() noexcept { arena::__current() = m_prev; }
+
+private:
+    arena *m_prev;
+};
+
+/**
+ * @brief Stateless allocator that allocates from the current arena.
+ *
+ * @details Containers using it must only allocate while an arena_scope is
+ * active, and must not outlive that arena. deallocate() only rewinds the latest
+ * allocation, the memory is released with the arena, so destructors of such
+ * containers may be skipped entirely.
+ *
+ */
+template <typename T>
+class arena_allocator {
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+    using is_trivially_allocator = std::true_type;
+
+    template <typename Other>
+    struct rebind {
+        using other = arena_allocator<Other>;
+    };
+
+    arena_allocator() = default;
+    arena_allocator(const arena_allocator &) = default;
+    arena_allocator &operator=(const arena_allocator &) = default;
+    ~arena_allocator() = default;
+
+    template <typename U>
+    constexpr arena_allocator(const arena_allocator<U> &) noexcept {}
+
+    WJR_NODISCARD WJR_MALLOC T *allocate(size_type n) const noexcept {
+        arena *const al = arena::current();
+        WJR_ASSERT_L0(al != nullptr, "arena_allocator is used without an arena_scope");
+        return static_cast<T *>(al->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *ptr, size_type n) const noexcept {
+        if (arena *const al = arena::current(); al != nullptr) {
+            al->deallocate(ptr, n * sizeof(T));
+        }
+    }
+
+    template <typename U>
+    constexpr bool operator==(const arena_allocator<U> &) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    constexpr bool operator!=(const arena_allocator<U> &) const noexcept {
+        return false;
+    }
+};
+
+template <typename Alloc>
+struct is_arena_allocator : std::false_type {};
+
+template <typename T>
+struct is_arena_allocator<arena_allocator<T>> : std::true_type {};
+
+template <typename Alloc>
+inline constexpr bool is_arena_allocator_v = is_arena_allocator<Alloc>::value;
+
+} // namespace wjr
+
+#endif // WJR_MEMORY_ARENA_HPP__
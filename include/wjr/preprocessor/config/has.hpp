@@ -162,6 +162,10 @@
     #define WJR_HAS_SIMD_AVX512DQ WJR_HAS_DEF
 #endif
 
+#if defined(__AVX512VBMI2__)
+    #define WJR_HAS_SIMD_AVX512VBMI2 WJR_HAS_DEF
+#endif
+
 #if defined(__AVX512F__) ||                                                                        \
     (WJR_HAS_SIMD(AVX512VL) && WJR_HAS_SIMD(AVX512BW) && WJR_HAS_SIMD(AVX512DQ))
     #define WJR_HAS_SIMD_AVX512F WJR_HAS_DEF
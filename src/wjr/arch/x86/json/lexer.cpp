@@ -160,86 +160,314 @@ WJR_INTRINSIC_INLINE void compress(char *dst, __m256i x, uint32_t mask) noexcept
 
 #if WJR_HAS_BUILTIN(JSON_LEXER_READER_READ_BUF)
 
-/// @todo Unroll two times maybe faster on some platforms.
-typename lexer::result_type lexer::read(uint32_t *token_buf, size_type token_buf_size) noexcept {
-    if (WJR_UNLIKELY(first == last)) {
-        return result_type::mask;
+namespace lexer_detail {
+namespace {
+
+/**
+ * @brief Classify a block of 64 bytes.
+ *
+ * @param B backslashes.
+ * @param Q quotes.
+ * @param S brackets, commas, colons and whitespaces.
+ * @param W whitespaces.
+ */
+WJR_INTRINSIC_INLINE void classify(const char *ptr, uint64_t &B, uint64_t &Q, uint64_t &S,
+                                   uint64_t &W) noexcept {
+    #if WJR_HAS_SIMD(AVX512BW)
+    const __m512i x = _mm512_loadu_si512(ptr);
+    // Same as lo8_lookup and hi8_lookup in every 128-bit lane.
+    const __m512i lo8 = _mm512_set4_epi32(0x00000C01, 0x040A0800, 0, 0x00000010);
+    const __m512i hi8 = _mm512_set4_epi32(0, 0, 0x04000400, 0x02110008);
+
+    B = _mm512_cmpeq_epi8_mask(x, _mm512_set1_epi8('\\'));
+    Q = _mm512_cmpeq_epi8_mask(x, _mm512_set1_epi8('"'));
+
+    const __m512i shuf_lo8 = _mm512_shuffle_epi8(lo8, x);
+    const __m512i shuf_hi8 = _mm512_shuffle_epi8(
+        hi8, _mm512_and_si512(_mm512_srli_epi16(x, 4), _mm512_set1_epi8(0x0f)));
+    const __m512i result = _mm512_and_si512(shuf_lo8, shuf_hi8);
+
+    S = _mm512_test_epi8_mask(result, result);
+    W = _mm512_test_epi8_mask(result, _mm512_set1_epi8(0x18));
+    #else
+    using simd = std::conditional_t<WJR_HAS_SIMD(AVX2), avx, sse>;
+    using simd_int = typename simd::int_type;
+    constexpr auto simd_width = simd::width();
+    constexpr auto u8_width = simd_width / 8;
+    constexpr auto u8_loop = 64 / u8_width;
+
+    simd_int stk[u8_loop];
+
+    for (size_t i = 0; i < u8_loop; ++i) {
+        stk[i] = simd::loadu(ptr + i * u8_width);
     }
 
-    using namespace lexer_detail;
+    B = 0;
+
+    for (unsigned i = 0; i < u8_loop; ++i) {
+        const auto backslash = simd::cmpeq_epi8(stk[i], simd::set1_epi8('\\'));
+        B |= (uint64_t)simd::movemask_epi8(backslash) << (i * u8_width);
+    }
+
+    Q = 0;
+
+    for (unsigned i = 0; i < u8_loop; ++i) {
+        const auto quote = simd::cmpeq_epi8(stk[i], simd::set1_epi8('"'));
+        Q |= (uint64_t)simd::movemask_epi8(quote) << (i * u8_width);
+    }
+
+    S = 0;
+    W = 0;
+
+    for (unsigned i = 0; i < u8_loop; ++i) {
+        const auto shuf_lo8 = simd::shuffle_epi8(lo8_lookup, stk[i]);
+        const auto shuf_hi8 =
+            simd::shuffle_epi8(hi8_lookup, simd::And(simd::srli_epi16(stk[i], 4), lh8_mask));
+
+        const auto result = simd::And(shuf_lo8, shuf_hi8);
+        // comma : 1
+        // colon : 2
+        // brackets : 4
+        // whitespace : 8, 16
+        // others : 0
+
+        const uint32_t stu = simd::movemask_epi8(simd::cmpgt_epi8(result, simd::zeros()));
+        const uint32_t wsp = simd::movemask_epi8(simd::cmpgt_epi8(result, simd::set1_epi8(7)));
+
+        S |= (uint64_t)(stu) << (i * u8_width);
+        W |= (uint64_t)(wsp) << (i * u8_width);
+    }
+    #endif
+}
+
+    #if WJR_HAS_SIMD(AVX512F)
+/**
+ * @brief Write idx + position of every set bit of S, 16 bits at a time.
+ *
+ * @details Writes at most 16 tokens past the returned pointer.
+ */
+WJR_INTRINSIC_INLINE uint32_t *compress_tokens(uint32_t *buf, uint64_t S, uint32_t idx) noexcept {
+    __m512i pos = _mm512_add_epi32(_mm512_set1_epi32(idx),
+                                   _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
+                                                     13, 14, 15));
+
+    for (unsigned i = 0; i < 4; ++i) {
+        const auto mask = static_cast<__mmask16>(S >> (i * 16));
+        _mm512_storeu_si512(buf, _mm512_maskz_compress_epi32(mask, pos));
+        buf += popcount(mask);
+        pos = _mm512_add_epi32(pos, _mm512_set1_epi32(16));
+    }
+
+    return buf;
+}
+    #endif
+
+WJR_INTRINSIC_INLINE void append_tokens(vector<uint32_t> &tokens, uint64_t S,
+                                        uint32_t idx) noexcept {
+    uint32_t *buf = tokens.end_unsafe();
+    tokens.get_storage().size() += popcount(S);
+
+    #if WJR_HAS_SIMD(AVX512F)
+    compress_tokens(buf, S, idx);
+    #else
+    while (S) {
+        *buf++ = idx + ctz(S);
+        S &= S - 1;
+    }
+    #endif
+}
+
+// Lookup-table UTF-8 validation. Every byte is looked up by the high and low
+// nibbles of the byte before it and by its own high nibble, an error is a bit
+// set in all three lookups.
+constexpr uint8_t utf8_too_short = 1 << 0;
+constexpr uint8_t utf8_too_long = 1 << 1;
+constexpr uint8_t utf8_overlong_3 = 1 << 2;
+constexpr uint8_t utf8_too_large = 1 << 3;
+constexpr uint8_t utf8_surrogate = 1 << 4;
+constexpr uint8_t utf8_overlong_2 = 1 << 5;
+constexpr uint8_t utf8_too_large_1000 = 1 << 6;
+constexpr uint8_t utf8_overlong_4 = 1 << 6;
+constexpr uint8_t utf8_two_conts = 1 << 7;
+constexpr uint8_t utf8_carry = utf8_too_short | utf8_too_long | utf8_two_conts;
+
+// byte_1_high, byte_1_low and byte_2_high.
+const std::array<uint8_t, 48> utf8_lookup = {
+    // 0xxx: ASCII
+    utf8_too_long, utf8_too_long, utf8_too_long, utf8_too_long, utf8_too_long, utf8_too_long,
+    utf8_too_long, utf8_too_long,
+    // 10xx: continuation
+    utf8_two_conts, utf8_two_conts, utf8_two_conts, utf8_two_conts,
+    // 1100
+    utf8_too_short | utf8_overlong_2,
+    // 1101
+    utf8_too_short,
+    // 1110
+    utf8_too_short | utf8_overlong_3 | utf8_surrogate,
+    // 1111
+    utf8_too_short | utf8_too_large | utf8_too_large_1000 | utf8_overlong_4,
+
+    utf8_carry | utf8_overlong_3 | utf8_overlong_2 | utf8_overlong_4,
+    utf8_carry | utf8_overlong_2,
+    utf8_carry,
+    utf8_carry,
+    utf8_carry | utf8_too_large,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000 | utf8_surrogate,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+
+    utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short,
+    utf8_too_short, utf8_too_short, utf8_too_short,
+    utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_overlong_3 | utf8_too_large_1000 |
+        utf8_overlong_4,
+    utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_overlong_3 | utf8_too_large,
+    utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_surrogate | utf8_too_large,
+    utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_surrogate | utf8_too_large,
+    utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short};
+
+    #if !WJR_HAS_SIMD(AVX2)
+WJR_INTRINSIC_INLINE __m128i utf8_load_lookup(unsigned i) noexcept {
+    return sse::loadu(&utf8_lookup[i * 16]);
+}
+
+WJR_INTRINSIC_INLINE __m128i utf8_load_tail(uint32_t tail) noexcept {
+    return sse::set_epi32(static_cast<int>(tail), 0, 0, 0);
+}
+
+/// @brief input shifted N bytes towards the end, with the last bytes of prev in front.
+template <int N>
+WJR_INTRINSIC_INLINE __m128i utf8_prev(__m128i input, __m128i prev) noexcept {
+    return sse::alignr<16 - N>(input, prev);
+}
+    #else
+WJR_INTRINSIC_INLINE __m256i utf8_load_lookup(unsigned i) noexcept {
+    const __m128i x = sse::loadu(&utf8_lookup[i * 16]);
+    return avx::concat(x, x);
+}
+
+WJR_INTRINSIC_INLINE __m256i utf8_load_tail(uint32_t tail) noexcept {
+    return avx::set_epi32(static_cast<int>(tail), 0, 0, 0, 0, 0, 0, 0);
+}
+
+template <int N>
+WJR_INTRINSIC_INLINE __m256i utf8_prev(__m256i input, __m256i prev) noexcept {
+    return avx::alignr<16 - N>(input, _mm256_permute2x128_si256(prev, input, 0x21));
+}
+    #endif
 
+/**
+ * @brief Validate a block of 64 bytes as UTF-8.
+ *
+ * @param prev_utf8 The last four bytes of the previous block, replaced by the
+ * last four bytes of this one.
+ * @return Whether the block, together with the sequence cut at the end of the
+ * previous block, is invalid.
+ */
+WJR_INTRINSIC_INLINE bool check_utf8(const char *ptr, uint32_t &prev_utf8) noexcept {
+    // AVX512 loads the block into one register in classify, validating it with
+    // AVX2 wide registers is not measurably slower.
     using simd = std::conditional_t<WJR_HAS_SIMD(AVX2), avx, sse>;
     using simd_int = typename simd::int_type;
     constexpr auto simd_width = simd::width();
     constexpr auto u8_width = simd_width / 8;
     constexpr auto u8_loop = 64 / u8_width;
 
+    const uint32_t tail = prev_utf8;
+    prev_utf8 = read_memory<uint32_t>(ptr + 60);
+
+    simd_int stk[u8_loop];
+    simd_int any = simd::zeros();
+
+    for (size_t i = 0; i < u8_loop; ++i) {
+        stk[i] = simd::loadu(ptr + i * u8_width);
+        any = simd::Or(any, stk[i]);
+    }
+
+    // ASCII only, a sequence cut at the end of the previous block is not finished.
+    if (WJR_LIKELY(simd::movemask_epi8(any) == 0)) {
+        return is_incomplete_utf8(tail);
+    }
+
+    const simd_int byte_1_high = utf8_load_lookup(0);
+    const simd_int byte_1_low = utf8_load_lookup(1);
+    const simd_int byte_2_high = utf8_load_lookup(2);
+    const simd_int lh4_mask = simd::set1_epi8(0x0f);
+
+    simd_int prev = utf8_load_tail(tail);
+    simd_int error = simd::zeros();
+
+    for (size_t i = 0; i < u8_loop; ++i) {
+        const simd_int input = stk[i];
+        const simd_int prev1 = utf8_prev<1>(input, prev);
+
+        const simd_int special = simd::And(
+            simd::And(
+                simd::shuffle_epi8(byte_1_high, simd::And(simd::srli_epi16(prev1, 4), lh4_mask)),
+                simd::shuffle_epi8(byte_1_low, simd::And(prev1, lh4_mask))),
+            simd::shuffle_epi8(byte_2_high, simd::And(simd::srli_epi16(input, 4), lh4_mask)));
+
+        // Only the third and fourth bytes of a sequence follow 111xxxxx and 1111xxxx.
+        const simd_int must23 =
+            simd::Or(simd::subs_epu8(utf8_prev<2>(input, prev), simd::set1_epi8(0xE0 - 0x80)),
+                     simd::subs_epu8(utf8_prev<3>(input, prev), simd::set1_epi8(0xF0 - 0x80)));
+        const simd_int must23_80 =
+            simd::And(must23, simd::set1_epi8(static_cast<int8_t>(0x80)));
+
+        error = simd::Or(error, simd::Xor(must23_80, special));
+        prev = input;
+    }
+
+    using mask_type = typename simd::mask_type;
+    return static_cast<mask_type>(simd::movemask_epi8(simd::cmpeq_epi8(error, simd::zeros()))) !=
+           simd::mask();
+}
+
+} // namespace
+} // namespace lexer_detail
+
+/// @todo Unroll two times maybe faster on some platforms.
+typename lexer::result_type lexer::read(uint32_t *token_buf, size_type token_buf_size) noexcept {
+    if (WJR_UNLIKELY(first == last)) {
+        return result_type::mask;
+    }
+
+    using namespace lexer_detail;
+
     WJR_ASSERT_ASSUME_L2(first < last);
 
     uint32_t count = 0;
-    simd_int stk[u8_loop];
+    char buf[64];
 
     do {
-        if (const size_t diff = last - first; WJR_LIKELY(diff > 64)) {
-            for (size_t i = 0; i < u8_loop; ++i) {
-                stk[i] = simd::loadu(first + i * u8_width);
-            }
+        const char *ptr;
 
+        if (const size_t diff = last - first; WJR_LIKELY(diff > 64)) {
+            ptr = first;
             first += 64;
         } else {
             if (diff == 64) {
-                for (size_t i = 0; i < u8_loop; ++i) {
-                    stk[i] = simd::loadu(first + i * u8_width);
-                }
+                ptr = first;
             } else {
-                char buf[64];
                 std::memset(buf, ' ', 64);
                 std::memcpy(buf, first, diff);
-
-                for (size_t i = 0; i < u8_loop; ++i) {
-                    stk[i] = simd::loadu(buf + i * u8_width);
-                }
+                ptr = buf;
             }
 
             first = last;
             count |= result_type::mask;
         }
 
-        uint64_t B = 0; // backslash
-
-        for (unsigned i = 0; i < u8_loop; ++i) {
-            const auto backslash = simd::cmpeq_epi8(stk[i], simd::set1_epi8('\\'));
-            B |= (uint64_t)simd::movemask_epi8(backslash) << (i * u8_width);
-        }
-
-        uint64_t Q = 0; // quote
-
-        for (unsigned i = 0; i < u8_loop; ++i) {
-            const auto quote = simd::cmpeq_epi8(stk[i], simd::set1_epi8('"'));
-            Q |= (uint64_t)simd::movemask_epi8(quote) << (i * u8_width);
-        }
-
-        uint64_t S = 0; // brackets, comma , colon
-        uint64_t W = 0; // whitespace
-
-        for (unsigned i = 0; i < u8_loop; ++i) {
-            const auto shuf_lo8 = simd::shuffle_epi8(lo8_lookup, stk[i]);
-            const auto shuf_hi8 =
-                simd::shuffle_epi8(hi8_lookup, simd::And(simd::srli_epi16(stk[i], 4), lh8_mask));
-
-            const auto result = simd::And(shuf_lo8, shuf_hi8);
-            // comma : 1
-            // colon : 2
-            // brackets : 4
-            // whitespace : 8, 16
-            // others : 0
-
-            const uint32_t stu = simd::movemask_epi8(simd::cmpgt_epi8(result, simd::zeros()));
-            const uint32_t wsp = simd::movemask_epi8(simd::cmpgt_epi8(result, simd::set1_epi8(7)));
-
-            S |= (uint64_t)(stu) << (i * u8_width);
-            W |= (uint64_t)(wsp) << (i * u8_width);
-        }
+        uint64_t B, Q, S, W;
+        classify(ptr, B, Q, S, W);
+        utf8_error |= check_utf8(ptr, prev_utf8);
 
         const auto WS = S;
         S ^= W;
@@ -265,6 +493,13 @@ typename lexer::result_type lexer::read(uint32_t *token_buf, size_type token_buf
         S &= ~R;
         S |= Q;
 
+    #if WJR_HAS_SIMD(AVX512F)
+        if (S) {
+            uint32_t *const end = compress_tokens(token_buf, S, idx);
+            count += static_cast<uint32_t>(end - token_buf);
+            token_buf = end;
+        }
+    #else
         if (S) {
             const auto num = popcount(S);
 
@@ -327,6 +562,7 @@ typename lexer::result_type lexer::read(uint32_t *token_buf, size_type token_buf
             token_buf += num;
             count += num;
         }
+    #endif
 
         idx += 64;
     } while (WJR_LIKELY(count <= token_buf_size));
@@ -334,10 +570,139 @@ typename lexer::result_type lexer::read(uint32_t *token_buf, size_type token_buf
     return count;
 }
 
+bool lexer_detail::read_speculative(const char *first, const char *last, uint32_t offset,
+                                    uint64_t prev_is_escape, uint64_t prev_is_ws,
+                                    uint32_t prev_utf8, bool &utf8_error,
+                                    vector<uint32_t> (&tokens)[2]) noexcept {
+    uint64_t prev_in_string = 0;
+    uint32_t idx = offset;
+    char buf[64];
+
+    while (first != last) {
+        const char *ptr;
+
+        if (const size_t diff = last - first; WJR_LIKELY(diff >= 64)) {
+            ptr = first;
+            first += 64;
+        } else {
+            std::memset(buf, ' ', 64);
+            std::memcpy(buf, first, diff);
+            ptr = buf;
+            first = last;
+        }
+
+        uint64_t B, Q, S, W;
+        classify(ptr, B, Q, S, W);
+        utf8_error |= check_utf8(ptr, prev_utf8);
+
+        const auto WS = S;
+        S ^= W;
+
+        if (WJR_LIKELY(!B)) {
+            B = prev_is_escape;
+            prev_is_escape = 0;
+        } else {
+            const uint64_t codeB = calc_backslash(B & ~prev_is_escape);
+            const auto escape = (codeB & B) >> 63;
+            B = codeB ^ (B | prev_is_escape);
+            prev_is_escape = escape;
+        }
+
+        Q &= ~B;
+        const uint64_t R = prefix_xor(Q) ^ prev_in_string;
+        prev_in_string = static_cast<uint64_t>(static_cast<int64_t>(R) >> 63);
+
+        const auto WT = shld(WS, prev_is_ws, 1);
+        prev_is_ws = WS;
+
+        S |= WT & ~W;
+
+        // Starting inside a string flips R for the whole part.
+        for (auto &vec : tokens) {
+            if (WJR_UNLIKELY(vec.capacity() - vec.size() < 64)) {
+                vec.reserve(std::max<size_t>(vec.capacity() * 2, 1024));
+            }
+        }
+
+        append_tokens(tokens[0], (S & ~R) | Q, idx);
+        append_tokens(tokens[1], (S & R) | Q, idx);
+        idx += 64;
+    }
+
+    return prev_in_string != 0;
+}
+
 #endif
 
 #if WJR_HAS_BUILTIN(JSON_MINIFY_BUF)
 
+    #if WJR_HAS_SIMD(AVX512VBMI2)
+
+char *minify(char *dst, const char *first, const char *last) noexcept {
+    if (WJR_UNLIKELY(first == last)) {
+        return dst;
+    }
+
+    using namespace lexer_detail;
+
+    WJR_ASSERT_ASSUME_L2(first < last);
+
+    uint64_t prev_in_string = 0;
+    uint64_t prev_is_escape = 0;
+    char buf[64];
+
+    do {
+        uint64_t P = 0; // padding of the last block
+        const char *ptr;
+
+        if (const size_t diff = last - first; WJR_LIKELY(diff > 64)) {
+            ptr = first;
+            first += 64;
+        } else {
+            if (diff == 64) {
+                ptr = first;
+            } else {
+                std::memset(buf, ' ', 64);
+                std::memcpy(buf, first, diff);
+                P = ~0ull << diff;
+                ptr = buf;
+            }
+
+            first = last;
+        }
+
+        uint64_t B, Q, S, W;
+        classify(ptr, B, Q, S, W);
+
+        if (WJR_LIKELY(!B)) {
+            B = prev_is_escape;
+            prev_is_escape = 0;
+        } else {
+            const uint64_t codeB = calc_backslash(B & ~prev_is_escape);
+            const auto escape = (codeB & B) >> 63;
+            B = codeB ^ (B | prev_is_escape);
+            prev_is_escape = escape;
+        }
+
+        Q &= ~B;
+        const uint64_t R = prefix_xor(Q) ^ prev_in_string;
+        prev_in_string = static_cast<uint64_t>(static_cast<int64_t>(R) >> 63);
+        W &= ~(R | Q);
+        W |= P;
+
+        // Masked store, so the last block doesn't write past the output.
+        const uint64_t keep = ~W;
+        const int num = popcount(keep);
+        const __m512i x = _mm512_maskz_compress_epi8(keep, _mm512_loadu_si512(ptr));
+        _mm512_mask_storeu_epi8(dst, num == 64 ? ~0ull : (1ull << num) - 1, x);
+        dst += num;
+    } while (first != last);
+
+    return dst;
+}
+
+    #else
+
 char *minify(char *dst, const char *first, const char *last) noexcept {
     if (WJR_UNLIKELY(first == last)) {
         return dst;
@@ -359,6 +724,7 @@ char *minify(char *dst, const char *first, const char *last) noexcept {
     char buf[64];
 
     do {
+        uint64_t P = 0; // padding of the last block
         if (const size_t diff = last - first; WJR_LIKELY(diff > 64)) {
             for (size_t i = 0; i < u8_loop; ++i) {
                 stk[i] = simd::loadu(first + i * u8_width);
@@ -373,6 +739,7 @@ char *minify(char *dst, const char *first, const char *last) noexcept {
             } else {
                 std::memset(buf, ' ', 64);
                 std::memcpy(buf, first, diff);
+                P = ~0ull << diff;
 
                 for (size_t i = 0; i < u8_loop; ++i) {
                     stk[i] = simd::loadu(buf + i * u8_width);
@@ -426,6 +793,7 @@ char *minify(char *dst, const char *first, const char *last) noexcept {
         const uint64_t R = prefix_xor(Q) ^ prev_in_string;
         prev_in_string = static_cast<uint64_t>(static_cast<int64_t>(R) >> 63);
         W &= ~(R | Q);
+        W |= P;
 
         // this is last block
         if (WJR_UNLIKELY(first == last)) {
@@ -437,6 +805,7 @@ char *minify(char *dst, const char *first, const char *last) noexcept {
             }
 
             std::memcpy(dst, buf, buf_end - buf);
+            dst += buf_end - buf;
             break;
         }
 
@@ -450,6 +819,8 @@ char *minify(char *dst, const char *first, const char *last) noexcept {
     return dst;
 }
 
+    #endif
+
 #endif
 
 } // namespace wjr::json
@@ -0,0 +1,10 @@
+#include <wjr/json/arena_document.hpp>
+
+namespace wjr::json::visitor_detail {
+
+template result<void>
+parse<detail::basic_document_parser<basic_document<detail::arena_document_traits>> &>(
+    detail::basic_document_parser<basic_document<detail::arena_document_traits>> &par,
+    const reader &rd) noexcept;
+
+} // namespace wjr::json::visitor_detail
@@ -0,0 +1,76 @@
+#include <cstring>
+
+#include <wjr/json/chunk_lexer.hpp>
+
+namespace wjr::json {
+
+void chunk_lexer::__lex(const char *first, uint32_t n) noexcept {
+    // Every input given to the lexer but the last one is a multiple of 64
+    // bytes, so rebind() carries the state of the previous blocks.
+    m_lexer.rebind(span<const char>(first, n), m_offset);
+
+    const uint32_t buf_size = std::max<uint32_t>(n / 4, 64);
+    typename lexer::result_type result;
+
+    do {
+        m_tokens.reserve(m_tokens.size() + buf_size + 64);
+        result = m_lexer.read(m_tokens.end_unsafe(), buf_size);
+        m_tokens.get_storage().size() += result.get();
+    } while (!result.done());
+
+    m_offset += n;
+}
+
+void chunk_lexer::feed(span<const char> chunk) noexcept {
+    WJR_ASSERT(!m_finished, "feed() after finish()");
+    WJR_ASSERT(chunk.size() < static_cast<uint32_t>(-1) - size(), "input must be less than 4 GiB");
+
+    const char *first = chunk.data();
+    uint32_t n = static_cast<uint32_t>(chunk.size());
+
+    if (m_tail_size != 0) {
+        const uint32_t m = std::min<uint32_t>(n, 64 - m_tail_size);
+        std::memcpy(m_tail + m_tail_size, first, m);
+        m_tail_size += m;
+        first += m;
+        n -= m;
+
+        if (m_tail_size != 64) {
+            return;
+        }
+
+        m_tail_size = 0;
+        __lex(m_tail, 64);
+    }
+
+    if (const uint32_t m = n & ~63u; m != 0) {
+        __lex(first, m);
+        first += m;
+        n -= m;
+    }
+
+    if (n != 0) {
+        std::memcpy(m_tail, first, n);
+        m_tail_size = n;
+    }
+}
+
+void chunk_lexer::finish() noexcept {
+    WJR_ASSERT(!m_finished, "finish() twice");
+
+    m_finished = true;
+    if (m_tail_size != 0) {
+        const uint32_t n = m_tail_size;
+        m_tail_size = 0;
+        __lex(m_tail, n);
+    }
+}
+
+void chunk_lexer::reset() noexcept {
+    m_lexer = lexer(span<const char>());
+    m_tokens.clear();
+    m_offset = m_tail_size = 0;
+    m_finished = false;
+}
+
+} // namespace wjr::json
@@ -0,0 +1,250 @@
+#include <limits>
+#include <utility>
+
+#include <wjr/json/columnar.hpp>
+
+namespace wjr::json {
+
+namespace columnar_detail {
+
+/**
+ * @brief Write the fields of the objects of the root array into their columns.
+ *
+ * @details m_depth is the number of open containers, the fields of a row are
+ * at depth 2. A column has size() == m_rows once the current row set it.
+ */
+class column_handler {
+public:
+    explicit column_handler(span<column> columns) noexcept : m_columns(columns) {}
+
+    result<void> visit_start_object() noexcept {
+        switch (m_depth) {
+        case 1: {
+            ++m_rows;
+            break;
+        }
+        case 2: {
+            if (WJR_UNLIKELY(take() != nullptr)) {
+                return unexpected(error_code::INCORRECT_TYPE);
+            }
+            break;
+        }
+        default: {
+            if (WJR_UNLIKELY(m_depth == 0)) {
+                return unexpected(error_code::INCORRECT_TYPE);
+            }
+            break;
+        }
+        }
+
+        ++m_depth;
+        return {};
+    }
+
+    void visit_end_object() noexcept {
+        if (--m_depth == 1) {
+            finish_row();
+        }
+    }
+
+    result<void> visit_start_array() noexcept {
+        if (WJR_UNLIKELY(m_depth == 1 || (m_depth == 2 && take() != nullptr))) {
+            return unexpected(error_code::INCORRECT_TYPE);
+        }
+
+        ++m_depth;
+        return {};
+    }
+
+    void visit_end_array() noexcept { --m_depth; }
+
+    void visit_key(std::string_view raw) noexcept {
+        if (m_depth == 2) {
+            m_current = find(raw);
+        }
+    }
+
+    result<void> visit_string(std::string_view raw) noexcept {
+        WJR_EXPECTED_INIT(col, value());
+        if (*col == nullptr) {
+            return {};
+        }
+
+        column &c = **col;
+        if (WJR_UNLIKELY(c.m_type != column_type::string)) {
+            return unexpected(error_code::INCORRECT_TYPE);
+        }
+
+        const size_t size = c.m_chars.size();
+        c.m_chars.resize(size + raw.size(), default_construct);
+        WJR_EXPECTED_INIT(last, sax_decode_string(c.m_chars.data() + size, raw));
+        c.m_chars.resize(static_cast<size_t>(*last - c.m_chars.data()));
+        c.m_offsets.emplace_back(c.m_chars.size());
+        c.m_valid.emplace_back(1);
+        return {};
+    }
+
+    result<void> visit_number(std::string_view raw) noexcept {
+        WJR_EXPECTED_INIT(col, value());
+        if (*col == nullptr) {
+            return {};
+        }
+
+        column &c = **col;
+        if (WJR_UNLIKELY(c.m_type == column_type::string)) {
+            return unexpected(error_code::INCORRECT_TYPE);
+        }
+
+        basic_value val(default_construct);
+        WJR_EXPECTED_TRY(detail::parse_number(raw.data(), raw.data() + raw.size(), val));
+
+        if (c.m_type == column_type::float64) {
+            switch (val.m_type) {
+            case value_t::number_unsigned: {
+                c.m_doubles.emplace_back(static_cast<double>(val.m_number_unsigned));
+                break;
+            }
+            case value_t::number_signed: {
+                c.m_doubles.emplace_back(static_cast<double>(val.m_number_signed));
+                break;
+            }
+            default: {
+                c.m_doubles.emplace_back(val.m_number_float);
+                break;
+            }
+            }
+        } else {
+            switch (val.m_type) {
+            case value_t::number_unsigned: {
+                if (WJR_UNLIKELY(val.m_number_unsigned >
+                                 static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))) {
+                    return unexpected(error_code::NUMBER_OUT_OF_RANGE);
+                }
+
+                c.m_int64s.emplace_back(static_cast<int64_t>(val.m_number_unsigned));
+                break;
+            }
+            case value_t::number_signed: {
+                c.m_int64s.emplace_back(val.m_number_signed);
+                break;
+            }
+            default: {
+                return unexpected(error_code::INCORRECT_TYPE);
+            }
+            }
+        }
+
+        c.m_valid.emplace_back(1);
+        return {};
+    }
+
+    result<void> visit_bool(bool) noexcept {
+        WJR_EXPECTED_INIT(col, value());
+        if (WJR_UNLIKELY(*col != nullptr)) {
+            return unexpected(error_code::INCORRECT_TYPE);
+        }
+
+        return {};
+    }
+
+    // A null field is filled by finish_row, like a missing one.
+    result<void> visit_null() noexcept {
+        WJR_EXPECTED_TRY(value());
+        return {};
+    }
+
+    size_t rows() const noexcept { return m_rows; }
+
+private:
+    column *take() noexcept { return std::exchange(m_current, nullptr); }
+
+    /**
+     * @brief The column of a scalar value, nullptr to skip it.
+     *
+     * @details The root and the elements of the root array must be containers.
+     */
+    result<column *> value() noexcept {
+        if (m_depth == 2) {
+            column *const col = take();
+            // a repeated key keeps its first value
+            if (col != nullptr && col->size() == m_rows) {
+                return nullptr;
+            }
+
+            return col;
+        }
+
+        if (WJR_UNLIKELY(m_depth < 2)) {
+            return unexpected(error_code::INCORRECT_TYPE);
+        }
+
+        return nullptr;
+    }
+
+    column *find(std::string_view raw) noexcept {
+        const size_t n = m_columns.size();
+
+        // Objects usually list their fields in the same order, so the column
+        // after the last match is tried first.
+        for (size_t i = 0; i < n; ++i) {
+            size_t index = m_hint + i;
+            if (index >= n) {
+                index -= n;
+            }
+
+            if (m_columns[index].m_key == raw) {
+                m_hint = index + 1 == n ? 0 : index + 1;
+                return &m_columns[index];
+            }
+        }
+
+        return nullptr;
+    }
+
+    void finish_row() noexcept {
+        for (column &c : m_columns) {
+            if (c.size() == m_rows) {
+                continue;
+            }
+
+            switch (c.m_type) {
+            case column_type::int64: {
+                c.m_int64s.emplace_back(0);
+                break;
+            }
+            case column_type::float64: {
+                c.m_doubles.emplace_back(std::numeric_limits<double>::quiet_NaN());
+                break;
+            }
+            case column_type::string: {
+                c.m_offsets.emplace_back(c.m_chars.size());
+                break;
+            }
+            }
+
+            c.m_valid.emplace_back(0);
+        }
+
+        m_hint = 0;
+    }
+
+    span<column> m_columns;
+    column *m_current = nullptr;
+    size_t m_hint = 0;
+    size_t m_rows = 0;
+    uint32_t m_depth = 0;
+};
+
+} // namespace columnar_detail
+
+result<size_t> extract_columns(const reader &rd, span<column> columns) noexcept {
+    for (column &c : columns) {
+        c.clear();
+    }
+
+    columnar_detail::column_handler handler(columns);
+    WJR_EXPECTED_TRY(sax_parse(rd, handler));
+    return handler.rows();
+}
+
+} // namespace wjr::json
@@ -9,4 +9,11 @@ parse<detail::basic_document_parser<document> &>(detail::basic_document_parser<d
 template result<void> parse<detail::check_parser>(detail::check_parser &&par,
                                                   const reader &rd) noexcept;
 
+template result<void>
+parse<detail::basic_document_parser<document> &>(detail::basic_document_parser<document> &par,
+                                                 stream_reader &rd) noexcept;
+
+template result<void> parse<detail::check_parser>(detail::check_parser &&par,
+                                                  stream_reader &rd) noexcept;
+
 } // namespace wjr::json::visitor_detail
\ No newline at end of file
@@ -0,0 +1,13 @@
+#include <wjr/json/interned_document.hpp>
+
+namespace wjr::json::visitor_detail {
+
+template result<void>
+parse<detail::basic_document_parser<interned_document> &>(
+    detail::basic_document_parser<interned_document> &par, const reader &rd) noexcept;
+
+template result<void>
+parse<detail::basic_document_parser<interned_document> &>(
+    detail::basic_document_parser<interned_document> &par, stream_reader &rd) noexcept;
+
+} // namespace wjr::json::visitor_detail
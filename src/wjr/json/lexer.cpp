@@ -23,15 +23,124 @@ constexpr static std::array<uint8_t, 16 * 8> diff_table = {
     1, 2, 3, 3, 4, 5, 6, 7, 0, 1, 2, 2, 3, 4, 5, 6, 1, 1, 2, 2, 3, 4, 5, 6, 0, 0, 1, 1, 2, 3, 4, 5,
     1, 2, 2, 2, 3, 4, 5, 6, 0, 1, 1, 1, 2, 3, 4, 5, 1, 1, 1, 1, 2, 3, 4, 5, 0, 0, 0, 0, 1, 2, 3, 4};
 
+/**
+ * @brief Classify a block of 64 bytes.
+ *
+ * @param B backslashes.
+ * @param Q quotes.
+ * @param S brackets, commas and colons.
+ * @param W whitespaces.
+ */
+WJR_INTRINSIC_INLINE void classify(const char *ptr, uint64_t &B, uint64_t &Q, uint64_t &S,
+                                   uint64_t &W) noexcept {
+    uint64_t MASK[4][5] = {{0}};
+
+    for (int i = 0; i < 64; i += 4) {
+        MASK[0][code_table[static_cast<uint8_t>(ptr[i])]] |= 1ull << i;
+        MASK[1][code_table[static_cast<uint8_t>(ptr[i + 1])]] |= 1ull << (i + 1);
+        MASK[2][code_table[static_cast<uint8_t>(ptr[i + 2])]] |= 1ull << (i + 2);
+        MASK[3][code_table[static_cast<uint8_t>(ptr[i + 3])]] |= 1ull << (i + 3);
+    }
+
+    B = MASK[0][0] | MASK[1][0] | MASK[2][0] | MASK[3][0];
+    Q = MASK[0][1] | MASK[1][1] | MASK[2][1] | MASK[3][1];
+    W = MASK[0][3] | MASK[1][3] | MASK[2][3] | MASK[3][3];
+    S = MASK[0][2] | MASK[1][2] | MASK[2][2] | MASK[3][2];
+}
+
 } // namespace lexer_detail
 
 #endif
 
 #if !WJR_HAS_BUILTIN(JSON_LEXER_READER_READ_BUF)
 
+namespace lexer_detail {
+
+/**
+ * @brief Validate a block of 64 bytes as UTF-8.
+ *
+ * @param prev_utf8 The last four bytes of the previous block, replaced by the
+ * last four bytes of this one.
+ * @return Whether the block, together with the sequence cut at the end of the
+ * previous block, is invalid.
+ */
+WJR_INTRINSIC_INLINE bool check_utf8(const char *ptr, uint32_t &prev_utf8) noexcept {
+    const uint32_t tail = prev_utf8;
+    prev_utf8 = read_memory<uint32_t>(ptr + 60);
+
+    uint64_t any = 0;
+    for (int i = 0; i < 64; i += 8) {
+        any |= read_memory<uint64_t>(ptr + i);
+    }
+
+    // ASCII only, a sequence cut at the end of the previous block is not finished.
+    if (WJR_LIKELY(!(any & 0x8080808080808080ull))) {
+        return is_incomplete_utf8(tail);
+    }
+
+    // Validate again from the sequence cut at the end of the previous block.
+    uint8_t buf[3 + 64];
+    buf[0] = static_cast<uint8_t>(tail >> 8);
+    buf[1] = static_cast<uint8_t>(tail >> 16);
+    buf[2] = static_cast<uint8_t>(tail >> 24);
+    std::memcpy(buf + 3, ptr, 64);
+
+    int i = 0;
+    while (i < 3 && (buf[i] & 0xC0) == 0x80) {
+        ++i;
+    }
+
+    while (i < 3 + 64) {
+        const uint8_t ch = buf[i];
+        if (ch < 0x80) {
+            ++i;
+            continue;
+        }
+
+        int len;
+        uint8_t lo = 0x80, hi = 0xBF;
+        if (ch < 0xC2) {
+            return true;
+        } else if (ch < 0xE0) {
+            len = 2;
+        } else if (ch < 0xF0) {
+            len = 3;
+            lo = ch == 0xE0 ? 0xA0 : lo;
+            hi = ch == 0xED ? 0x9F : hi;
+        } else if (ch < 0xF5) {
+            len = 4;
+            lo = ch == 0xF0 ? 0x90 : lo;
+            hi = ch == 0xF4 ? 0x8F : hi;
+        } else {
+            return true;
+        }
+
+        // Cut at the end of the block, the next block validates it.
+        if (i + len > 3 + 64) {
+            break;
+        }
+
+        if (buf[i + 1] < lo || buf[i + 1] > hi) {
+            return true;
+        }
+
+        for (int j = 2; j < len; ++j) {
+            if ((buf[i + j] & 0xC0) != 0x80) {
+                return true;
+            }
+        }
+
+        i += len;
+    }
+
+    return false;
+}
+
+} // namespace lexer_detail
+
 typename lexer::result_type lexer::read(uint32_t *token_buf, size_type token_buf_size) noexcept {
     if (WJR_UNLIKELY(first == last)) {
-        return 0;
+        return result_type::mask;
     }
 
     using namespace lexer_detail;
@@ -60,19 +169,12 @@ typename lexer::result_type lexer::read(uint32_t *token_buf, size_type token_buf
             count |= result_type::mask;
         }
 
-        uint64_t MASK[4][5] = {{0}};
+        utf8_error |= check_utf8(ptr, prev_utf8);
 
-        for (int i = 0; i < 64; i += 4) {
-            MASK[0][code_table[static_cast<uint8_t>(ptr[i])]] |= 1ull << i;
-            MASK[1][code_table[static_cast<uint8_t>(ptr[i + 1])]] |= 1ull << (i + 1);
-            MASK[2][code_table[static_cast<uint8_t>(ptr[i + 2])]] |= 1ull << (i + 2);
-            MASK[3][code_table[static_cast<uint8_t>(ptr[i + 3])]] |= 1ull << (i + 3);
-        }
+        uint64_t B, Q, S, W;
+        classify(ptr, B, Q, S, W);
 
-        uint64_t B = MASK[0][0] | MASK[1][0] | MASK[2][0] | MASK[3][0];
-        uint64_t Q = MASK[0][1] | MASK[1][1] | MASK[2][1] | MASK[3][1];
-        uint64_t S = MASK[0][2] | MASK[1][2] | MASK[2][2] | MASK[3][2];
-        uint64_t W = MASK[0][3] | MASK[1][3] | MASK[2][3] | MASK[3][3];
+        const auto WS = S | W;
 
         if (WJR_LIKELY(!B)) {
             B = prev_is_escape;
@@ -88,7 +190,6 @@ typename lexer::result_type lexer::read(uint32_t *token_buf, size_type token_buf
         const uint64_t R = prefix_xor(Q) ^ prev_in_string;
         prev_in_string = static_cast<uint64_t>(static_cast<int64_t>(R) >> 63);
 
-        const auto WS = S | W;
         const auto WT = shld(WS, prev_is_ws, 1);
         prev_is_ws = WS;
 
@@ -164,6 +265,82 @@ typename lexer::result_type lexer::read(uint32_t *token_buf, size_type token_buf
     return count;
 }
 
+namespace lexer_detail {
+
+WJR_INTRINSIC_INLINE void append_tokens(vector<uint32_t> &tokens, uint64_t S,
+                                        uint32_t idx) noexcept {
+    uint32_t *buf = tokens.end_unsafe();
+    tokens.get_storage().size() += popcount(S);
+
+    while (S) {
+        *buf++ = idx + ctz(S);
+        S &= S - 1;
+    }
+}
+
+} // namespace lexer_detail
+
+bool lexer_detail::read_speculative(const char *first, const char *last, uint32_t offset,
+                                    uint64_t prev_is_escape, uint64_t prev_is_ws,
+                                    uint32_t prev_utf8, bool &utf8_error,
+                                    vector<uint32_t> (&tokens)[2]) noexcept {
+    uint64_t prev_in_string = 0;
+    uint32_t idx = offset;
+    char buf[64];
+
+    while (first != last) {
+        const char *ptr;
+
+        if (const size_t diff = last - first; WJR_LIKELY(diff >= 64)) {
+            ptr = first;
+            first += 64;
+        } else {
+            std::memset(buf, ' ', 64);
+            std::memcpy(buf, first, diff);
+            ptr = buf;
+            first = last;
+        }
+
+        uint64_t B, Q, S, W;
+        classify(ptr, B, Q, S, W);
+        utf8_error |= check_utf8(ptr, prev_utf8);
+
+        const auto WS = S | W;
+
+        if (WJR_LIKELY(!B)) {
+            B = prev_is_escape;
+            prev_is_escape = 0;
+        } else {
+            const uint64_t codeB = calc_backslash(B & ~prev_is_escape);
+            const auto escape = (codeB & B) >> 63;
+            B = codeB ^ (B | prev_is_escape);
+            prev_is_escape = escape;
+        }
+
+        Q &= ~B;
+        const uint64_t R = prefix_xor(Q) ^ prev_in_string;
+        prev_in_string = static_cast<uint64_t>(static_cast<int64_t>(R) >> 63);
+
+        const auto WT = shld(WS, prev_is_ws, 1);
+        prev_is_ws = WS;
+
+        S |= WT & ~W;
+
+        // Starting inside a string flips R for the whole part.
+        for (auto &vec : tokens) {
+            if (WJR_UNLIKELY(vec.capacity() - vec.size() < 64)) {
+                vec.reserve(std::max<size_t>(vec.capacity() * 2, 1024));
+            }
+        }
+
+        append_tokens(tokens[0], (S & ~R) | Q, idx);
+        append_tokens(tokens[1], (S & R) | Q, idx);
+        idx += 64;
+    }
+
+    return prev_in_string != 0;
+}
+
 #endif
 
 #if !WJR_HAS_BUILTIN(JSON_MINIFY_BUF)
@@ -183,6 +360,7 @@ char *minify(char *dst, const char *first, const char *last) noexcept {
     char stk[64];
 
     do {
+        uint64_t P = 0; // padding of the last block
         const char *ptr;
 
         if (const size_t diff = last - first; WJR_LIKELY(diff > 64)) {
@@ -194,24 +372,15 @@ char *minify(char *dst, const char *first, const char *last) noexcept {
             } else {
                 std::memset(stk, ' ', 64);
                 std::memcpy(stk, first, diff);
+                P = ~0ull << diff;
                 ptr = stk;
             }
 
             first = last;
         }
 
-        uint64_t MASK[4][5] = {{0}};
-
-        for (int i = 0; i < 64; i += 4) {
-            MASK[0][code_table[static_cast<uint8_t>(ptr[i])]] |= 1ull << i;
-            MASK[1][code_table[static_cast<uint8_t>(ptr[i + 1])]] |= 1ull << (i + 1);
-            MASK[2][code_table[static_cast<uint8_t>(ptr[i + 2])]] |= 1ull << (i + 2);
-            MASK[3][code_table[static_cast<uint8_t>(ptr[i + 3])]] |= 1ull << (i + 3);
-        }
-
-        uint64_t B = MASK[0][0] | MASK[1][0] | MASK[2][0] | MASK[3][0];
-        uint64_t Q = MASK[0][1] | MASK[1][1] | MASK[2][1] | MASK[3][1];
-        uint64_t W = MASK[0][3] | MASK[1][3] | MASK[2][3] | MASK[3][3];
+        uint64_t B, Q, S, W;
+        classify(ptr, B, Q, S, W);
 
         if (WJR_LIKELY(!B)) {
             B = prev_is_escape;
@@ -227,6 +396,7 @@ char *minify(char *dst, const char *first, const char *last) noexcept {
         const uint64_t R = prefix_xor(Q) ^ prev_in_string;
         prev_in_string = static_cast<uint64_t>(static_cast<int64_t>(R) >> 63);
         W &= ~(R | Q);
+        W |= P;
 
         for (int i = 0; i < 64; i += 4) {
             const uint8_t X = (W >> i) & 0x0F;
@@ -0,0 +1,124 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <wjr/json/mapped_file.hpp>
+
+#if defined(WJR_LINUX) || defined(WJR_UNIX)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define WJR_JSON_MMAP
+#endif
+
+namespace wjr::json {
+
+#if defined(WJR_JSON_MMAP)
+
+result<mapped_file> mapped_file::open(const char *path, size_t max_size) noexcept {
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (WJR_UNLIKELY(fd < 0)) {
+        return unexpected(error_code::IO_ERROR);
+    }
+
+    struct stat st;
+    if (WJR_UNLIKELY(::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))) {
+        ::close(fd);
+        return unexpected(error_code::IO_ERROR);
+    }
+
+    const size_t size = static_cast<size_t>(st.st_size);
+    if (WJR_UNLIKELY(size > max_size)) {
+        ::close(fd);
+        return unexpected(error_code::CAPACITY);
+    }
+
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t capacity = (size + padding + page - 1) / page * page;
+
+    // Reserve zero pages for the file and the padding, then put the file over
+    // the first ones. The rest of the last page of the file is zero as well.
+    void *const base =
+        ::mmap(nullptr, capacity, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (WJR_UNLIKELY(base == MAP_FAILED)) {
+        ::close(fd);
+        return unexpected(error_code::IO_ERROR);
+    }
+
+    if (size != 0) {
+        void *const ptr = ::mmap(base, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+        if (WJR_UNLIKELY(ptr == MAP_FAILED)) {
+            ::munmap(base, capacity);
+            ::close(fd);
+            return unexpected(error_code::IO_ERROR);
+        }
+
+        (void)::madvise(base, size, MADV_SEQUENTIAL);
+    }
+
+    ::close(fd);
+    return mapped_file(static_cast<char *>(base), size, capacity);
+}
+
+void mapped_file::close() noexcept {
+    if (m_data != nullptr) {
+        ::munmap(m_data, m_capacity);
+        m_data = nullptr;
+        m_size = m_capacity = 0;
+    }
+}
+
+#else
+
+result<mapped_file> mapped_file::open(const char *path, size_t max_size) noexcept {
+    std::FILE *const file = std::fopen(path, "rb");
+    if (WJR_UNLIKELY(file == nullptr)) {
+        return unexpected(error_code::IO_ERROR);
+    }
+
+    long size = -1;
+    if (std::fseek(file, 0, SEEK_END) == 0) {
+        size = std::ftell(file);
+    }
+
+    if (WJR_UNLIKELY(size < 0 || std::fseek(file, 0, SEEK_SET) != 0)) {
+        std::fclose(file);
+        return unexpected(error_code::IO_ERROR);
+    }
+
+    const size_t n = static_cast<size_t>(size);
+    if (WJR_UNLIKELY(n > max_size)) {
+        std::fclose(file);
+        return unexpected(error_code::CAPACITY);
+    }
+
+    auto *const data = static_cast<char *>(std::malloc(n + padding));
+    if (WJR_UNLIKELY(data == nullptr)) {
+        std::fclose(file);
+        return unexpected(error_code::MEMALLOC);
+    }
+
+    const size_t count = std::fread(data, 1, n, file);
+    std::fclose(file);
+
+    if (WJR_UNLIKELY(count != n)) {
+        std::free(data);
+        return unexpected(error_code::IO_ERROR);
+    }
+
+    std::memset(data + n, 0, padding);
+    return mapped_file(data, n, n + padding);
+}
+
+void mapped_file::close() noexcept {
+    if (m_data != nullptr) {
+        std::free(m_data);
+        m_data = nullptr;
+        m_size = m_capacity = 0;
+    }
+}
+
+#endif
+
+} // namespace wjr::json
@@ -0,0 +1,137 @@
+#include <thread>
+
+#include <wjr/json/reader.hpp>
+#include <wjr/math/literals.hpp>
+#include <wjr/memory/align.hpp>
+
+namespace wjr::json {
+
+namespace {
+
+/// @brief Parts smaller than this are not worth a thread.
+constexpr size_t min_part_size = 256_KB;
+
+struct speculative_part {
+    vector<uint32_t> tokens[2];
+    bool in_string;
+    bool utf8_error;
+    bool start_in_string;
+    size_t offset;
+};
+
+template <typename Func>
+void run_parallel(size_t n, const Func &func) noexcept {
+    vector<std::thread> workers;
+    workers.reserve(n);
+
+    for (size_t i = 1; i < n; ++i) {
+        workers.emplace_back(func, i);
+    }
+
+    func(0);
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+WJR_CONST bool is_whitespace_or_structural(char ch) noexcept {
+    switch (ch) {
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
+    case ',':
+    case ':':
+    case '[':
+    case ']':
+    case '{':
+    case '}': {
+        return true;
+    }
+    default: {
+        return false;
+    }
+    }
+}
+
+} // namespace
+
+void reader::read_parallel(span<const char> sp, unsigned int threads) noexcept {
+    WJR_ASSERT(sp.size() <= std::numeric_limits<size_type>::max());
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    const size_t n = sp.size();
+    const size_t max_parts = std::min<size_t>(threads, n / min_part_size);
+
+    if (max_parts <= 1) {
+        read(sp);
+        return;
+    }
+
+    m_file.reset();
+    m_str = sp;
+
+    const size_t part_size = align_up((n + max_parts - 1) / max_parts, size_t(64));
+    const size_t count = (n + part_size - 1) / part_size;
+    const char *const data = sp.data();
+    vector<speculative_part> parts(count);
+
+    run_parallel(count, [&parts, data, n, part_size](size_t i) {
+        const size_t first = i * part_size;
+        const size_t last = std::min(n, first + part_size);
+
+        // The carry only depends on the bytes just before the part.
+        uint64_t prev_is_escape = 0;
+        uint64_t prev_is_ws = ~0ull;
+        uint32_t prev_utf8 = 0;
+
+        if (first != 0) {
+            size_t pos = first;
+            while (pos != 0 && data[pos - 1] == '\\') {
+                --pos;
+            }
+
+            prev_is_escape = (first - pos) & 1;
+            prev_is_ws = is_whitespace_or_structural(data[first - 1]) ? ~0ull : 0;
+            prev_utf8 = read_memory<uint32_t>(data + first - 4);
+        }
+
+        auto &part = parts[i];
+        part.tokens[0].reserve(part_size / 8);
+        part.tokens[1].reserve(part_size / 8);
+        part.utf8_error = false;
+        part.in_string = lexer_detail::read_speculative(
+            data + first, data + last, static_cast<uint32_t>(first), prev_is_escape, prev_is_ws,
+            prev_utf8, part.utf8_error, part.tokens);
+    });
+
+    bool in_string = false;
+    size_t total = 0;
+    // Every part checks the sequence cut at its beginning, only the end is left.
+    m_valid_utf8 = !lexer_detail::is_incomplete_utf8(read_memory<uint32_t>(data + n - 4));
+
+    for (auto &part : parts) {
+        m_valid_utf8 &= !part.utf8_error;
+        part.start_in_string = in_string;
+        part.offset = total;
+        in_string ^= part.in_string;
+        total += part.tokens[part.start_in_string].size();
+    }
+
+    m_tokens.clear();
+    m_tokens.reserve(total);
+    m_tokens.get_storage().size() = total;
+    uint32_t *const dst = m_tokens.data();
+
+    run_parallel(count, [&parts, dst](size_t i) {
+        const auto &part = parts[i];
+        const auto &tokens = part.tokens[part.start_in_string];
+        std::memcpy(dst + part.offset, tokens.data(), tokens.size() * sizeof(uint32_t));
+    });
+}
+
+} // namespace wjr::json
@@ -0,0 +1,163 @@
+#include <cstdio>
+#include <cstring>
+
+#include <wjr/json/snapshot.hpp>
+
+namespace wjr::json {
+
+namespace snapshot_detail {
+
+static constexpr uint64_t align_words(uint64_t bytes) noexcept {
+    return (bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+}
+
+/// @brief A multiply-xor hash of n words, four lanes at a time.
+static uint64_t checksum(const uint64_t *words, size_t n) noexcept {
+    constexpr uint64_t k0 = 0x9e3779b97f4a7c15;
+    constexpr uint64_t k1 = 0xc2b2ae3d27d4eb4f;
+
+    uint64_t lanes[4] = {k0, k1, ~k0, ~k1};
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        for (int j = 0; j < 4; ++j) {
+            const uint64_t x = (lanes[j] ^ words[i + j]) * k1;
+            lanes[j] = x ^ (x >> 29);
+        }
+    }
+
+    uint64_t h = static_cast<uint64_t>(n) * k0;
+    for (; i < n; ++i) {
+        const uint64_t x = (h ^ words[i]) * k0;
+        h = x ^ (x >> 31);
+    }
+
+    for (int j = 0; j < 4; ++j) {
+        const uint64_t x = (h ^ lanes[j]) * k1;
+        h = x ^ (x >> 29);
+    }
+
+    return h;
+}
+
+} // namespace snapshot_detail
+
+result<vector<char>> tape_snapshot::write(const tape_document &doc) noexcept {
+    using namespace snapshot_detail;
+
+    const auto tape = doc.tape();
+    const auto strings = doc.strings();
+    if (WJR_UNLIKELY(tape.empty())) {
+        return unexpected(error_code::EMPTY);
+    }
+
+    const uint64_t payload = tape.size() + align_words(strings.size());
+    vector<char> image(sizeof(header) + payload * sizeof(uint64_t), default_construct);
+    auto *const words = reinterpret_cast<uint64_t *>(image.data() + sizeof(header));
+
+    std::memcpy(words, tape.data(), tape.size() * sizeof(uint64_t));
+    auto *const str = reinterpret_cast<char *>(words + tape.size());
+    if (!strings.empty()) {
+        std::memcpy(str, strings.data(), strings.size());
+    }
+
+    std::memset(str + strings.size(), 0, align_words(strings.size()) * sizeof(uint64_t) -
+                                             strings.size());
+
+    // Raw numbers point into the input, decode them.
+    const uint32_t size = static_cast<uint32_t>(tape.size());
+    for (uint32_t index = 0; index < size;) {
+        switch (tape_detail::get_type(words[index])) {
+        case tape_detail::number_raw: {
+            const tape_value value(tape.data(), strings.data(), index);
+            uint64_t bits;
+            WJR_EXPECTED_INIT(type, value.__get_number(bits));
+            words[index] = tape_detail::make_word(*type, 0);
+            words[index + 1] = bits;
+            index += 2;
+            break;
+        }
+        case tape_detail::number_unsigned:
+        case tape_detail::number_signed:
+        case tape_detail::number_float: {
+            index += 2;
+            break;
+        }
+        default: {
+            ++index;
+            break;
+        }
+        }
+    }
+
+    header head;
+    std::memcpy(head.magic, magic, sizeof(magic));
+    head.version = version;
+    head.byte_order = byte_order;
+    head.tape_size = tape.size();
+    head.strings_size = strings.size();
+    head.checksum = checksum(words, payload);
+    std::memcpy(image.data(), &head, sizeof(header));
+    return image;
+}
+
+result<void> tape_snapshot::save(const tape_document &doc, const char *path) noexcept {
+    WJR_EXPECTED_INIT(image, write(doc));
+
+    std::FILE *const file = std::fopen(path, "wb");
+    if (WJR_UNLIKELY(file == nullptr)) {
+        return unexpected(error_code::IO_ERROR);
+    }
+
+    const size_t count = std::fwrite(image->data(), 1, image->size(), file);
+    if (WJR_UNLIKELY((std::fclose(file) != 0) | (count != image->size()))) {
+        return unexpected(error_code::IO_ERROR);
+    }
+
+    return {};
+}
+
+result<tape_snapshot> tape_snapshot::view(span<const char> image, bool verify) noexcept {
+    using namespace snapshot_detail;
+
+    if (WJR_UNLIKELY(image.size() < sizeof(header) ||
+                     reinterpret_cast<uintptr_t>(image.data()) % alignof(uint64_t) != 0)) {
+        return unexpected(error_code::SNAPSHOT_ERROR);
+    }
+
+    header head;
+    std::memcpy(&head, image.data(), sizeof(header));
+    if (WJR_UNLIKELY(std::memcmp(head.magic, magic, sizeof(magic)) != 0 ||
+                     head.version != version || head.byte_order != byte_order)) {
+        return unexpected(error_code::SNAPSHOT_ERROR);
+    }
+
+    // Tape indices are 32 bits, which also keeps the sums below from overflowing.
+    const size_t words = (image.size() - sizeof(header)) / sizeof(uint64_t);
+    if (WJR_UNLIKELY(head.tape_size == 0 || head.tape_size > UINT32_MAX ||
+                     head.strings_size > UINT32_MAX * sizeof(uint64_t) ||
+                     (image.size() - sizeof(header)) % sizeof(uint64_t) != 0 ||
+                     head.tape_size + align_words(head.strings_size) != words)) {
+        return unexpected(error_code::SNAPSHOT_ERROR);
+    }
+
+    const auto *const tape = reinterpret_cast<const uint64_t *>(image.data() + sizeof(header));
+    if (verify && WJR_UNLIKELY(checksum(tape, words) != head.checksum)) {
+        return unexpected(error_code::SNAPSHOT_ERROR);
+    }
+
+    return tape_snapshot(tape, static_cast<size_t>(head.tape_size),
+                         reinterpret_cast<const char *>(tape + head.tape_size),
+                         static_cast<size_t>(head.strings_size));
+}
+
+result<tape_snapshot> tape_snapshot::open(const char *path, bool verify) noexcept {
+    WJR_EXPECTED_INIT(file, mapped_file::open(path));
+
+    auto ptr = std::make_shared<const mapped_file>(std::move(*file));
+    WJR_EXPECTED_INIT(snapshot, view(*ptr, verify));
+
+    snapshot->m_file = std::move(ptr);
+    return std::move(*snapshot);
+}
+
+} // namespace wjr::json
@@ -0,0 +1,9 @@
+#include <wjr/json/tape_document.hpp>
+
+namespace wjr::json::visitor_detail {
+
+template result<void>
+parse<detail::tape_document_parser &>(detail::tape_document_parser &par,
+                                      const reader &rd) noexcept;
+
+} // namespace wjr::json::visitor_detail
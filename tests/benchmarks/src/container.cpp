@@ -1,5 +1,7 @@
 #include "detail.hpp"
 
+#include <wjr/container/btree_map.hpp>
+#include <wjr/container/flat_hash_map.hpp>
 #include <wjr/vector.hpp>
 
 using namespace wjr;
@@ -68,6 +70,62 @@ static void wjr_vector_emplace_back(benchmark::State &state) {
     }
 }
 
+// keys like the fields of a wide JSON object
+static vector<std::string> make_map_keys(size_t n) {
+    vector<std::string> keys;
+    for (size_t i = 0; i < n; ++i) {
+        keys.emplace_back("field_name_" + std::to_string(i * 7919 % n));
+    }
+
+    return keys;
+}
+
+struct string_map_hash {
+    using is_transparent = void;
+    size_t operator()(std::string_view str) const noexcept {
+        return std::hash<std::string_view>()(str);
+    }
+};
+
+template <typename Map>
+static void wjr_map_find_string(benchmark::State &state) {
+    const auto keys = make_map_keys(state.range(0));
+    Map map;
+    for (const auto &key : keys) {
+        map.try_emplace(key, 0);
+    }
+
+    for (auto _ : state) {
+        size_t sum = 0;
+        for (const auto &key : keys) {
+            sum += map.count(key);
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Map>
+static void wjr_map_emplace_string(benchmark::State &state) {
+    const auto keys = make_map_keys(state.range(0));
+
+    for (auto _ : state) {
+        Map map;
+        for (const auto &key : keys) {
+            map.try_emplace(key, 0);
+        }
+
+        benchmark::DoNotOptimize(map);
+    }
+
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+using string_btree_map = btree_map<std::string, int, std::less<>>;
+using string_flat_hash_map = flat_hash_map<std::string, int, string_map_hash, std::equal_to<>>;
+
 BENCHMARK(wjr_vector_default_construct<int>);
 BENCHMARK(wjr_vector_default_construct<double>);
 BENCHMARK(wjr_vector_default_construct<std::string>);
@@ -92,3 +150,8 @@ BENCHMARK(wjr_vector_move_construct<std::string>)->NORMAL_TESTS(1, 2, 1 << 6);
 BENCHMARK(wjr_vector_emplace_back<int>)->NORMAL_TESTS(1, 2, 1 << 6);
 BENCHMARK(wjr_vector_emplace_back<double>)->NORMAL_TESTS(1, 2, 1 << 6);
 BENCHMARK(wjr_vector_emplace_back<std::string>)->NORMAL_TESTS(1, 2, 1 << 6);
+
+BENCHMARK(wjr_map_find_string<string_btree_map>)->RangeMultiplier(4)->Range(4, 1024);
+BENCHMARK(wjr_map_find_string<string_flat_hash_map>)->RangeMultiplier(4)->Range(4, 1024);
+BENCHMARK(wjr_map_emplace_string<string_btree_map>)->RangeMultiplier(4)->Range(4, 1024);
+BENCHMARK(wjr_map_emplace_string<string_flat_hash_map>)->RangeMultiplier(4)->Range(4, 1024);
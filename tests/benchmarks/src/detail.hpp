@@ -1,3 +1,4 @@
+#include <ctime>
 #include <functional>
 #include <random>
 
@@ -0,0 +1,820 @@
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "detail.hpp"
+
+#include <wjr/json/arena_document.hpp>
+#include <wjr/json/chunk_lexer.hpp>
+#include <wjr/json/columnar.hpp>
+#include <wjr/json/deserializer.hpp>
+#include <wjr/json/document.hpp>
+#include <wjr/json/hash_document.hpp>
+#include <wjr/json/interned_document.hpp>
+#include <wjr/json/ndjson.hpp>
+#include <wjr/json/ondemand.hpp>
+#include <wjr/json/parser.hpp>
+#include <wjr/json/patch.hpp>
+#include <wjr/json/query.hpp>
+#include <wjr/json/sax.hpp>
+#include <wjr/json/serializer.hpp>
+#include <wjr/json/shared_document.hpp>
+#include <wjr/json/snapshot.hpp>
+#include <wjr/json/tape_document.hpp>
+#include <wjr/json/view_document.hpp>
+
+using namespace wjr;
+
+static const auto current_path = std::filesystem::current_path();
+static const auto twitter_json = []() {
+    std::ifstream input(current_path / "../../units/src/data/success/twitter.json");
+    std::stringstream buffer;
+    buffer << input.rdbuf();
+    return std::move(buffer).str();
+}();
+
+// statuses of twitter.json, one per line, repeated to about 64 MB
+static const std::string &get_twitter_ndjson() {
+    // The lexer's tables may not be initialized yet during static initialization.
+    static const std::string str = []() {
+        json::reader rd(twitter_json);
+        auto doc = json::document::parse(rd);
+        std::string lines;
+        for (auto &status : (*doc).at(std::string("statuses")).template get<json::array_t>()) {
+            lines += status.to_string();
+            lines += '\n';
+        }
+
+        std::string ret;
+        while (ret.size() < 64_MB) {
+            ret += lines;
+        }
+
+        return ret;
+    }();
+
+    return str;
+}
+
+// every object nested in a status of twitter.json, each one a document
+static const vector<std::string> &get_small_documents() {
+    static const vector<std::string> docs = []() {
+        json::reader rd(twitter_json);
+        auto doc = json::document::parse(rd);
+        vector<std::string> ret;
+        for (auto &status : (*doc).at(std::string("statuses")).template get<json::array_t>()) {
+            for (auto &[key, value] : status.template get<json::object_t>()) {
+                if (value.is_object()) {
+                    ret.emplace_back(value.to_string());
+                }
+            }
+        }
+
+        return ret;
+    }();
+
+    return docs;
+}
+
+// polygons of coordinate pairs like canada.json, about 2 MB of numbers
+static const std::string &get_coordinates_json() {
+    static const std::string str = []() {
+        std::mt19937_64 rng(0);
+        std::uniform_real_distribution<double> lon(-141.0, -52.0), lat(41.0, 83.0);
+        std::string ret = R"({"type":"Polygon","coordinates":[)";
+        char buf[64];
+
+        for (int i = 0; i < 100; ++i) {
+            ret += i == 0 ? "[" : ",[";
+            for (int j = 0; j < 1000; ++j) {
+                const int n = std::snprintf(buf, sizeof(buf), "%s[%.15g,%.15g]", j == 0 ? "" : ",",
+                                            lon(rng), lat(rng));
+                ret.append(buf, n);
+            }
+            ret += ']';
+        }
+
+        ret += "]}";
+        return ret;
+    }();
+
+    return str;
+}
+
+static const std::string &get_rows_json() {
+    static const std::string str = []() {
+        std::mt19937_64 rng(0);
+        std::uniform_real_distribution<double> v(-100.0, 100.0);
+        std::string ret = "[";
+        char buf[128];
+
+        for (int i = 0; i < 100000; ++i) {
+            const int n = std::snprintf(buf, sizeof(buf),
+                                        R"(%s{"ts":%d,"v":%.15g,"host":"host-%d","ok":true})",
+                                        i == 0 ? "" : ",", 1700000000 + i, v(rng), i % 16);
+            ret.append(buf, n);
+        }
+
+        ret += ']';
+        return ret;
+    }();
+
+    return str;
+}
+
+static void wjr_json_reader_read_twitter(benchmark::State &state) {
+    json::reader rd;
+
+    for (auto _ : state) {
+        rd.read(twitter_json);
+        benchmark::DoNotOptimize(rd);
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+static void wjr_json_chunk_lexer_twitter(benchmark::State &state) {
+    const auto chunk = static_cast<size_t>(state.range(0));
+    json::chunk_lexer lex;
+
+    for (auto _ : state) {
+        lex.reset();
+        for (size_t pos = 0; pos < twitter_json.size(); pos += chunk) {
+            lex.feed(span<const char>(twitter_json.data() + pos,
+                                      std::min(chunk, twitter_json.size() - pos)));
+        }
+
+        lex.finish();
+        benchmark::DoNotOptimize(lex);
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+// twitter.json repeated in an array to about 64 MB
+static const std::string &get_large_json() {
+    static const std::string str = []() {
+        std::string ret = "[";
+        while (ret.size() < 64_MB) {
+            ret += twitter_json;
+            ret += ',';
+        }
+
+        ret.back() = ']';
+        return ret;
+    }();
+
+    return str;
+}
+
+static void wjr_json_reader_read_large(benchmark::State &state) {
+    const auto &large_json = get_large_json();
+    json::reader rd;
+
+    for (auto _ : state) {
+        rd.read(large_json);
+        benchmark::DoNotOptimize(rd);
+    }
+
+    state.SetBytesProcessed(state.iterations() * large_json.size());
+}
+
+// get_large_json() written to a temporary file
+static const std::string &get_large_json_path() {
+    static const std::string path = []() {
+        const auto ret = std::filesystem::temp_directory_path() / "wjr_json_large.json";
+        std::ofstream output(ret, std::ios::binary);
+        output << get_large_json();
+        return ret.string();
+    }();
+
+    return path;
+}
+
+static void wjr_json_reader_load_and_read_large(benchmark::State &state) {
+    const auto &path = get_large_json_path();
+    json::reader rd;
+    size_t bytes = 0;
+
+    for (auto _ : state) {
+        std::ifstream input(path, std::ios::binary);
+        std::string str(std::filesystem::file_size(path), '\0');
+        input.read(str.data(), str.size());
+        rd.read(str);
+        benchmark::DoNotOptimize(rd);
+        bytes += str.size();
+    }
+
+    state.SetBytesProcessed(bytes);
+}
+
+static void wjr_json_reader_read_file_large(benchmark::State &state) {
+    const auto &path = get_large_json_path();
+    json::reader rd;
+    size_t bytes = 0;
+
+    for (auto _ : state) {
+        (void)rd.read_file(path.c_str());
+        benchmark::DoNotOptimize(rd);
+        bytes += rd.size();
+    }
+
+    state.SetBytesProcessed(bytes);
+}
+
+static void wjr_json_reader_read_parallel_large(benchmark::State &state) {
+    const auto &large_json = get_large_json();
+    json::reader rd;
+
+    for (auto _ : state) {
+        rd.read_parallel(large_json, state.range(0));
+        benchmark::DoNotOptimize(rd);
+    }
+
+    state.SetBytesProcessed(state.iterations() * large_json.size());
+}
+
+static void wjr_json_minify_twitter(benchmark::State &state) {
+    std::string buf(twitter_json.size() + 64, '\0');
+
+    for (auto _ : state) {
+        const char *const first = twitter_json.data();
+        benchmark::DoNotOptimize(json::minify(buf.data(), first, first + twitter_json.size()));
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+static void wjr_json_document_parse_twitter(benchmark::State &state) {
+    json::reader rd;
+
+    for (auto _ : state) {
+        rd.read(twitter_json);
+        auto doc = json::document::parse(rd);
+        benchmark::DoNotOptimize(doc);
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+static void wjr_json_view_document_parse_twitter(benchmark::State &state) {
+    json::reader rd;
+
+    for (auto _ : state) {
+        rd.read(twitter_json);
+        auto doc = json::view_document::parse(rd);
+        benchmark::DoNotOptimize(doc);
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+static void wjr_json_hash_document_parse_twitter(benchmark::State &state) {
+    json::reader rd;
+
+    for (auto _ : state) {
+        rd.read(twitter_json);
+        auto doc = json::hash_document::parse(rd);
+        benchmark::DoNotOptimize(doc);
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+static void wjr_json_interned_document_parse_twitter(benchmark::State &state) {
+    json::reader rd;
+
+    for (auto _ : state) {
+        rd.read(twitter_json);
+        auto doc = json::interned_document::parse(rd);
+        benchmark::DoNotOptimize(doc);
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+// the pool is shared by every parsed document
+static void wjr_json_interned_document_parse_twitter_with_pool(benchmark::State &state) {
+    json::reader rd;
+    json::key_pool pool;
+
+    for (auto _ : state) {
+        rd.read(twitter_json);
+        auto doc = json::interned_document::parse(rd, pool);
+        benchmark::DoNotOptimize(doc);
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+static void wjr_json_document_parse_small(benchmark::State &state) {
+    const auto &docs = get_small_documents();
+    size_t bytes = 0;
+
+    for (auto _ : state) {
+        for (const auto &str : docs) {
+            json::reader rd(str);
+            auto doc = json::document::parse(rd);
+            benchmark::DoNotOptimize(doc);
+            bytes += str.size();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * docs.size());
+    state.SetBytesProcessed(bytes);
+}
+
+static void wjr_json_parser_parse_small(benchmark::State &state) {
+    const auto &docs = get_small_documents();
+    json::parser par;
+    size_t bytes = 0;
+
+    for (auto _ : state) {
+        for (const auto &str : docs) {
+            auto doc = par.parse(str);
+            benchmark::DoNotOptimize(doc);
+            bytes += str.size();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * docs.size());
+    state.SetBytesProcessed(bytes);
+}
+
+static void wjr_json_stream_document_parse_twitter(benchmark::State &state) {
+    json::stream_reader rd(twitter_json, state.range(0));
+
+    for (auto _ : state) {
+        rd.reset();
+        auto doc = json::document::parse(rd);
+        benchmark::DoNotOptimize(doc);
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+static void wjr_json_arena_document_parse_twitter(benchmark::State &state) {
+    json::reader rd;
+
+    for (auto _ : state) {
+        rd.read(twitter_json);
+        auto doc = json::arena_document::parse(rd);
+        benchmark::DoNotOptimize(doc);
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+// keep the arena between iterations
+static void wjr_json_arena_document_reread_twitter(benchmark::State &state) {
+    json::reader rd;
+    json::arena_document doc;
+
+    for (auto _ : state) {
+        rd.read(twitter_json);
+        (void)doc.read(rd);
+        benchmark::DoNotOptimize(doc);
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+static void wjr_json_tape_document_parse_twitter(benchmark::State &state) {
+    json::reader rd;
+
+    for (auto _ : state) {
+        rd.read(twitter_json);
+        auto doc = json::tape_document::parse(rd);
+        benchmark::DoNotOptimize(doc);
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+// count the values and sum the "retweet_count" fields
+static void wjr_json_sax_sum_twitter(benchmark::State &state) {
+    struct sum_handler {
+        bool is_retweet_count = false;
+        uint64_t values = 0;
+        uint64_t sum = 0;
+
+        void visit_key(std::string_view key) { is_retweet_count = key == "retweet_count"; }
+        void visit_string(std::string_view) { ++values; }
+        void visit_null() { ++values; }
+        void visit_bool(bool) { ++values; }
+
+        json::result<void> visit_number(std::string_view raw) {
+            ++values;
+            if (is_retweet_count) {
+                WJR_EXPECTED_INIT(value, json::sax_decode_number(raw));
+                sum += value->m_number_unsigned;
+            }
+
+            return {};
+        }
+    };
+
+    json::reader rd;
+
+    for (auto _ : state) {
+        rd.read(twitter_json);
+        sum_handler handler;
+        auto ret = json::sax_parse(rd, handler);
+        benchmark::DoNotOptimize(ret);
+        benchmark::DoNotOptimize(handler.sum);
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+static void wjr_json_tape_document_parse_lazy_twitter(benchmark::State &state) {
+    json::reader rd;
+
+    for (auto _ : state) {
+        rd.read(twitter_json);
+        auto doc = json::tape_document::parse(rd, json::lazy_numbers);
+        benchmark::DoNotOptimize(doc);
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+template <bool Lazy>
+static void wjr_json_tape_document_parse_coordinates(benchmark::State &state) {
+    const auto &str = get_coordinates_json();
+    json::reader rd;
+
+    for (auto _ : state) {
+        rd.read(str);
+        if constexpr (Lazy) {
+            auto doc = json::tape_document::parse(rd, json::lazy_numbers);
+            benchmark::DoNotOptimize(doc);
+        } else {
+            auto doc = json::tape_document::parse(rd);
+            benchmark::DoNotOptimize(doc);
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+template <bool Verify>
+static void wjr_json_tape_snapshot_open_twitter(benchmark::State &state) {
+    json::reader rd(twitter_json);
+    const auto path = std::filesystem::temp_directory_path() / "wjr_json_bench.snapshot";
+    (void)json::tape_snapshot::save(*json::tape_document::parse(rd), path.string().c_str());
+
+    for (auto _ : state) {
+        auto snap = json::tape_snapshot::open(path.string().c_str(), Verify);
+        auto root = snap->root();
+        benchmark::DoNotOptimize(root);
+    }
+
+    std::filesystem::remove(path);
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+static void wjr_json_ndjson_parse(benchmark::State &state) {
+    const auto &twitter_ndjson = get_twitter_ndjson();
+
+    for (auto _ : state) {
+        auto results = json::parse_ndjson(twitter_ndjson, state.range(0));
+        benchmark::DoNotOptimize(results);
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_ndjson.size());
+}
+
+// read a few fields of every status
+static void wjr_json_document_find_twitter(benchmark::State &state) {
+    json::reader rd;
+    const std::string statuses = "statuses", id = "id", text = "text", user = "user",
+                      screen_name = "screen_name";
+
+    for (auto _ : state) {
+        rd.read(twitter_json);
+        auto doc = json::document::parse(rd);
+        uint64_t sum = 0;
+        size_t length = 0;
+
+        for (auto &status : (*doc).at(statuses).template get<json::array_t>()) {
+            sum += (uint64_t)status.at(id);
+            length += ((std::string_view)status.at(text)).size();
+            length += ((std::string_view)status.at(user).at(screen_name)).size();
+        }
+
+        benchmark::DoNotOptimize(sum);
+        benchmark::DoNotOptimize(length);
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+// an object with state.range(0) fields, every field is looked up once
+template <typename Document>
+static void wjr_json_find_wide_object(benchmark::State &state) {
+    const size_t n = state.range(0);
+    std::string str = "{";
+    vector<std::string> keys;
+
+    for (size_t i = 0; i < n; ++i) {
+        keys.emplace_back("field_name_" + std::to_string(i * 7919 % n));
+        str += '\"' + keys.back() + "\":" + std::to_string(i) + ',';
+    }
+
+    str.back() = '}';
+
+    json::reader rd(str);
+    auto doc = Document::parse(rd).value();
+
+    for (auto _ : state) {
+        uint64_t sum = 0;
+        for (const auto &key : keys) {
+            sum += (uint64_t)doc.at(key);
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// a copy per request of a base document, with one value modified
+template <typename Document>
+static void wjr_json_copy_and_modify_twitter(benchmark::State &state) {
+    json::reader rd(twitter_json);
+    const auto base = Document::parse(rd).value();
+    const std::string search_metadata = "search_metadata", count = "count";
+
+    for (auto _ : state) {
+        Document doc = base;
+        doc[search_metadata][count] = 1;
+        benchmark::DoNotOptimize(doc);
+    }
+}
+
+// a small patch applied to a large document, only the paths it names are visited
+static void wjr_json_apply_merge_patch_twitter(benchmark::State &state) {
+    json::reader rd(twitter_json);
+    auto doc = json::document::parse(rd).value();
+    rd.read(R"({"search_metadata":{"count":1,"next_results":null},"extra":{"a":[1,2]}})");
+    const auto patch = json::document::parse(rd).value();
+
+    for (auto _ : state) {
+        json::apply_merge_patch(doc, patch);
+        benchmark::DoNotOptimize(doc);
+    }
+}
+
+static void wjr_json_apply_patch_twitter(benchmark::State &state) {
+    json::reader rd(twitter_json);
+    auto doc = json::document::parse(rd).value();
+    rd.read(R"([{"op":"replace","path":"/search_metadata/count","value":1},
+                {"op":"move","from":"/statuses/0/user","path":"/statuses/1/owner"},
+                {"op":"move","from":"/statuses/1/owner","path":"/statuses/0/user"},
+                {"op":"test","path":"/search_metadata/count","value":1}])");
+    const auto patch = json::document::parse(rd).value();
+
+    for (auto _ : state) {
+        auto ret = json::apply_patch(doc, patch);
+        benchmark::DoNotOptimize(ret);
+    }
+}
+
+static void wjr_json_query_find_twitter(benchmark::State &state) {
+    json::reader rd;
+    const auto ids = json::query::path("$.statuses[*].id").value();
+    const auto texts = json::query::path("$.statuses[*].text").value();
+    const auto names = json::query::path("$.statuses[*].user.screen_name").value();
+
+    for (auto _ : state) {
+        rd.read(twitter_json);
+        json::ondemand::document doc(rd);
+        uint64_t sum = 0;
+        size_t length = 0;
+
+        (void)ids.for_each(doc, [&sum](json::ondemand::value val) { sum += *val.get_uint64(); });
+        (void)texts.for_each(
+            doc, [&length](json::ondemand::value val) { length += val.get_string_view()->size(); });
+        (void)names.for_each(
+            doc, [&length](json::ondemand::value val) { length += val.get_string_view()->size(); });
+
+        benchmark::DoNotOptimize(sum);
+        benchmark::DoNotOptimize(length);
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+struct twitter_user {
+    WJR_ENABLE_DEFAULT_SPECIAL_MEMBERS(twitter_user);
+
+    WJR_REGISTER_DOCUMENT_OBJECT_SERIALIZER(twitter_user, id, screen_name, followers_count)
+
+    uint64_t id = 0;
+    std::string screen_name;
+    uint64_t followers_count = 0;
+};
+
+struct twitter_status {
+    WJR_ENABLE_DEFAULT_SPECIAL_MEMBERS(twitter_status);
+
+    WJR_REGISTER_DOCUMENT_OBJECT_SERIALIZER(twitter_status, id, text, user, retweet_count)
+
+    uint64_t id = 0;
+    std::string text;
+    twitter_user user;
+    uint64_t retweet_count = 0;
+};
+
+struct twitter_statuses {
+    WJR_ENABLE_DEFAULT_SPECIAL_MEMBERS(twitter_statuses);
+
+    WJR_REGISTER_DOCUMENT_OBJECT_SERIALIZER(twitter_statuses, statuses)
+
+    vector<twitter_status> statuses;
+};
+
+static void wjr_json_document_construct_twitter(benchmark::State &state) {
+    json::reader rd;
+
+    for (auto _ : state) {
+        rd.read(twitter_json);
+        auto doc = json::document::parse(rd);
+        twitter_statuses val(std::move(*doc), json::in_place_document_serializer_from);
+        benchmark::DoNotOptimize(val);
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+static void wjr_json_deserialize_twitter(benchmark::State &state) {
+    json::reader rd;
+
+    for (auto _ : state) {
+        rd.read(twitter_json);
+        auto val = json::deserialize<twitter_statuses>(rd);
+        benchmark::DoNotOptimize(val);
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+static const twitter_statuses &get_twitter_statuses() {
+    static const twitter_statuses val = []() {
+        json::reader rd(twitter_json);
+        return json::deserialize<twitter_statuses>(rd).value();
+    }();
+
+    return val;
+}
+
+static void wjr_json_document_dump_struct_twitter(benchmark::State &state) {
+    const auto &val = get_twitter_statuses();
+    std::string str;
+
+    for (auto _ : state) {
+        str.clear();
+        json::document doc(val);
+        doc.dump_impl(str);
+        benchmark::DoNotOptimize(str);
+    }
+
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+static void wjr_json_extract_columns_rows(benchmark::State &state) {
+    const auto &str = get_rows_json();
+    json::reader rd(str);
+    json::column cols[] = {{"ts", json::column_type::int64},
+                           {"v", json::column_type::float64},
+                           {"host", json::column_type::string}};
+
+    for (auto _ : state) {
+        auto rows = json::extract_columns(rd, cols);
+        benchmark::DoNotOptimize(rows);
+    }
+
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+static void wjr_json_document_columns_rows(benchmark::State &state) {
+    const auto &str = get_rows_json();
+    json::reader rd(str);
+    vector<int64_t> ts;
+    vector<double> v;
+    vector<std::string_view> host;
+
+    for (auto _ : state) {
+        ts.clear();
+        v.clear();
+        host.clear();
+        auto doc = json::document::parse(rd);
+        for (auto &row : doc->get<json::array_t>()) {
+            auto &obj = row.get<json::object_t>();
+            ts.emplace_back(obj.at(std::string("ts")).get<json::number_unsigned_t>());
+            v.emplace_back(obj.at(std::string("v")).get<json::number_float_t>());
+            host.emplace_back(obj.at(std::string("host")).get<json::string_t>());
+        }
+
+        benchmark::DoNotOptimize(ts);
+    }
+
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+template <unsigned Indents>
+static void wjr_json_document_dump_twitter(benchmark::State &state) {
+    json::reader rd(twitter_json);
+    const auto doc = *json::document::parse(rd);
+    std::string str;
+
+    for (auto _ : state) {
+        str.clear();
+        doc.dump_impl(str, Indents);
+        benchmark::DoNotOptimize(str);
+    }
+
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+static void wjr_json_serialize_twitter(benchmark::State &state) {
+    const auto &val = get_twitter_statuses();
+    std::string str;
+
+    for (auto _ : state) {
+        str.clear();
+        json::serialize(val, str);
+        benchmark::DoNotOptimize(str);
+    }
+
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+static void wjr_json_ondemand_find_twitter(benchmark::State &state) {
+    json::reader rd;
+
+    for (auto _ : state) {
+        rd.read(twitter_json);
+        json::ondemand::document doc(rd);
+        uint64_t sum = 0;
+        size_t length = 0;
+
+        const auto statuses = doc["statuses"]->get_array();
+
+        for (auto status : *statuses) {
+            auto obj = *status.get_object();
+            sum += *obj.find_field("id")->get_uint64();
+            length += obj.find_field("text")->get_string_view()->size();
+            length += (*obj.find_field("user"))["screen_name"]->get_string_view()->size();
+        }
+
+        benchmark::DoNotOptimize(sum);
+        benchmark::DoNotOptimize(length);
+    }
+
+    state.SetBytesProcessed(state.iterations() * twitter_json.size());
+}
+
+BENCHMARK(wjr_json_reader_read_twitter);
+BENCHMARK(wjr_json_chunk_lexer_twitter)->Arg(1500)->Arg(16384);
+BENCHMARK(wjr_json_reader_read_large);
+BENCHMARK(wjr_json_reader_load_and_read_large);
+BENCHMARK(wjr_json_reader_read_file_large);
+BENCHMARK(wjr_json_reader_read_parallel_large)->DenseRange(1, 16)->UseRealTime();
+BENCHMARK(wjr_json_minify_twitter);
+BENCHMARK(wjr_json_document_parse_twitter);
+BENCHMARK(wjr_json_view_document_parse_twitter);
+BENCHMARK(wjr_json_hash_document_parse_twitter);
+BENCHMARK(wjr_json_interned_document_parse_twitter);
+BENCHMARK(wjr_json_interned_document_parse_twitter_with_pool);
+BENCHMARK(wjr_json_document_parse_small);
+BENCHMARK(wjr_json_parser_parse_small);
+BENCHMARK(wjr_json_stream_document_parse_twitter)->Arg(4096)->Arg(1 << 20);
+BENCHMARK(wjr_json_arena_document_parse_twitter);
+BENCHMARK(wjr_json_arena_document_reread_twitter);
+BENCHMARK(wjr_json_tape_document_parse_twitter);
+BENCHMARK(wjr_json_tape_document_parse_lazy_twitter);
+BENCHMARK(wjr_json_tape_document_parse_coordinates<false>);
+BENCHMARK(wjr_json_tape_document_parse_coordinates<true>);
+BENCHMARK(wjr_json_tape_snapshot_open_twitter<false>);
+BENCHMARK(wjr_json_tape_snapshot_open_twitter<true>);
+BENCHMARK(wjr_json_sax_sum_twitter);
+BENCHMARK(wjr_json_extract_columns_rows);
+BENCHMARK(wjr_json_document_columns_rows);
+BENCHMARK(wjr_json_ndjson_parse)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+BENCHMARK(wjr_json_document_find_twitter);
+BENCHMARK(wjr_json_find_wide_object<json::document>)->RangeMultiplier(4)->Range(4, 1024);
+BENCHMARK(wjr_json_find_wide_object<json::hash_document>)->RangeMultiplier(4)->Range(4, 1024);
+BENCHMARK(wjr_json_copy_and_modify_twitter<json::document>);
+BENCHMARK(wjr_json_copy_and_modify_twitter<json::shared_document>);
+BENCHMARK(wjr_json_apply_merge_patch_twitter);
+BENCHMARK(wjr_json_apply_patch_twitter);
+BENCHMARK(wjr_json_query_find_twitter);
+BENCHMARK(wjr_json_ondemand_find_twitter);
+BENCHMARK(wjr_json_document_construct_twitter);
+BENCHMARK(wjr_json_deserialize_twitter);
+BENCHMARK(wjr_json_document_dump_struct_twitter);
+BENCHMARK(wjr_json_document_dump_twitter<-1u>);
+BENCHMARK(wjr_json_document_dump_twitter<4>);
+BENCHMARK(wjr_json_serialize_twitter);
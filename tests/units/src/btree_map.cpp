@@ -84,4 +84,49 @@ TEST(btree_map, emplace) {
         test(int(0), int(0));
         test(std::string(), std::string());
     }
-}
\ No newline at end of file
+}
+
+TEST(btree_map, erase) {
+    {
+        auto test = [](auto key, auto value) {
+            using key_type = remove_cvref_t<decltype(key)>;
+            using value_type = remove_cvref_t<decltype(value)>;
+            for (int n = 0; n < 1024; n = (n << 1) | 1) {
+                vector<std::pair<key_type, value_type>> vec;
+                for (int i = 0; i < n; ++i) {
+                    vec.emplace_back(trandom<key_type>(), trandom<value_type>());
+                }
+
+                btree_map<key_type, value_type> map(vec.begin(), vec.end());
+                std::map<key_type, value_type> std_map(vec.begin(), vec.end());
+
+                // erase every other element, then the rest in key order
+                for (int round = 0; round < 2; ++round) {
+                    auto iter = map.cbegin();
+                    auto std_iter = std_map.begin();
+                    bool flag = round == 1;
+                    while (iter != map.cend()) {
+                        if (flag) {
+                            iter = map.erase(iter);
+                            std_iter = std_map.erase(std_iter);
+                        } else {
+                            ++iter;
+                            ++std_iter;
+                        }
+
+                        flag = round == 1 || !flag;
+                    }
+
+                    WJR_ASSERT_L0(map.size() == std_map.size());
+                    WJR_ASSERT_L0(
+                        std::equal(map.begin(), map.end(), std_map.begin(), std_map.end()));
+                }
+
+                WJR_ASSERT_L0(map.empty());
+            }
+        };
+
+        test(int(0), int(0));
+        test(std::string(), std::string());
+    }
+}
@@ -0,0 +1,192 @@
+#include "random.hpp"
+
+#include <unordered_map>
+
+#include <wjr/container/flat_hash_map.hpp>
+#include <wjr/container/vector.hpp>
+
+using namespace wjr;
+
+namespace {
+
+template <typename Map, typename StdMap>
+bool flat_hash_map_equal(const Map &map, const StdMap &std_map) {
+    if (map.size() != std_map.size()) {
+        return false;
+    }
+
+    for (const auto &[key, value] : std_map) {
+        const auto iter = map.find(key);
+        if (iter == map.end() || iter->first != key || iter->second != value) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+TEST(flat_hash_map, construct) {
+    auto test = [](auto key, auto value) {
+        using key_type = remove_cvref_t<decltype(key)>;
+        using value_type = remove_cvref_t<decltype(value)>;
+
+        {
+            flat_hash_map<key_type, value_type> map;
+            WJR_ASSERT_L0(map.empty());
+            WJR_ASSERT_L0(map.size() == 0);
+            WJR_ASSERT_L0(map.begin() == map.end());
+            WJR_ASSERT_L0(map.find(key) == map.end());
+        }
+
+        for (int n = 0; n < 1024; n = (n << 1) | 1) {
+            vector<std::pair<key_type, value_type>> vec;
+            for (int i = 0; i < n; ++i) {
+                vec.emplace_back(trandom<key_type>(), trandom<value_type>());
+            }
+
+            flat_hash_map<key_type, value_type> map(vec.begin(), vec.end());
+            std::unordered_map<key_type, value_type> std_map(vec.begin(), vec.end());
+            WJR_ASSERT_L0(flat_hash_map_equal(map, std_map));
+            flat_hash_map<key_type, value_type> map2(map);
+            WJR_ASSERT_L0(flat_hash_map_equal(map2, std_map));
+            WJR_ASSERT_L0(std::equal(map.begin(), map.end(), map2.begin(), map2.end()));
+            flat_hash_map<key_type, value_type> map3(std::move(map2));
+            WJR_ASSERT_L0(map2.empty());
+            WJR_ASSERT_L0(flat_hash_map_equal(map3, std_map));
+            WJR_ASSERT_L0(map == map3);
+        }
+    };
+
+    test(int(0), int(0));
+    test(std::string(), std::string());
+}
+
+TEST(flat_hash_map, emplace) {
+    auto test = [](auto key, auto value) {
+        using key_type = remove_cvref_t<decltype(key)>;
+        using value_type = remove_cvref_t<decltype(value)>;
+
+        for (int n = 0; n < 1024; n = (n << 1) | 1) {
+            vector<std::pair<key_type, value_type>> vec;
+            for (int i = 0; i < n; ++i) {
+                vec.emplace_back(trandom<key_type>(), trandom<value_type>());
+            }
+
+            flat_hash_map<key_type, value_type> map;
+            std::unordered_map<key_type, value_type> std_map;
+            vector<key_type> order;
+
+            for (const auto &pr : vec) {
+                const bool inserted = map.emplace(pr).second;
+                WJR_ASSERT_L0(inserted == std_map.emplace(pr).second);
+                if (inserted) {
+                    order.emplace_back(pr.first);
+                }
+            }
+
+            WJR_ASSERT_L0(flat_hash_map_equal(map, std_map));
+
+            // iterates in insertion order
+            WJR_ASSERT_L0(std::equal(map.begin(), map.end(), order.begin(), order.end(),
+                                     [](const auto &pr, const auto &k) { return pr.first == k; }));
+
+            for (const auto &pr : vec) {
+                WJR_ASSERT_L0(map.count(pr.first) == 1);
+                WJR_ASSERT_L0(map.at(pr.first) == std_map.at(pr.first));
+                map[pr.first] = pr.second;
+                std_map[pr.first] = pr.second;
+            }
+
+            WJR_ASSERT_L0(flat_hash_map_equal(map, std_map));
+        }
+    };
+
+    test(int(0), int(0));
+    test(std::string(), std::string());
+}
+
+TEST(flat_hash_map, erase) {
+    flat_hash_map<int, int> map;
+    std::unordered_map<int, int> std_map;
+
+    for (int i = 0; i < 256; ++i) {
+        map.emplace(i * 7, i);
+        std_map.emplace(i * 7, i);
+    }
+
+    for (int i = 0; i < 256; i += 3) {
+        WJR_ASSERT_L0(map.erase(i * 7) == 1);
+        WJR_ASSERT_L0(map.erase(i * 7) == 0);
+        std_map.erase(i * 7);
+    }
+
+    WJR_ASSERT_L0(flat_hash_map_equal(map, std_map));
+    WJR_ASSERT_L0(std::is_sorted(map.begin(), map.end()));
+
+    map.clear();
+    WJR_ASSERT_L0(map.empty() && map.find(7) == map.end());
+    map.emplace(7, 1);
+    WJR_ASSERT_L0(map.at(7) == 1);
+}
+
+TEST(flat_hash_map, erase_and_insert) {
+    // tombstones are reused by insertion and dropped when the table is rebuilt
+    flat_hash_map<std::string, int> map;
+    std::unordered_map<std::string, int> std_map;
+    vector<std::string> order;
+
+    for (int i = 0; i < 4096; ++i) {
+        const std::string key = std::to_string(i % 1000);
+
+        if (i % 3 == 2) {
+            const auto iter = map.find(key);
+            WJR_ASSERT_L0((iter != map.end()) == (std_map.erase(key) != 0));
+            if (iter != map.end()) {
+                map.erase(iter);
+                order.erase(std::find(order.begin(), order.end(), key));
+            }
+        } else if (map.try_emplace(key, i).second) {
+            std_map.emplace(key, i);
+            order.push_back(key);
+        }
+
+        WJR_ASSERT_L0(map.size() == std_map.size());
+    }
+
+    WJR_ASSERT_L0(flat_hash_map_equal(map, std_map));
+    WJR_ASSERT_L0(std::equal(map.begin(), map.end(), order.begin(), order.end(),
+                             [](const auto &lhs, const auto &rhs) { return lhs.first == rhs; }));
+
+    const auto copy = map;
+    WJR_ASSERT_L0(flat_hash_map_equal(copy, std_map));
+
+    while (!map.empty()) {
+        std_map.erase(map.begin()->first);
+        map.erase(map.begin());
+        WJR_ASSERT_L0(map.size() == std_map.size());
+    }
+
+    WJR_ASSERT_L0(map.find("1") == map.end());
+    map.emplace("1", 1);
+    WJR_ASSERT_L0(map.at("1") == 1);
+}
+
+TEST(flat_hash_map, transparent) {
+    struct string_hash {
+        using is_transparent = void;
+        size_t operator()(std::string_view str) const noexcept {
+            return std::hash<std::string_view>()(str);
+        }
+    };
+
+    flat_hash_map<std::string, int, string_hash, std::equal_to<>> map;
+    for (int i = 0; i < 64; ++i) {
+        map.try_emplace(std::to_string(i), i);
+    }
+
+    WJR_ASSERT_L0(map.find(std::string_view("42"))->second == 42);
+    WJR_ASSERT_L0(map.count("63") == 1);
+    WJR_ASSERT_L0(!map.contains(std::string_view("64")));
+}
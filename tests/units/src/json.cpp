@@ -4,7 +4,25 @@
 #include <fstream>
 #include <iostream>
 
+#include <wjr/json/arena_document.hpp>
+#include <wjr/json/chunk_lexer.hpp>
+#include <wjr/json/columnar.hpp>
+#include <wjr/json/deserializer.hpp>
 #include <wjr/json/document.hpp>
+#include <wjr/json/hash_document.hpp>
+#include <wjr/json/interned_document.hpp>
+#include <wjr/json/mapped_file.hpp>
+#include <wjr/json/ndjson.hpp>
+#include <wjr/json/ondemand.hpp>
+#include <wjr/json/parser.hpp>
+#include <wjr/json/patch.hpp>
+#include <wjr/json/query.hpp>
+#include <wjr/json/sax.hpp>
+#include <wjr/json/serializer.hpp>
+#include <wjr/json/shared_document.hpp>
+#include <wjr/json/snapshot.hpp>
+#include <wjr/json/tape_document.hpp>
+#include <wjr/json/view_document.hpp>
 
 using namespace wjr;
 
@@ -64,6 +82,21 @@ struct test_struct0 {
     int age = 0;
 };
 
+struct test_struct1 {
+    WJR_ENABLE_DEFAULT_SPECIAL_MEMBERS(test_struct1);
+
+    WJR_REGISTER_DOCUMENT_OBJECT_SERIALIZER(test_struct1, id, ratio, flag, owner, tags, members,
+                                            note)
+
+    uint32_t id = 0;
+    double ratio = 0;
+    bool flag = false;
+    test_struct0 owner;
+    std::vector<std::string> tags;
+    vector<test_struct0> members;
+    std::optional<int> note;
+};
+
 template <typename T>
 void json_constructor_test(const T &expected) {
     using namespace json;
@@ -168,6 +201,1822 @@ TEST(json, constructor) {
             WJR_ASSERT_L0(it.version == "1.0.0");
             WJR_ASSERT_L0(it.age == 22);
         } while (false);
+
+        do {
+            reader rd(R"([true,{"a":false,"b":[null,true]}])");
+            const auto doc = document::parse(rd).value();
+            document copy(doc);
+            WJR_ASSERT_L0(copy == doc && copy.dump() == R"([true,{"a":false,"b":[null,true]}])");
+        } while (false);
     }
     WJR_CATCH(...) { WJR_ASSERT_L0(false); }
-}
\ No newline at end of file
+}
+
+TEST(json, ondemand) {
+    using namespace json;
+
+    do {
+        std::string str =
+            R"({"name" : "wjr", "skip" : {"a" : [1, {"b" : "]}"}, [[]]], "c" : null},)"
+            R"( "escaped" : "a\nb\u0041", "list" : [1, -2, 3.5, true, false, null],)"
+            R"( "id" : 9223372036854775808})";
+        reader rd(str);
+        ondemand::document doc(rd);
+
+        auto obj = doc.get_object();
+        WJR_ASSERT_L0(obj.has_value());
+        WJR_ASSERT_L0(obj->count_fields().value() == 5);
+
+        WJR_ASSERT_L0(obj->find_field("name")->get_string_view().value() == "wjr");
+        WJR_ASSERT_L0(obj->find_field("escaped")->get_string_view().value() == "a\nbA");
+        WJR_ASSERT_L0(obj->find_field("id")->get_uint64().value() == 9223372036854775808ull);
+        // find_field only searches forward
+        WJR_ASSERT_L0(obj->find_field("name").error() == error_code::NO_SUCH_FIELD);
+        WJR_ASSERT_L0(obj->find_field_unordered("name")->get_string_view().value() == "wjr");
+
+        auto skip = obj->find_field_unordered("skip");
+        WJR_ASSERT_L0(skip.has_value());
+        WJR_ASSERT_L0(skip->type() == ondemand::json_type::object);
+        WJR_ASSERT_L0(skip->raw_json().value() ==
+                      R"({"a" : [1, {"b" : "]}"}, [[]]], "c" : null})");
+        WJR_ASSERT_L0((*skip)["c"]->is_null());
+        WJR_ASSERT_L0((*skip)["a"]->get_array()->count_elements().value() == 3);
+
+        auto list = obj->find_field_unordered("list")->get_array();
+        WJR_ASSERT_L0(list.has_value());
+        WJR_ASSERT_L0(list->at(0)->get_uint64().value() == 1);
+        WJR_ASSERT_L0(list->at(1)->get_int64().value() == -2);
+        WJR_ASSERT_L0(list->at(1)->get_uint64().error() == error_code::NUMBER_OUT_OF_RANGE);
+        WJR_ASSERT_L0(list->at(2)->get_double().value() == 3.5);
+        WJR_ASSERT_L0(list->at(3)->get_bool().value());
+        WJR_ASSERT_L0(!list->at(4)->get_bool().value());
+        WJR_ASSERT_L0(list->at(5)->is_null());
+        WJR_ASSERT_L0(list->at(6).error() == error_code::INDEX_OUT_OF_BOUNDS);
+        WJR_ASSERT_L0(list->at(0)->get_string_view().error() == error_code::INCORRECT_TYPE);
+
+        std::vector<std::string_view> keys;
+        for (auto &field : *obj) {
+            keys.emplace_back(field.key());
+        }
+
+        WJR_ASSERT_L0(
+            (keys == std::vector<std::string_view>{"name", "skip", "escaped", "list", "id"}));
+    } while (false);
+
+    do {
+        reader rd(twitter_json);
+        ondemand::document doc(rd);
+        auto ret = document::parse(rd);
+        WJR_ASSERT_L0(ret.has_value());
+
+        auto statuses = doc["statuses"]->get_array();
+        WJR_ASSERT_L0(statuses.has_value());
+        auto &expected = (*ret)["statuses"].template get<array_t>();
+        WJR_ASSERT_L0(statuses->count_elements() == expected.size());
+
+        size_t index = 0;
+        for (auto status : *statuses) {
+            auto &exp = expected[index++];
+            WJR_ASSERT_L0(status["id"]->get_uint64().value() == (uint64_t)exp["id"]);
+            WJR_ASSERT_L0(status["text"]->get_string_view().value() ==
+                          (std::string_view)exp["text"]);
+            WJR_ASSERT_L0(status["user"]->operator[]("screen_name")->get_string_view().value() ==
+                          (std::string_view)exp["user"]["screen_name"]);
+        }
+    } while (false);
+
+    // a malformed or truncated object or array is an error, not its end
+    do {
+        for (const std::string_view str :
+             {R"({"a":1 "b":"x"})", R"({"a":1,"b")", R"({"a":1,})", R"({"z":[1,2,"b":3})"}) {
+            reader rd(str);
+            ondemand::document doc(rd);
+            auto obj = doc.get_object();
+            WJR_ASSERT_L0(obj.has_value());
+            WJR_ASSERT_L0(!obj->count_fields().has_value());
+
+            auto ret = obj->find_field_unordered("b");
+            WJR_ASSERT_L0(!ret.has_value() && ret.error() != error_code::NO_SUCH_FIELD);
+
+            auto iter = obj->begin();
+            while (iter != obj->end()) {
+                ++iter;
+            }
+
+            WJR_ASSERT_L0(iter.error() != error_code::SUCCESS);
+        }
+
+        for (const std::string_view str : {"[1 2]", "[1,]", "[1,2", "[[1],,2]"}) {
+            reader rd(str);
+            ondemand::document doc(rd);
+            auto arr = doc.get_array();
+            WJR_ASSERT_L0(arr.has_value());
+            WJR_ASSERT_L0(!arr->count_elements().has_value());
+
+            auto ret = arr->at(3);
+            WJR_ASSERT_L0(!ret.has_value() && ret.error() != error_code::INDEX_OUT_OF_BOUNDS);
+
+            auto iter = arr->begin();
+            while (iter != arr->end()) {
+                ++iter;
+            }
+
+            WJR_ASSERT_L0(iter.error() != error_code::SUCCESS);
+        }
+
+        reader rd(R"({"a":[1,2],"b":{}})");
+        ondemand::document doc(rd);
+        auto obj = doc.get_object();
+        auto iter = obj->begin();
+        while (iter != obj->end()) {
+            ++iter;
+        }
+
+        WJR_ASSERT_L0(iter.error() == error_code::SUCCESS);
+        WJR_ASSERT_L0(doc.get_array().error() == error_code::INCORRECT_TYPE);
+
+        reader rd2("[,1]");
+        ondemand::document doc2(rd2);
+        WJR_ASSERT_L0(doc2.get_array().error() == error_code::TAPE_ERROR);
+    } while (false);
+
+    // an atom must be exactly true, false or null
+    do {
+        reader rd("[truex, falsey, nul, nope, true , null]");
+        ondemand::document doc(rd);
+        auto arr = doc.get_array();
+        WJR_ASSERT_L0(arr.has_value());
+        WJR_ASSERT_L0(!arr->at(0)->get_bool().has_value());
+        WJR_ASSERT_L0(!arr->at(1)->get_bool().has_value());
+        WJR_ASSERT_L0(!arr->at(2)->is_null());
+        WJR_ASSERT_L0(!arr->at(3)->is_null());
+        WJR_ASSERT_L0(arr->at(4)->get_bool().value());
+        WJR_ASSERT_L0(arr->at(5)->is_null());
+    } while (false);
+
+    // decoded strings stay valid across blocks, long ones get a block of their own
+    do {
+        std::string str = "[";
+        std::vector<std::string> expected;
+        for (int i = 0; i < 2000; ++i) {
+            const std::string text(i % 100 == 0 ? 5000 + i : i % 30,
+                                   static_cast<char>('a' + i % 26));
+            str += R"("\t)" + text + R"(",)";
+            expected.push_back("\t" + text);
+        }
+
+        str.back() = ']';
+        reader rd(str);
+        ondemand::document doc(rd);
+        auto arr = doc.get_array();
+        std::vector<std::string_view> views;
+        for (auto val : *arr) {
+            views.push_back(val.get_string_view().value());
+        }
+
+        WJR_ASSERT_L0((std::vector<std::string>(views.begin(), views.end()) == expected));
+    } while (false);
+}
+
+static bool tape_equal(json::tape_value val, const json::document &doc) {
+    using namespace json;
+
+    if (val.type() != doc.type()) {
+        return false;
+    }
+
+    switch (doc.type()) {
+    case value_t::null: {
+        return true;
+    }
+    case value_t::boolean: {
+        return val.get_bool().value() == doc.template get<boolean_t>();
+    }
+    case value_t::number_unsigned: {
+        return val.get_uint64().value() == doc.template get<number_unsigned_t>();
+    }
+    case value_t::number_signed: {
+        return val.get_int64().value() == doc.template get<number_signed_t>();
+    }
+    case value_t::number_float: {
+        return val.get_double().value() == doc.template get<number_float_t>();
+    }
+    case value_t::string: {
+        return val.get_string_view().value() == doc.template get<string_t>();
+    }
+    case value_t::object: {
+        auto obj = val.get_object().value();
+        auto &expected = doc.template get<object_t>();
+        if (obj.size() != expected.size()) {
+            return false;
+        }
+
+        for (auto [key, value] : obj) {
+            if (!tape_equal(value, expected.at(std::string(key)))) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+    case value_t::array: {
+        auto arr = val.get_array().value();
+        auto &expected = doc.template get<array_t>();
+        if (arr.size() != expected.size()) {
+            return false;
+        }
+
+        size_t index = 0;
+        for (auto value : arr) {
+            if (!tape_equal(value, expected[index++])) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+    default: {
+        return false;
+    }
+    }
+}
+
+TEST(json, tape_document) {
+    using namespace json;
+
+    for (std::string_view str :
+         {R"({})", R"([])", R"(null)", R"(-12)", R"("a\u0041")", R"([1, [], {}, [2.5, true]])",
+          R"({"a" : {"b" : [false, null, "c"]}, "d" : 18446744073709551})"}) {
+        reader rd(str);
+        auto tape = tape_document::parse(rd);
+        WJR_ASSERT_L0(tape.has_value());
+        auto doc = document::parse(rd);
+        WJR_ASSERT_L0(doc.has_value());
+        WJR_ASSERT_L0(tape_equal(tape->root(), *doc));
+        auto lazy = tape_document::parse(rd, lazy_numbers);
+        WJR_ASSERT_L0(lazy.has_value());
+        WJR_ASSERT_L0(tape_equal(lazy->root(), *doc));
+    }
+
+    do {
+        std::string str = R"({"a" : [1, 2, {"x" : 3}], "b" : "str", "c" : -1.5})";
+        reader rd(str);
+        auto tape = tape_document::parse(rd);
+        WJR_ASSERT_L0(tape.has_value());
+
+        auto root = tape->root();
+        WJR_ASSERT_L0(root.next_index() == tape->tape().size());
+        WJR_ASSERT_L0(root.get_object()->size() == 3);
+        auto a = root["a"]->get_array();
+        WJR_ASSERT_L0(a->size() == 3);
+        WJR_ASSERT_L0(a->at(2)->operator[]("x")->get_uint64().value() == 3);
+        WJR_ASSERT_L0(a->at(3).error() == error_code::INDEX_OUT_OF_BOUNDS);
+        WJR_ASSERT_L0(root["b"]->get_string_view().value() == "str");
+        WJR_ASSERT_L0(root["c"]->get_double().value() == -1.5);
+        WJR_ASSERT_L0(root["d"].error() == error_code::NO_SUCH_FIELD);
+        WJR_ASSERT_L0(root["b"]->get_uint64().error() == error_code::INCORRECT_TYPE);
+    } while (false);
+
+    do {
+        reader rd(std::string_view(R"({"a" : [1, 2})"));
+        WJR_ASSERT_L0(!tape_document::parse(rd).has_value());
+    } while (false);
+
+    do {
+        reader rd(twitter_json);
+        auto tape = tape_document::parse(rd);
+        WJR_ASSERT_L0(tape.has_value());
+        auto doc = document::parse(rd);
+        WJR_ASSERT_L0(doc.has_value());
+        WJR_ASSERT_L0(tape_equal(tape->root(), *doc));
+        auto lazy = tape_document::parse(rd, lazy_numbers);
+        WJR_ASSERT_L0(lazy.has_value());
+        WJR_ASSERT_L0(tape_equal(lazy->root(), *doc));
+    } while (false);
+
+    // numbers are only checked when they are read
+    do {
+        std::string str =
+            R"([12 , -3, 4.5e1 ,1E2, 01, 1.5x, -, 18446744073709551616, -9223372036854775808])";
+        reader rd(str);
+        WJR_ASSERT_L0(!tape_document::parse(rd).has_value());
+        auto lazy = tape_document::parse(rd, lazy_numbers);
+        WJR_ASSERT_L0(lazy.has_value());
+
+        auto arr = lazy->root().get_array();
+        WJR_ASSERT_L0(arr->size() == 9);
+        WJR_ASSERT_L0(arr->at(0)->type() == value_t::number_unsigned);
+        WJR_ASSERT_L0(arr->at(0)->get_uint64().value() == 12);
+        WJR_ASSERT_L0(arr->at(1)->type() == value_t::number_signed);
+        WJR_ASSERT_L0(arr->at(1)->get_int64().value() == -3);
+        WJR_ASSERT_L0(arr->at(1)->get_uint64().error() == error_code::NUMBER_OUT_OF_RANGE);
+        WJR_ASSERT_L0(arr->at(2)->type() == value_t::number_float);
+        WJR_ASSERT_L0(arr->at(2)->get_double().value() == 45.0);
+        WJR_ASSERT_L0(arr->at(3)->get_double().value() == 100.0);
+        WJR_ASSERT_L0(arr->at(3)->get_uint64().error() == error_code::INCORRECT_TYPE);
+        WJR_ASSERT_L0(arr->at(4)->type() == value_t::number_unsigned);
+        WJR_ASSERT_L0(arr->at(4)->is_number() && !arr->at(4)->get_uint64());
+        WJR_ASSERT_L0(!arr->at(5)->get_double());
+        WJR_ASSERT_L0(!arr->at(6)->get_int64());
+        WJR_ASSERT_L0(arr->at(7)->type() == value_t::number_float);
+        WJR_ASSERT_L0(arr->at(7)->get_double().value() == 18446744073709551616.0);
+        WJR_ASSERT_L0(arr->at(8)->type() == value_t::number_signed);
+        WJR_ASSERT_L0(arr->at(8)->get_int64().value() == std::numeric_limits<int64_t>::min());
+    } while (false);
+}
+
+TEST(json, arena_document) {
+    using namespace json;
+
+    for (std::string_view str :
+         {R"({})", R"([])", R"(null)", R"("a\u0041")", R"([1, [], {}, [2.5, true, "str"]])",
+          R"({"a" : {"b" : [false, null, "c"]}, "d" : 18446744073709551})"}) {
+        reader rd(str);
+        auto arena_doc = arena_document::parse(rd);
+        WJR_ASSERT_L0(arena_doc.has_value());
+        auto doc = document::parse(rd);
+        WJR_ASSERT_L0(doc.has_value());
+        WJR_ASSERT_L0(arena_doc->root().to_string() == doc->to_string());
+    }
+
+    do {
+        reader rd(twitter_json);
+        arena_document arena_doc;
+        WJR_ASSERT_L0(arena_doc.read(rd).has_value());
+        auto doc = document::parse(rd);
+        WJR_ASSERT_L0(doc.has_value());
+        WJR_ASSERT_L0(arena_doc->to_string() == doc->to_string());
+
+        // reading again reuses the arena
+        const size_t capacity = arena_doc.get_arena().capacity();
+        WJR_ASSERT_L0(arena_doc.read(rd).has_value());
+        WJR_ASSERT_L0(arena_doc.get_arena().capacity() == capacity);
+        WJR_ASSERT_L0(arena_doc->to_string() == doc->to_string());
+
+        arena_doc.reset();
+        WJR_ASSERT_L0(arena_doc->is_null());
+    } while (false);
+
+    do {
+        std::string str = R"({"a" : [1, 2], "b" : "str"})";
+        reader rd(str);
+        auto arena_doc = *arena_document::parse(rd);
+        {
+            using string_type = arena_document::document_type::string_type;
+            auto scope = arena_doc.scope();
+            arena_doc->at(string_type("a")).get<array_t>().emplace_back(3u);
+            (*arena_doc)[string_type("c")] =
+                std::string_view("a long string that does not fit in sso");
+        }
+        const std::string expected =
+            R"({"a":[1,2,3],"b":"str","c":"a long string that does not fit in sso"})";
+        WJR_ASSERT_L0(arena_doc->to_string() == expected);
+
+        auto moved = std::move(arena_doc);
+        WJR_ASSERT_L0(moved->to_string() == expected);
+    } while (false);
+
+    do {
+        reader rd(std::string_view(R"({"a" : [1, 2})"));
+        arena_document arena_doc;
+        WJR_ASSERT_L0(!arena_doc.read(rd).has_value());
+        WJR_ASSERT_L0(arena_doc->is_null());
+    } while (false);
+}
+
+TEST(json, stream_reader) {
+    using namespace json;
+
+    for (std::string_view str :
+         {std::string_view(twitter_json), std::string_view(R"(  "a\\\"b"  )"),
+          std::string_view(R"([1, "a string that crosses a window \\\\ \" \\", -2.5e10, null])")}) {
+        reader rd(str);
+        auto doc = document::parse(rd);
+        WJR_ASSERT_L0(doc.has_value());
+
+        for (size_t window_size : {64, 128, 4096}) {
+            for (uint32_t buffer_size : {1u, 7u, 1024u}) {
+                stream_reader srd(str, window_size, buffer_size);
+
+                uint64_t token;
+                auto iter = rd.begin();
+                while (srd.next(token)) {
+                    WJR_ASSERT_L0(iter != rd.end() && token == *iter);
+                    ++iter;
+                }
+                WJR_ASSERT_L0(iter == rd.end());
+
+                srd.reset();
+                auto doc2 = document::parse(srd);
+                WJR_ASSERT_L0(doc2.has_value());
+                WJR_ASSERT_L0(*doc == *doc2);
+            }
+        }
+    }
+
+    do {
+        std::string str = R"({"a" : [1, 2})";
+        stream_reader srd(str, 64, 1);
+        WJR_ASSERT_L0(!check(srd).has_value());
+    } while (false);
+}
+
+TEST(json, chunk_lexer) {
+    using namespace json;
+
+    auto check_chunks = [](std::string_view str, const std::vector<size_t> &sizes) {
+        reader expected(str);
+        chunk_lexer lex;
+        size_t pos = 0;
+        for (size_t i = 0; pos < str.size(); ++i) {
+            const size_t n = std::min(sizes[i % sizes.size()], str.size() - pos);
+            lex.feed(span<const char>(str.data() + pos, n));
+            pos += n;
+        }
+
+        lex.finish();
+        const auto tokens = lex.tokens();
+        if (lex.size() != str.size() ||
+            tokens.size() != static_cast<size_t>(expected.end() - expected.begin()) ||
+            !std::equal(tokens.begin(), tokens.end(), expected.begin())) {
+            return false;
+        }
+
+        reader rd;
+        rd.read(str, std::move(lex));
+        return lex.tokens().empty() && rd.is_valid_utf8() == expected.is_valid_utf8() &&
+               document::parse(rd).value() == document::parse(expected).value();
+    };
+
+    // values cut at every position
+    do {
+        std::string str = R"({"a\"b" : [123456789, -1.5e10, "x\\yé", true, null, false]})";
+        str = std::string(50, ' ') + str;
+        for (size_t n = 1; n <= str.size(); ++n) {
+            WJR_ASSERT_L0(check_chunks(str, {n}));
+        }
+    } while (false);
+
+    for (const auto &sizes : std::vector<std::vector<size_t>>{
+             {1}, {7}, {63}, {64}, {65}, {1000}, {16384}, {3, 64, 200, 1, 130}}) {
+        WJR_ASSERT_L0(check_chunks(twitter_json, sizes));
+    }
+
+    do {
+        chunk_lexer lex;
+        lex.finish();
+        WJR_ASSERT_L0(lex.tokens().empty() && lex.size() == 0 && lex.is_valid_utf8());
+
+        // a UTF-8 sequence cut by a chunk, then an incomplete one at the end
+        lex.reset();
+        const char good[] = "[\"\xc3";
+        const char rest[] = "\xa9\"]";
+        lex.feed(span<const char>(good, 3));
+        lex.feed(span<const char>(rest, 3));
+        lex.finish();
+        WJR_ASSERT_L0(lex.is_valid_utf8() && lex.tokens().size() == 4);
+
+        lex.reset();
+        lex.feed(span<const char>(good, 3));
+        lex.finish();
+        WJR_ASSERT_L0(!lex.is_valid_utf8());
+    } while (false);
+}
+
+TEST(json, ndjson) {
+    using namespace json;
+
+    do {
+        const std::string str = "{\"a\" : 1}\n\n  [1, 2]\r\n\"str\"\n{\"a\" : 3";
+        auto results = parse_ndjson(str, 1);
+        WJR_ASSERT_L0(results.size() == 4);
+        WJR_ASSERT_L0(results[0]->to_string() == R"({"a":1})");
+        WJR_ASSERT_L0(results[1]->to_string() == "[1,2]");
+        WJR_ASSERT_L0(results[2]->to_string() == R"("str")");
+        WJR_ASSERT_L0(!results[3].has_value());
+    } while (false);
+
+    do {
+        // one record per status, large enough to be split across threads
+        reader rd(twitter_json);
+        auto doc = document::parse(rd);
+        WJR_ASSERT_L0(doc.has_value());
+
+        std::string str;
+        vector<std::string> records;
+        for (int i = 0; i < 8; ++i) {
+            for (auto &status : doc->at(std::string("statuses")).get<array_t>()) {
+                records.emplace_back(status.to_string());
+                str += records.back();
+                str += '\n';
+            }
+        }
+
+        for (unsigned int threads : {0u, 1u, 2u, 3u, 8u}) {
+            auto results = parse_ndjson(str, threads);
+            WJR_ASSERT_L0(results.size() == records.size());
+            for (size_t i = 0; i < records.size(); ++i) {
+                WJR_ASSERT_L0(results[i].has_value());
+                WJR_ASSERT_L0(results[i]->to_string() == records[i]);
+            }
+
+            auto sizes = parse_ndjson(str, threads, [](const reader &part) { return part.size(); });
+            WJR_ASSERT_L0(sizes.size() == records.size());
+            for (size_t i = 0; i < records.size(); ++i) {
+                WJR_ASSERT_L0(sizes[i] == records[i].size());
+            }
+        }
+    } while (false);
+}
+
+TEST(json, read_parallel) {
+    using namespace json;
+
+    // split at every block boundary
+    do {
+        std::string str = R"([ "a\\\"b\\", 123, true ,"\\\\\\", {"key\"" :null}, -1.5e3,"x"])";
+        while (str.size() < 1024) {
+            str += R"( , "\\\"\\", 12345678 , [false,"", "\\"] ,"long \\ string \" with quote" )";
+        }
+
+        reader rd(str);
+        const vector<uint32_t> expected(rd.begin(), rd.end());
+
+        for (size_t mid = 64; mid < str.size(); mid += 64) {
+            vector<uint32_t> first[2], second[2];
+            bool utf8_error = false;
+            const bool in_string = json::lexer_detail::read_speculative(
+                str.data(), str.data() + mid, 0, 0, ~0ull, 0, utf8_error, first);
+
+            size_t pos = mid;
+            while (str[pos - 1] == '\\') {
+                --pos;
+            }
+
+            const char prev = str[mid - 1];
+            const bool prev_is_ws = prev == ' ' || prev == ',' || prev == ':' || prev == '[' ||
+                                    prev == ']' || prev == '{' || prev == '}';
+            uint32_t prev_utf8;
+            std::memcpy(&prev_utf8, str.data() + mid - 4, 4);
+            json::lexer_detail::read_speculative(
+                str.data() + mid, str.data() + str.size(), static_cast<uint32_t>(mid),
+                (mid - pos) & 1, prev_is_ws ? ~0ull : 0, prev_utf8, utf8_error, second);
+            WJR_ASSERT_L0(!utf8_error);
+
+            vector<uint32_t> tokens(first[0]);
+            tokens.append(second[in_string].begin(), second[in_string].end());
+            WJR_ASSERT_L0(tokens == expected);
+        }
+    } while (false);
+
+    do {
+        std::string str = "[";
+        for (int i = 0; i < 8; ++i) {
+            str += twitter_json;
+            str += ",";
+        }
+        str += "\"\\\"\"]";
+
+        reader rd(str);
+        const vector<uint32_t> expected(rd.begin(), rd.end());
+
+        for (unsigned int threads : {0u, 1u, 2u, 3u, 7u, 16u}) {
+            reader rd2;
+            rd2.read_parallel(str, threads);
+            WJR_ASSERT_L0(vector<uint32_t>(rd2.begin(), rd2.end()) == expected);
+        }
+    } while (false);
+}
+
+TEST(json, utf8) {
+    using namespace json;
+
+    // Put str in a string of a document, at every offset of a 64-byte block.
+    auto check = [](std::string_view str, bool valid) {
+        for (size_t pad = 0; pad < 70; ++pad) {
+            std::string json = "[\"";
+            json.append(pad, ' ');
+            json += str;
+            json += "\", 1]";
+
+            reader rd(json);
+            WJR_ASSERT_L0(rd.is_valid_utf8() == valid);
+
+            auto doc = document::parse(rd);
+            WJR_ASSERT_L0(valid ? doc.has_value()
+                                : !doc && doc.error() == error_code::UTF8_ERROR);
+
+            ondemand::document od(rd);
+            auto root = od.root();
+            WJR_ASSERT_L0(valid ? root.has_value()
+                                : !root && root.error() == error_code::UTF8_ERROR);
+
+            stream_reader srd(json, 64, 4);
+            auto doc2 = document::parse(srd);
+            WJR_ASSERT_L0(valid ? doc2.has_value()
+                                : !doc2 && doc2.error() == error_code::UTF8_ERROR);
+        }
+    };
+
+    check("ascii", true);
+    check("\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80", true);
+    check("\xEF\xBF\xBF\xF4\x8F\xBF\xBF\xED\x9F\xBF", true);
+    check("\x80", false);
+    check("\xC3", false);
+    check("\xC3\xC3\xA9", false);
+    check("\xC0\x80", false);
+    check("\xE0\x80\xAF", false);
+    check("\xF0\x80\x80\xAF", false);
+    check("\xED\xA0\x80", false);
+    check("\xF4\x90\x80\x80", false);
+    check("\xF5\x80\x80\x80", false);
+    check("\xE4\xB8", false);
+    check("\xE4\xB8\xAD\xAD", false);
+    check("\xFF", false);
+
+    // truncated at the end of the input
+    do {
+        for (size_t pad = 0; pad < 70; ++pad) {
+            std::string json(pad, ' ');
+            json += "1\xE4\xB8";
+            reader rd(json);
+            WJR_ASSERT_L0(!rd.is_valid_utf8());
+        }
+    } while (false);
+
+    do {
+        std::string str = "[";
+        for (int i = 0; i < 8; ++i) {
+            str += twitter_json;
+            str += ",";
+        }
+        str += "\"\xE4\xB8\xAD\"]";
+
+        for (unsigned int threads : {1u, 2u, 3u, 7u}) {
+            reader rd;
+            rd.read_parallel(str, threads);
+            WJR_ASSERT_L0(rd.is_valid_utf8());
+        }
+
+        // an invalid byte in any of the parts
+        for (size_t pos = 64 * 1024; pos < str.size(); pos += 256 * 1024 + 1) {
+            std::string bad = str;
+            bad[pos] = '\xFF';
+            for (unsigned int threads : {2u, 3u, 7u}) {
+                reader rd;
+                rd.read_parallel(bad, threads);
+                WJR_ASSERT_L0(!rd.is_valid_utf8());
+            }
+        }
+    } while (false);
+}
+
+TEST(json, minify) {
+    using namespace json;
+
+    auto check = [](std::string_view str) {
+        std::string expected;
+        bool in_string = false;
+        bool escape = false;
+        for (const char ch : str) {
+            if (in_string) {
+                if (escape) {
+                    escape = false;
+                } else if (ch == '\\') {
+                    escape = true;
+                } else if (ch == '"') {
+                    in_string = false;
+                }
+            } else if (ch == '"') {
+                in_string = true;
+            } else if (ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r') {
+                continue;
+            }
+
+            expected.push_back(ch);
+        }
+
+        std::string buf(str.size() + 64, '\0');
+        const char *const end = minify(buf.data(), str.data(), str.data() + str.size());
+        WJR_ASSERT_L0(std::string_view(buf.data(), end - buf.data()) == expected);
+    };
+
+    std::string str = "[\t\"a \\\\\\\" b\\\\\" , 1 ,\r\n { \"k\\\"\" : \" v \" } ]";
+    while (str.size() < 512) {
+        str += " ,  \"\\\\\\\\ x\" ,\n\t[ true , \"  \\\" \" ]  ";
+    }
+
+    for (size_t n = 0; n <= str.size(); ++n) {
+        check(std::string_view(str.data(), n));
+    }
+
+    check(twitter_json);
+}
+
+TEST(json, query) {
+    using namespace json;
+
+    do {
+        std::string str = R"({"a/b" : 1, "m~n" : [10, {"x" : "y"}], "0" : "zero", "list" : [)"
+                          R"({"id" : 1, "tags" : [{"t" : "p"}, {"t" : "q"}]}, {"id" : 2},)"
+                          R"( {"id" : "3", "tags" : []}, 4]})";
+        reader rd(str);
+        ondemand::document doc(rd);
+
+        WJR_ASSERT_L0(query::pointer("").value().find(doc)->type() == ondemand::json_type::object);
+        WJR_ASSERT_L0(query::pointer("/a~1b").value().find(doc)->get_uint64().value() == 1);
+        WJR_ASSERT_L0(query::pointer("/m~0n/0").value().find(doc)->get_uint64().value() == 10);
+        WJR_ASSERT_L0(query::pointer("/m~0n/1/x").value().find(doc)->get_string_view().value() ==
+                      "y");
+        WJR_ASSERT_L0(query::pointer("/0").value().find(doc)->get_string_view().value() == "zero");
+        WJR_ASSERT_L0(query::pointer("/m~0n/2").value().find(doc).error() ==
+                      error_code::NO_SUCH_FIELD);
+        WJR_ASSERT_L0(query::pointer("/m~0n/01").value().find(doc).error() ==
+                      error_code::NO_SUCH_FIELD);
+        WJR_ASSERT_L0(query::pointer("/a~1b/x").value().find(doc).error() ==
+                      error_code::NO_SUCH_FIELD);
+
+        std::vector<std::string_view> result;
+        auto q = query::path("$.list[*].tags[*].t").value();
+        WJR_ASSERT_L0(q.has_wildcard());
+        WJR_ASSERT_L0(q.for_each(doc, [&result](ondemand::value val) {
+            result.push_back(val.get_string_view().value());
+        }));
+        WJR_ASSERT_L0((result == std::vector<std::string_view>{"p", "q"}));
+
+        std::vector<std::string_view> ids;
+        auto q2 = query::path("$.list[*].id").value();
+        WJR_ASSERT_L0(q2.for_each(
+            doc, [&ids](ondemand::value val) { ids.push_back(val.raw_json().value()); }));
+        WJR_ASSERT_L0((ids == std::vector<std::string_view>{"1", "2", "\"3\""}));
+
+        WJR_ASSERT_L0(
+            query::path("$['m~n'][1][\"x\"]").value().find(doc)->get_string_view().value() == "y");
+        WJR_ASSERT_L0(
+            query::path("$.list[0].tags[1].t").value().find(doc)->get_string_view().value() == "q");
+        WJR_ASSERT_L0(query::path("$.*").value().find(doc)->get_uint64().value() == 1);
+        WJR_ASSERT_L0(query::path("$").value().size() == 0);
+    } while (false);
+
+    do {
+        // a JSON Pointer has no wildcard, "*" is a key like any other
+        reader rd(R"({"a" : 1, "*" : 2})");
+        ondemand::document doc(rd);
+        const auto q = query::pointer("/*").value();
+        WJR_ASSERT_L0(!q.has_wildcard());
+        WJR_ASSERT_L0(q.find(doc)->get_uint64().value() == 2);
+    } while (false);
+
+    do {
+        // malformed objects and arrays on the path are errors, not missing fields
+        for (const std::string_view str : {R"({"a":1,"b")", R"({"a":1 "b":"x"})"}) {
+            reader rd(str);
+            ondemand::document doc(rd);
+            const auto ret = query::pointer("/b").value().find(doc);
+            WJR_ASSERT_L0(!ret.has_value() && ret.error() != error_code::NO_SUCH_FIELD);
+            WJR_ASSERT_L0(!query::path("$.*").value().for_each(doc, [](ondemand::value) {}));
+        }
+
+        reader rd(R"({"a":[1,2 3]})");
+        ondemand::document doc(rd);
+        WJR_ASSERT_L0(!query::path("$.a[*]").value().for_each(doc, [](ondemand::value) {}));
+        WJR_ASSERT_L0(query::path("$.a[2]").value().find(doc).error() == error_code::TAPE_ERROR);
+    } while (false);
+
+    do {
+        for (std::string_view str : {"a", "/a~", "/a~2"}) {
+            WJR_ASSERT_L0(query::pointer(str).error() == error_code::INVALID_JSON_POINTER);
+        }
+
+        for (std::string_view str : {"", "a", "$.", "$..a", "$[", "$[a]", "$['a'", "$[0", "$x"}) {
+            WJR_ASSERT_L0(query::path(str).error() == error_code::INVALID_JSON_POINTER);
+        }
+    } while (false);
+
+    do {
+        reader rd(twitter_json);
+        ondemand::document doc(rd);
+        document doc2 = document::parse(rd).value();
+        const std::string user = "user", id = "id";
+        const auto &statuses = doc2.at(std::string("statuses")).get<array_t>();
+
+        size_t count = 0;
+        auto q = query::path("$.statuses[*].user.id").value();
+        WJR_ASSERT_L0(q.for_each(doc, [&](ondemand::value val) {
+            WJR_ASSERT_L0(val.get_uint64().value() ==
+                          statuses[count].at(user).at(id).get<number_unsigned_t>());
+            ++count;
+        }));
+        WJR_ASSERT_L0(count == statuses.size());
+    } while (false);
+}
+
+TEST(json, deserialize) {
+    using namespace json;
+
+    do {
+        std::string str = R"({"id" : 42, "skip" : {"a" : [1, {"b" : "]}"}]}, "ratio" : -1.5e2,)"
+                          R"( "flag" : true, "owner" : {"name" : "w\u006ar", "version" : "1.0",)"
+                          R"( "age" : 18}, "tags" : ["a", "b\n"], "members" : [{"age" : 1},)"
+                          R"( {"name" : "x", "age" : 2}], "note" : null})";
+        reader rd(str);
+
+        test_struct1 val;
+        val.note = 3;
+        WJR_ASSERT_L0(deserialize(rd, val));
+        WJR_ASSERT_L0(val.id == 42);
+        WJR_ASSERT_L0(val.ratio == -150);
+        WJR_ASSERT_L0(val.flag);
+        WJR_ASSERT_L0(val.owner.name == "wjr" && val.owner.version == "1.0" && val.owner.age == 18);
+        WJR_ASSERT_L0((val.tags == std::vector<std::string>{"a", "b\n"}));
+        WJR_ASSERT_L0(val.members.size() == 2);
+        WJR_ASSERT_L0(val.members[0].name.empty() && val.members[0].age == 1);
+        WJR_ASSERT_L0(val.members[1].name == "x" && val.members[1].age == 2);
+        WJR_ASSERT_L0(!val.note.has_value());
+
+        // same as going through a document
+        auto doc = document::parse(rd).value();
+        WJR_ASSERT_L0((test_struct0)doc.at(std::string("owner")) == val.owner);
+    } while (false);
+
+    do {
+        const auto reader = [](std::string_view str) { return json::reader(str); };
+        WJR_ASSERT_L0(deserialize<int>(reader("123")).value() == 123);
+        WJR_ASSERT_L0(deserialize<uint8_t>(reader("256")).error() ==
+                      error_code::NUMBER_OUT_OF_RANGE);
+        WJR_ASSERT_L0(deserialize<int8_t>(reader("-128")).value() == -128);
+        WJR_ASSERT_L0(deserialize<int>(reader("1.5")).error() == error_code::NUMBER_OUT_OF_RANGE);
+        WJR_ASSERT_L0(deserialize<std::string>(reader("1")).error() == error_code::INCORRECT_TYPE);
+        WJR_ASSERT_L0(deserialize<test_struct0>(reader(R"({"age" : "1"})")).error() ==
+                      error_code::INCORRECT_TYPE);
+        WJR_ASSERT_L0(deserialize<test_struct0>(reader("[]")).error() ==
+                      error_code::INCORRECT_TYPE);
+        WJR_ASSERT_L0(deserialize<test_struct0>(reader("")).error() == error_code::EMPTY);
+    } while (false);
+
+    // the fields and elements that are read must end at the closing bracket
+    do {
+        for (const std::string_view str : {R"({"age":1 "name":"x"})", R"({"age":1,"name")",
+                                           R"({"age":1,})", R"({"z":[1,2,"name":3})"}) {
+            const reader rd(str);
+            WJR_ASSERT_L0(!check(rd));
+            WJR_ASSERT_L0(!deserialize<test_struct0>(rd).has_value());
+        }
+
+        for (const std::string_view str : {"[1 2]", "[1,]", "[1,2", "[1,2}"}) {
+            const reader rd(str);
+            WJR_ASSERT_L0(!check(rd));
+            WJR_ASSERT_L0(!deserialize<std::vector<int>>(rd).has_value());
+        }
+    } while (false);
+}
+
+TEST(json, serialize) {
+    using namespace json;
+
+    do {
+        test_struct1 val;
+        val.id = 42;
+        val.ratio = -1.5;
+        val.flag = true;
+        val.owner.name = "w\"r";
+        val.owner.version = "1.0";
+        val.owner.age = -18;
+        val.tags = {"a", "b\n"};
+        val.members.resize(2);
+        val.members[1].age = 2;
+
+        const std::string str = serialize(val);
+        WJR_ASSERT_L0(str == R"({"id":42,"ratio":-1.5E0,"flag":true,"owner":{"name":"w\"r",)"
+                             R"("version":"1.0","age":-18},"tags":["a","b\n"],"members":[)"
+                             R"({"name":"","version":"","age":0},{"name":"","version":"",)"
+                             R"("age":2}],"note":null})");
+
+        // the same text as going through a document, up to the order of keys
+        reader rd(str);
+        WJR_ASSERT_L0(document::parse(rd)->at(std::string("owner")) == document(val.owner));
+
+        test_struct1 ret;
+        WJR_ASSERT_L0(deserialize(rd, ret));
+        WJR_ASSERT_L0(ret.id == 42 && ret.ratio == -1.5 && ret.flag && ret.owner == val.owner);
+        WJR_ASSERT_L0(ret.tags == val.tags && ret.members.size() == 2);
+        WJR_ASSERT_L0(ret.members[1] == val.members[1] && !ret.note.has_value());
+
+        // appends to any container supported by try_uninitialized_append
+        vector<char> buf = {'x'};
+        val.note = 7;
+        serialize(val.note, buf);
+        serialize(std::vector<double>{0.5, 1e300}, buf);
+        WJR_ASSERT_L0(std::string_view(buf.data(), buf.size()) == "x7[5E-1,1E300]");
+    } while (false);
+
+    do {
+        WJR_ASSERT_L0(serialize(std::vector<int>{}) == "[]");
+        WJR_ASSERT_L0(serialize(std::numeric_limits<int64_t>::min()) == "-9223372036854775808");
+        WJR_ASSERT_L0(serialize(std::numeric_limits<uint64_t>::max()) == "18446744073709551615");
+        WJR_ASSERT_L0(serialize(std::string_view("\x01\t")) == R"("\u0001\t")");
+    } while (false);
+
+    // escapes at every position of strings around the vector widths
+    do {
+        auto expected = [](std::string_view str) {
+            std::string ret(serializer_detail::escaped_length(str) + 2, '\"');
+            serializer_detail::escape_to(ret.data() + 1, str);
+            return ret;
+        };
+
+        for (size_t n = 0; n <= 70; ++n) {
+            std::string str(n, 'a');
+            WJR_ASSERT_L0(serialize(std::string_view(str)) == expected(str));
+
+            for (size_t i = 0; i < n; ++i) {
+                for (const char ch : {'\"', '\\', '\x1f', '\n', '\x7f', '\x80', ' '}) {
+                    str[i] = ch;
+                    str[n - 1 - i] = '\x01';
+                    WJR_ASSERT_L0(serialize(std::string_view(str)) == expected(str));
+                    str[i] = str[n - 1 - i] = 'a';
+                }
+            }
+        }
+
+        std::string str(100, 'x');
+        str[3] = '\"';
+        str[40] = '\t';
+        str[99] = '\\';
+        document doc(str);
+        for (const unsigned indents : {-1u, 4u}) {
+            const auto text = doc.dump(indents);
+            reader rd(text);
+            WJR_ASSERT_L0(document::parse(rd).value() == doc);
+        }
+    } while (false);
+}
+
+TEST(json, view_document) {
+    using namespace json;
+
+    do {
+        std::string str = R"({"name" : "wjr", "esc\u0041" : "a\nb", "list" : ["x", "", 1]})";
+        const auto in_input = [&str](std::string_view sv) {
+            return sv.data() >= str.data() && sv.data() + sv.size() <= str.data() + str.size();
+        };
+
+        reader rd(str);
+        auto doc = view_document::parse(rd);
+        WJR_ASSERT_L0(doc.has_value());
+
+        const auto &obj = doc->template get<object_t>();
+        WJR_ASSERT_L0(obj.size() == 3);
+
+        using key_type = view_document::string_type;
+
+        auto iter = obj.lower_bound("name");
+        WJR_ASSERT_L0(iter != obj.end() && iter->first == "name");
+        WJR_ASSERT_L0(iter->first.is_borrowed() && in_input(iter->first));
+        WJR_ASSERT_L0(iter->second.template get<string_t>().is_borrowed());
+        WJR_ASSERT_L0(iter->second.template get<string_t>().view() == "wjr");
+        WJR_ASSERT_L0(in_input(iter->second.template get<string_t>().view()));
+
+        // strings with escapes are unescaped into their own storage
+        iter = obj.lower_bound("escA");
+        WJR_ASSERT_L0(iter != obj.end() && iter->first == "escA" && !iter->first.is_borrowed());
+        WJR_ASSERT_L0(!iter->second.template get<string_t>().is_borrowed());
+        WJR_ASSERT_L0(iter->second.template get<string_t>().view() == "a\nb");
+
+        // same values as a document
+        auto expected = document::parse(rd).value();
+        WJR_ASSERT_L0(doc->to_string() == expected.to_string());
+
+        // copies borrow from the same input
+        view_document copy = *doc;
+        WJR_ASSERT_L0(copy["name"].template get<string_t>() == "wjr");
+        auto &list = copy.at(key_type("list")).template get<array_t>();
+        WJR_ASSERT_L0(list[0].template get<string_t>().is_borrowed());
+        WJR_ASSERT_L0(list[1].template get<string_t>().is_borrowed());
+        copy["list"] = std::string("owned");
+        WJR_ASSERT_L0(!copy.at(key_type("list")).template get<string_t>().is_borrowed());
+
+        doc->detach();
+        WJR_ASSERT_L0(!doc->template get<object_t>().begin()->first.is_borrowed());
+        std::fill(str.begin(), str.end(), ' ');
+        WJR_ASSERT_L0(doc->to_string() == expected.to_string());
+    } while (false);
+
+    do {
+        std::string str = R"(["a\"", "b"])";
+        stream_reader rd(str, 64, 1);
+        auto doc = view_document::parse(rd).value();
+        WJR_ASSERT_L0(doc.dump() == R"(["a\"","b"])");
+        WJR_ASSERT_L0(doc[1].template get<string_t>().view().data() == str.data() + 9);
+    } while (false);
+}
+
+TEST(json, hash_document) {
+    using namespace json;
+
+    do {
+        const std::string_view str = R"({"b":1,"a":[true,{"z":"x","y":null}],"c":-2.5E0})";
+        reader rd(str);
+        auto doc = hash_document::parse(rd).value();
+
+        // fields keep the order of the input
+        WJR_ASSERT_L0(doc.dump() == str);
+        WJR_ASSERT_L0((int)doc.at("b") == 1);
+        WJR_ASSERT_L0(doc.at(std::string_view("a"))[1].at("z").template get<string_t>() == "x");
+
+        const std::string_view other = R"({"c":-2.5,"a":[true,{"y":null,"z":"x"}],"b":1})";
+        reader rd2(other);
+        WJR_ASSERT_L0(hash_document::parse(rd2).value() == doc);
+    } while (false);
+
+    do {
+        std::string str = "{";
+        for (int i = 0; i < 300; ++i) {
+            str += "\"key" + std::to_string(i) + "\":" + std::to_string(i) + ",";
+        }
+
+        str.back() = '}';
+        reader rd(str);
+        auto doc = hash_document::parse(rd).value();
+        auto expected = document::parse(rd).value();
+
+        const auto &obj = doc.template get<object_t>();
+        WJR_ASSERT_L0(obj.size() == 300);
+
+        for (int i = 0; i < 300; ++i) {
+            const std::string key = "key" + std::to_string(i);
+            WJR_ASSERT_L0((int)doc.at(std::string_view(key)) == i);
+            WJR_ASSERT_L0((int)expected.at(key) == i);
+            WJR_ASSERT_L0((obj.begin() + i)->first == key);
+        }
+
+        WJR_ASSERT_L0(obj.find(std::string_view("key300")) == obj.end());
+    } while (false);
+}
+
+TEST(json, interned_document) {
+    using namespace json;
+
+    do {
+        using string_type = interned_document::string_type;
+        static_assert(sizeof(string_type) == 16);
+
+        string_type str("a long string without small buffer");
+        WJR_ASSERT_L0(!str.is_interned() && str.size() == 34);
+        string_type copy = str;
+        WJR_ASSERT_L0(copy == str && copy.data() != str.data());
+        copy.resize(6);
+        WJR_ASSERT_L0(copy == "a long" && copy < str && str > copy);
+        // assigning a view of the string's own characters
+        copy = copy.view().substr(2);
+        WJR_ASSERT_L0(copy == "long");
+
+        key_pool pool;
+        const string_type key(pool, "created_at");
+        WJR_ASSERT_L0(key.is_interned() && key == "created_at");
+        copy = key;
+        WJR_ASSERT_L0(copy.is_interned() && copy.view().data() == key.data());
+
+        // writing copies the characters out of the pool
+        copy.data()[0] = 'C';
+        WJR_ASSERT_L0(!copy.is_interned() && copy == "Created_at" && key == "created_at");
+        WJR_ASSERT_L0(pool.size() == 1 && pool.count("created_at") == 1);
+
+        const std::string long_key(3000, 'k');
+        WJR_ASSERT_L0(pool.intern(long_key) == long_key);
+        WJR_ASSERT_L0(pool.intern("").empty() && pool.intern("id") == "id");
+        WJR_ASSERT_L0(pool.intern(long_key).data() == pool.intern(std::string(long_key)).data());
+        WJR_ASSERT_L0(pool.size() == 4 && pool.count(long_key) == 3);
+
+        reader rd(R"({"":["",{"":""}]})");
+        WJR_ASSERT_L0(interned_document::parse(rd, pool).value().dump() == R"({"":["",{"":""}]})");
+        WJR_ASSERT_L0(interned_document::parse(rd).value().dump() == R"({"":["",{"":""}]})");
+    } while (false);
+
+    do {
+        using key_type = interned_document::string_type;
+
+        key_pool pool;
+        const std::string_view first = R"({"id":1,"text":"a","user":{"id":2,"n\u0061me":"b"}})";
+        const std::string_view second = R"({"text":"c","id":3,"user":{"name":"d","id":4}})";
+
+        reader rd(first);
+        auto doc = interned_document::parse(rd, pool).value();
+        rd.read(second);
+        auto other = interned_document::parse(rd, pool).value();
+
+        // distinct keys are stored once
+        WJR_ASSERT_L0(pool.size() == 4);
+        WJR_ASSERT_L0(pool.count("id") == 4 && pool.count("name") == 2);
+
+        const auto &obj = doc.template get<object_t>();
+        const auto &other_obj = other.template get<object_t>();
+        auto iter = obj.begin();
+        auto other_iter = other_obj.begin();
+        for (; iter != obj.end(); ++iter, ++other_iter) {
+            WJR_ASSERT_L0(iter->first.is_interned());
+            WJR_ASSERT_L0(iter->first.data() == other_iter->first.data());
+        }
+
+        const auto &user = doc.at(key_type("user")).template get<object_t>();
+        WJR_ASSERT_L0(user.begin()->first.data() == obj.begin()->first.data());
+        WJR_ASSERT_L0((++user.begin())->first.data() == pool.intern("name").data());
+
+        WJR_ASSERT_L0((int)doc.at(key_type(pool, "id")) == 1);
+        WJR_ASSERT_L0((int)doc["id"] == 1);
+        WJR_ASSERT_L0(doc["text"].template get<string_t>() == "a");
+        WJR_ASSERT_L0(doc.dump() == R"({"id":1,"text":"a","user":{"id":2,"name":"b"}})");
+
+        // copies share the keys
+        interned_document copy = other;
+        WJR_ASSERT_L0(copy == other);
+        WJR_ASSERT_L0(copy.template get<object_t>().begin()->first.data() ==
+                      other_obj.begin()->first.data());
+        WJR_ASSERT_L0(!copy.at(key_type("text")).template get<string_t>().is_interned());
+
+        // without a pool every key has its own storage
+        auto owned = interned_document::parse(rd).value();
+        WJR_ASSERT_L0(owned == other);
+        WJR_ASSERT_L0(!owned.template get<object_t>().begin()->first.is_interned());
+    } while (false);
+}
+
+TEST(json, shared_document) {
+    using namespace json;
+
+    do {
+        const std::string_view str = R"({"a":{"b":[1,{"c":"x"}],"d":[true]},"e":"y"})";
+        reader rd(str);
+        const auto base = shared_document::parse(rd).value();
+        const auto &obj = base.template get<object_t>();
+
+        // a copy shares the root
+        shared_document copy = base;
+        WJR_ASSERT_L0(&std::as_const(copy).template get<object_t>() == &obj);
+        WJR_ASSERT_L0(copy == base);
+
+        // writing clones the path, siblings stay shared
+        copy["a"]["b"][0] = 2;
+        copy["a"]["d"].template get<array_t>().emplace_back(boolean_t(), false);
+        WJR_ASSERT_L0(base.dump() == str);
+        WJR_ASSERT_L0(copy.dump() ==
+                      R"({"a":{"b":[2,{"c":"x"}],"d":[true,false]},"e":"y"})");
+        const auto &copy_obj = std::as_const(copy).template get<object_t>();
+        WJR_ASSERT_L0(&copy_obj != &obj);
+        const auto &copy_b = copy_obj.at(std::string("a")).at(std::string("b"));
+        const auto &base_b = obj.at(std::string("a")).at(std::string("b"));
+        WJR_ASSERT_L0(&copy_b[1].template get<object_t>() == &base_b[1].template get<object_t>());
+
+        // a node owned by one document is written in place
+        copy["a"]["b"][1]["c"] = std::string_view("z");
+        WJR_ASSERT_L0(&std::as_const(copy).template get<object_t>() == &copy_obj);
+        WJR_ASSERT_L0(copy_b[1].at(std::string("c")).template get<string_t>() == "z");
+        WJR_ASSERT_L0(base_b[1].at(std::string("c")).template get<string_t>() == "x");
+        WJR_ASSERT_L0(copy != base);
+
+        shared_document other;
+        other = copy;
+        other["e"].reset();
+        WJR_ASSERT_L0(other.dump() == R"({"a":{"b":[2,{"c":"z"}],"d":[true,false]},"e":null})");
+        WJR_ASSERT_L0(copy.at(std::string("e")).template get<string_t>() == "y");
+
+        // the last owner releases a node
+        shared_document last = base;
+        other = last;
+        last.reset();
+        copy.reset();
+        WJR_ASSERT_L0(other == base && other.dump() == str);
+    } while (false);
+
+    do {
+        reader rd("[[1],[2],[3]]");
+        auto doc = shared_document::parse(rd).value();
+        std::vector<shared_document> copies(8, doc);
+        for (size_t i = 0; i < copies.size(); ++i) {
+            copies[i][i % 3][0] = static_cast<int>(i);
+        }
+
+        WJR_ASSERT_L0(doc.dump() == "[[1],[2],[3]]");
+        WJR_ASSERT_L0(copies[4].dump() == "[[1],[4],[3]]");
+        WJR_ASSERT_L0(&std::as_const(copies[4])[0].template get<array_t>() ==
+                      &std::as_const(doc)[0].template get<array_t>());
+
+        doc = shared_document();
+        WJR_ASSERT_L0(copies[7].dump() == "[[1],[7],[3]]");
+    } while (false);
+}
+
+TEST(json, patch) {
+    using namespace json;
+
+    const auto parse = [](std::string_view str) {
+        reader rd(str);
+        return document::parse(rd).value();
+    };
+
+    // RFC 7386, appendix A
+    const std::initializer_list<std::array<std::string_view, 3>> merge_cases = {
+        {R"({"a":"b"})", R"({"a":"c"})", R"({"a":"c"})"},
+        {R"({"a":"b"})", R"({"b":"c"})", R"({"a":"b","b":"c"})"},
+        {R"({"a":"b"})", R"({"a":null})", R"({})"},
+        {R"({"a":"b","b":"c"})", R"({"a":null})", R"({"b":"c"})"},
+        {R"({"a":["b"]})", R"({"a":"c"})", R"({"a":"c"})"},
+        {R"({"a":"c"})", R"({"a":["b"]})", R"({"a":["b"]})"},
+        {R"({"a":{"b":"c"}})", R"({"a":{"b":"d","c":null}})", R"({"a":{"b":"d"}})"},
+        {R"({"a":[{"b":"c"}]})", R"({"a":[1]})", R"({"a":[1]})"},
+        {R"(["a","b"])", R"(["c","d"])", R"(["c","d"])"},
+        {R"({"a":"b"})", R"(["c"])", R"(["c"])"},
+        {R"({"a":"foo"})", "null", "null"},
+        {R"({"a":"foo"})", R"("bar")", R"("bar")"},
+        {R"({"e":null})", R"({"a":1})", R"({"a":1,"e":null})"},
+        {R"([1,2])", R"({"a":"b","c":null})", R"({"a":"b"})"},
+        {"{}", R"({"a":{"bb":{"ccc":null}}})", R"({"a":{"bb":{}}})"},
+    };
+
+    for (const auto &[target, patch, expected] : merge_cases) {
+        auto doc = parse(target);
+        apply_merge_patch(doc, parse(patch));
+        WJR_ASSERT_L0(doc.dump() == expected);
+
+        doc = parse(target);
+        const auto const_patch = parse(patch);
+        apply_merge_patch(doc, const_patch);
+        WJR_ASSERT_L0(doc == parse(expected));
+    }
+
+    // RFC 6902, appendix A
+    const std::initializer_list<std::array<std::string_view, 3>> patch_cases = {
+        {R"({"foo":"bar"})", R"([{"op":"add","path":"/baz","value":"qux"}])",
+         R"({"baz":"qux","foo":"bar"})"},
+        {R"({"foo":["bar","baz"]})", R"([{"op":"add","path":"/foo/1","value":"qux"}])",
+         R"({"foo":["bar","qux","baz"]})"},
+        {R"({"baz":"qux","foo":"bar"})", R"([{"op":"remove","path":"/baz"}])",
+         R"({"foo":"bar"})"},
+        {R"({"foo":["bar","qux","baz"]})", R"([{"op":"remove","path":"/foo/1"}])",
+         R"({"foo":["bar","baz"]})"},
+        {R"({"baz":"qux","foo":"bar"})", R"([{"op":"replace","path":"/baz","value":"boo"}])",
+         R"({"baz":"boo","foo":"bar"})"},
+        {R"({"foo":{"bar":"baz","waldo":"fred"},"qux":{"corge":"grault"}})",
+         R"([{"op":"move","from":"/foo/waldo","path":"/qux/thud"}])",
+         R"({"foo":{"bar":"baz"},"qux":{"corge":"grault","thud":"fred"}})"},
+        {R"({"foo":["all","grass","cows","eat"]})",
+         R"([{"op":"move","from":"/foo/1","path":"/foo/3"}])",
+         R"({"foo":["all","cows","eat","grass"]})"},
+        {R"({"baz":"qux","foo":["a",2,"c"]})",
+         R"([{"op":"test","path":"/baz","value":"qux"},{"op":"test","path":"/foo/1","value":2}])",
+         R"({"baz":"qux","foo":["a",2,"c"]})"},
+        {R"({"foo":"bar"})", R"([{"op":"add","path":"/child","value":{"grandchild":{}}}])",
+         R"({"child":{"grandchild":{}},"foo":"bar"})"},
+        {R"({"foo":["bar"]})", R"([{"op":"add","path":"/foo/-","value":["abc","def"]}])",
+         R"({"foo":["bar",["abc","def"]]})"},
+        {R"({"/":1,"~":[2]})",
+         R"([{"op":"copy","from":"/~0","path":"/~1"},{"op":"test","path":"/~1/0","value":2.0}])",
+         R"({"/":[2],"~":[2]})"},
+        {R"({"a":1})",
+         R"([{"op":"replace","path":"","value":[1]},{"op":"add","path":"/0","value":0}])",
+         "[0,1]"},
+        {R"({"a":{"b":1}})", R"([{"op":"move","from":"/a","path":"/a"}])", R"({"a":{"b":1}})"},
+    };
+
+    for (const auto &[target, patch, expected] : patch_cases) {
+        auto doc = parse(target);
+        WJR_ASSERT_L0(apply_patch(doc, parse(patch)).has_value());
+        WJR_ASSERT_L0(doc.dump() == expected);
+    }
+
+    const std::initializer_list<std::tuple<std::string_view, std::string_view, error_code>>
+        error_cases = {
+            {R"({"foo":"bar"})", R"({"op":"remove","path":"/foo"})", error_code::INVALID_PATCH},
+            {R"({"foo":"bar"})", R"([{"op":"remove"}])", error_code::INVALID_PATCH},
+            {R"({"foo":"bar"})", R"([{"op":"add","path":"/a"}])", error_code::INVALID_PATCH},
+            {R"({"foo":"bar"})", R"([{"op":"delete","path":"/foo"}])", error_code::INVALID_PATCH},
+            {R"({"foo":"bar"})", R"([{"op":"add","path":"/baz/bat","value":"qux"}])",
+             error_code::NO_SUCH_FIELD},
+            {R"({"foo":"bar"})", R"([{"op":"remove","path":"/foo/0"}])",
+             error_code::NO_SUCH_FIELD},
+            {R"({"foo":"bar"})", R"([{"op":"add","path":"foo","value":1}])",
+             error_code::INVALID_JSON_POINTER},
+            {R"({"foo":[1]})", R"([{"op":"add","path":"/foo/2","value":1}])",
+             error_code::INDEX_OUT_OF_BOUNDS},
+            {R"({"foo":[1]})", R"([{"op":"replace","path":"/foo/-","value":1}])",
+             error_code::INVALID_JSON_POINTER},
+            {R"({"foo":[1]})", R"([{"op":"remove","path":"/foo/01"}])",
+             error_code::INVALID_JSON_POINTER},
+            {R"({"baz":"qux"})", R"([{"op":"test","path":"/baz","value":"bar"}])",
+             error_code::PATCH_TEST_FAILED},
+            {R"({"a":{"b":1}})", R"([{"op":"move","from":"/a","path":"/a/c"}])",
+             error_code::INVALID_PATCH},
+        };
+
+    for (const auto &[target, patch, error] : error_cases) {
+        auto doc = parse(target);
+        const auto ret = apply_patch(doc, parse(patch));
+        WJR_ASSERT_L0(!ret.has_value() && ret.error() == error);
+    }
+
+    do {
+        // values are moved out of the patch
+        auto doc = parse(R"({"a":1})");
+        auto patch = parse(R"([{"op":"add","path":"/b","value":[1,2,3]}])");
+        const auto *value = &std::as_const(patch)[0].at(std::string("value"));
+        const auto *elements = std::as_const(*value).template get<array_t>().data();
+        WJR_ASSERT_L0(apply_patch(doc, std::move(patch)).has_value());
+        WJR_ASSERT_L0(std::as_const(doc).at(std::string("b")).template get<array_t>().data() ==
+                      elements);
+
+        // operations before a failed one stay applied
+        const auto ret = apply_patch(
+            doc, parse(R"([{"op":"remove","path":"/a"},{"op":"remove","path":"/a"}])"));
+        WJR_ASSERT_L0(!ret.has_value() && doc.dump() == R"({"b":[1,2,3]})");
+    } while (false);
+
+    do {
+        // patching a copy of a shared document clones the patched path only
+        reader rd(R"({"a":{"b":1},"c":{"d":[2]}})");
+        const auto base = shared_document::parse(rd).value();
+        shared_document copy = base;
+
+        reader patch_rd(R"([{"op":"replace","path":"/a/b","value":3}])");
+        WJR_ASSERT_L0(apply_patch(copy, shared_document::parse(patch_rd).value()).has_value());
+        apply_merge_patch(copy, [] {
+            reader merge_rd(R"({"a":{"e":true}})");
+            return shared_document::parse(merge_rd).value();
+        }());
+
+        WJR_ASSERT_L0(base.dump() == R"({"a":{"b":1},"c":{"d":[2]}})");
+        WJR_ASSERT_L0(copy.dump() == R"({"a":{"b":3,"e":true},"c":{"d":[2]}})");
+        WJR_ASSERT_L0(&std::as_const(copy).at(std::string("c")).template get<object_t>() ==
+                      &base.at(std::string("c")).template get<object_t>());
+    } while (false);
+}
+
+TEST(json, parser) {
+    using namespace json;
+
+    do {
+        vector<std::string> inputs;
+        for (int i = 0; i < 64; ++i) {
+            std::string str = "[";
+            for (int j = 0; j <= i * i; ++j) {
+                str += R"({"id":)" + std::to_string(j) + R"(,"name":"a long enough name"},)";
+            }
+
+            str.back() = ']';
+            inputs.emplace_back(std::move(str));
+        }
+
+        parser par;
+        size_t capacity = 0;
+
+        for (int round = 0; round < 3; ++round) {
+            for (const auto &str : inputs) {
+                auto doc = par.parse(str);
+                WJR_ASSERT_L0(doc.has_value() && *doc == std::addressof(par.root()));
+
+                reader rd(str);
+                WJR_ASSERT_L0((*doc)->to_string() == document::parse(rd)->to_string());
+            }
+
+            // the arena doesn't grow once it has seen every input
+            if (round != 0) {
+                WJR_ASSERT_L0(par.get_arena().capacity() == capacity);
+            }
+
+            capacity = par.get_arena().capacity();
+        }
+
+        auto ret = par.parse(std::string_view(R"({"a":[1,2})"));
+        WJR_ASSERT_L0(!ret.has_value());
+        // a failed parse clears the root
+        WJR_ASSERT_L0(par.root().is_null());
+        WJR_ASSERT_L0(par.parse(inputs[1]).has_value());
+        WJR_ASSERT_L0(par.root().template get<array_t>().size() == 2);
+
+        par.shrink_to_fit();
+        WJR_ASSERT_L0(par.get_arena().capacity() == 0);
+        WJR_ASSERT_L0((*par.parse(inputs[0]))->to_string() ==
+                      R"([{"id":0,"name":"a long enough name"}])");
+    } while (false);
+}
+
+TEST(json, mapped_file) {
+    using namespace json;
+
+    do {
+        const auto path = (current_path / "../src/data/success/twitter.json").string();
+        auto file = mapped_file::open(path.c_str());
+        WJR_ASSERT_L0(file.has_value() && file->is_open());
+        WJR_ASSERT_L0(std::string_view(file->data(), file->size()) == twitter_json);
+        for (size_t i = 0; i < mapped_file::padding; ++i) {
+            WJR_ASSERT_L0(file->data()[file->size() + i] == '\0');
+        }
+
+        reader rd;
+        WJR_ASSERT_L0(rd.read_file(path.c_str()).has_value());
+        WJR_ASSERT_L0(rd.data() != twitter_json.data() && rd.size() == twitter_json.size());
+        reader expected(twitter_json);
+        WJR_ASSERT_L0(document::parse(rd).value() == document::parse(expected).value());
+
+        mapped_file other = std::move(*file);
+        WJR_ASSERT_L0(!file->is_open() && other.size() == twitter_json.size());
+        other.close();
+        WJR_ASSERT_L0(!other.is_open());
+
+        // files larger than max_size are rejected before they are mapped
+        const auto small = mapped_file::open(path.c_str(), twitter_json.size() - 1);
+        WJR_ASSERT_L0(small.error() == error_code::CAPACITY);
+
+        WJR_ASSERT_L0(mapped_file::open("this file doesn't exist").error() == error_code::IO_ERROR);
+        WJR_ASSERT_L0(rd.read_file("this file doesn't exist").error() == error_code::IO_ERROR);
+    } while (false);
+
+    // files ending at a page boundary, and an empty file
+    for (const size_t size : {size_t(0), size_t(4096), size_t(8192 - 1), size_t(65536)}) {
+        const auto path = std::filesystem::temp_directory_path() / "wjr_json_mapped_file.json";
+        std::string str(size, ' ');
+        if (size != 0) {
+            str.front() = '[';
+            str.back() = ']';
+        }
+
+        {
+            std::ofstream output(path, std::ios::binary);
+            output << str;
+        }
+
+        reader rd;
+        WJR_ASSERT_L0(rd.read_file(path.string().c_str()).has_value());
+        WJR_ASSERT_L0(rd.size() == size);
+        WJR_ASSERT_L0(check(rd).has_value() == (size != 0));
+
+        std::filesystem::remove(path);
+    }
+
+#if defined(WJR_LINUX) || defined(WJR_UNIX)
+    // a sparse file larger than 4 GiB doesn't fit 32-bit tokens
+    do {
+        const auto path = std::filesystem::temp_directory_path() / "wjr_json_mapped_file.json";
+        { std::ofstream output(path, std::ios::binary); }
+        std::error_code ec;
+        std::filesystem::resize_file(path, uint64_t(UINT32_MAX) + 2, ec);
+        if (!ec) {
+            reader rd(std::string_view("[1]"));
+            WJR_ASSERT_L0(rd.read_file(path.string().c_str()).error() == error_code::CAPACITY);
+            WJR_ASSERT_L0(rd.size() == 3 && check(rd).has_value());
+        }
+
+        std::filesystem::remove(path);
+    } while (false);
+#endif
+}
+
+TEST(json, snapshot) {
+    using namespace json;
+
+    for (std::string_view str :
+         {std::string_view(R"(null)"), std::string_view(R"("aA")"),
+          std::string_view(R"([1, -2, 2.5, [], {}, true])"), std::string_view(twitter_json)}) {
+        reader rd(str);
+        auto doc = document::parse(rd);
+        WJR_ASSERT_L0(doc.has_value());
+
+        for (const bool lazy : {false, true}) {
+            auto tape = lazy ? tape_document::parse(rd, lazy_numbers) : tape_document::parse(rd);
+            WJR_ASSERT_L0(tape.has_value());
+            auto image = tape_snapshot::write(*tape);
+            WJR_ASSERT_L0(image.has_value());
+            auto snap = tape_snapshot::view(*image);
+            WJR_ASSERT_L0(snap.has_value());
+            WJR_ASSERT_L0(snap->tape().size() == tape->tape().size());
+            WJR_ASSERT_L0(snap->strings().size() == tape->strings().size());
+            WJR_ASSERT_L0(tape_equal(snap->root(), *doc));
+        }
+    }
+
+    WJR_ASSERT_L0(tape_snapshot::write(tape_document()).error() == error_code::EMPTY);
+
+    do {
+        reader rd(std::string_view(R"([1.5x])"));
+        auto lazy = tape_document::parse(rd, lazy_numbers);
+        WJR_ASSERT_L0(lazy.has_value());
+        WJR_ASSERT_L0(!tape_snapshot::write(*lazy).has_value());
+    } while (false);
+
+    do {
+        reader rd(twitter_json);
+        auto doc = document::parse(rd);
+        auto tape = tape_document::parse(rd);
+        const auto path = std::filesystem::temp_directory_path() / "wjr_json_snapshot.bin";
+        WJR_ASSERT_L0(tape_snapshot::save(*tape, path.string().c_str()).has_value());
+
+        auto snap = tape_snapshot::open(path.string().c_str());
+        WJR_ASSERT_L0(snap.has_value());
+        // copies share the mapped file
+        tape_snapshot copy = *snap;
+        snap = tape_snapshot();
+        WJR_ASSERT_L0(tape_equal(copy.root(), *doc));
+        WJR_ASSERT_L0(copy.root()["user"].error() == error_code::NO_SUCH_FIELD);
+
+        std::filesystem::remove(path);
+        WJR_ASSERT_L0(tape_snapshot::open(path.string().c_str()).error() == error_code::IO_ERROR);
+    } while (false);
+
+    // damaged images
+    do {
+        reader rd(std::string_view(R"({"a" : [1, 2, "str"]})"));
+        auto tape = tape_document::parse(rd);
+        auto image = tape_snapshot::write(*tape).value();
+        const span<const char> view(image.data(), image.size());
+        WJR_ASSERT_L0(tape_snapshot::view(view).has_value());
+
+        auto damaged = [&image](size_t offset) {
+            auto copy = image;
+            copy[offset] ^= 1;
+            return tape_snapshot::view(span<const char>(copy.data(), copy.size()));
+        };
+
+        // magic, version, byte order, tape size and checksum
+        for (size_t offset : {size_t(0), size_t(8), size_t(12), size_t(16), size_t(32)}) {
+            WJR_ASSERT_L0(damaged(offset).error() == error_code::SNAPSHOT_ERROR);
+        }
+
+        // the payload is only checked by the checksum
+        const size_t last = image.size() - 1;
+        WJR_ASSERT_L0(damaged(last).error() == error_code::SNAPSHOT_ERROR);
+        auto copy = image;
+        copy[last] ^= 1;
+        WJR_ASSERT_L0(
+            tape_snapshot::view(span<const char>(copy.data(), copy.size()), false).has_value());
+
+        WJR_ASSERT_L0(tape_snapshot::view(view.subspan(0, view.size() - 8)).error() ==
+                      error_code::SNAPSHOT_ERROR);
+        WJR_ASSERT_L0(tape_snapshot::view(view.subspan(0, 16)).error() ==
+                      error_code::SNAPSHOT_ERROR);
+    } while (false);
+}
+
+namespace {
+
+// Writes the events back as JSON, keys and strings stay escaped.
+struct sax_writer {
+    std::string out;
+    std::vector<bool> first = {true};
+    bool after_key = false;
+
+    void separate() {
+        if (after_key) {
+            after_key = false;
+            return;
+        }
+
+        if (!first.back()) {
+            out += ',';
+        }
+
+        first.back() = false;
+    }
+
+    void visit_start_object() {
+        separate();
+        out += '{';
+        first.push_back(true);
+    }
+
+    void visit_end_object() {
+        out += '}';
+        first.pop_back();
+    }
+
+    void visit_start_array() {
+        separate();
+        out += '[';
+        first.push_back(true);
+    }
+
+    void visit_end_array() {
+        out += ']';
+        first.pop_back();
+    }
+
+    void visit_key(std::string_view raw) {
+        separate();
+        out += '"';
+        out += raw;
+        out += "\":";
+        after_key = true;
+    }
+
+    void visit_string(std::string_view raw) {
+        separate();
+        out += '"';
+        out += raw;
+        out += '"';
+    }
+
+    void visit_number(std::string_view raw) {
+        separate();
+        out += raw;
+    }
+
+    void visit_null() {
+        separate();
+        out += "null";
+    }
+
+    void visit_bool(bool value) {
+        separate();
+        out += value ? "true" : "false";
+    }
+};
+
+} // namespace
+
+TEST(json, sax) {
+    using namespace json;
+
+    for (const std::string_view str :
+         {std::string_view(
+              R"( {"a" : [1, -2.5e3 , "x\"y", true, false, null, {}, []], "b" : {}} )"),
+          std::string_view(" 123 "), std::string_view("\"str\""), std::string_view("[]"),
+          std::string_view(twitter_json)}) {
+        reader rd(str);
+        sax_writer writer;
+        WJR_ASSERT_L0(sax_parse(rd, writer).has_value());
+        WJR_ASSERT_L0(writer.first.size() == 1);
+
+        auto doc = document::parse(rd);
+        WJR_ASSERT_L0(doc.has_value());
+        reader rd2(writer.out);
+        auto doc2 = document::parse(rd2);
+        WJR_ASSERT_L0(doc2.has_value());
+        WJR_ASSERT_L0(doc->to_string() == doc2->to_string());
+
+        stream_reader srd(str, 64, 16);
+        sax_writer writer2;
+        WJR_ASSERT_L0(sax_parse(srd, writer2).has_value());
+        WJR_ASSERT_L0(writer2.out == writer.out);
+    }
+
+    // only some callbacks, errors of callbacks stop the parse
+    do {
+        struct count_sum {
+            bool is_count = false;
+            uint64_t sum = 0;
+            size_t values = 0;
+
+            void visit_key(std::string_view key) { is_count = key == "count"; }
+
+            result<void> visit_number(std::string_view raw) {
+                ++values;
+                if (is_count) {
+                    WJR_EXPECTED_INIT(value, sax_decode_number(raw));
+                    if (value->m_number_unsigned == 0) {
+                        return unexpected(error_code::TAPE_ERROR);
+                    }
+
+                    sum += value->m_number_unsigned;
+                }
+
+                return {};
+            }
+        };
+
+        std::string str =
+            R"([{"count" : 3, "x" : 1.5}, {"count" :4 }, {"y" : [5, {"count" : 7}]}])";
+        count_sum handler;
+        WJR_ASSERT_L0(sax_parse(reader(str), handler).has_value());
+        WJR_ASSERT_L0(handler.sum == 14 && handler.values == 5);
+
+        str = R"([{"count" : 3}, {"count" : 0}, 1, 2])";
+        handler = count_sum();
+        WJR_ASSERT_L0(sax_parse(reader(str), handler).error() == error_code::TAPE_ERROR);
+        WJR_ASSERT_L0(handler.sum == 3 && handler.values == 2);
+
+        struct empty {};
+        empty nothing;
+        WJR_ASSERT_L0(sax_parse(reader(twitter_json), nothing).has_value());
+        WJR_ASSERT_L0(sax_parse(reader(std::string_view("[nul1]")), nothing).error() ==
+                      error_code::N_ATOM_ERROR);
+        WJR_ASSERT_L0(!sax_parse(reader(std::string_view("[1,]")), nothing));
+        WJR_ASSERT_L0(!sax_parse(reader(std::string_view("{\"a\" 1}")), nothing));
+    } while (false);
+
+    // values are checked without a callback for them
+    do {
+        struct empty {};
+        empty nothing;
+        sax_writer writer;
+        for (std::string_view str :
+             {R"([1x, 2])", R"([01])", R"([-])", R"([1.])", R"([.5])", R"([1e])", R"([1e+])",
+              R"([-01])", R"(["\q"])", R"(["\ud800"])", R"(["\udc00"])", R"({"\x" : 1})",
+              R"({"a" : 2.})"}) {
+            reader rd(str);
+            WJR_ASSERT_L0(!check(rd));
+            WJR_ASSERT_L0(sax_parse(rd, nothing).error() == check(rd).error());
+            WJR_ASSERT_L0(sax_parse(rd, writer).error() == check(rd).error());
+        }
+
+        reader rd(std::string_view(R"([0, -0, 10, 1.5e+3, -2E-2, 0.25e5, 1e400, "\u00e9\n"])"));
+        WJR_ASSERT_L0(sax_parse(rd, nothing).has_value());
+    } while (false);
+
+    do {
+        const std::string_view raw = R"(a\nA\"b)";
+        char buf[16];
+        auto end = sax_decode_string(buf, raw);
+        WJR_ASSERT_L0(end.has_value());
+        WJR_ASSERT_L0(std::string_view(buf, *end - buf) == "a\nA\"b");
+
+        auto value = sax_decode_number("-2.5e3");
+        WJR_ASSERT_L0(value.has_value() && value->m_type == value_t::number_float);
+        WJR_ASSERT_L0(value->m_number_float == -2500.0);
+        WJR_ASSERT_L0(!sax_decode_number("1.5x"));
+    } while (false);
+}
+
+TEST(json, columnar) {
+    using namespace json;
+
+    do {
+        std::string str = R"([{"ts" : 1, "v" : 0.5, "name" : "a\"b", "x" : [1, {"v" : 2}]},
+                              {"v" : -3, "ts" : -2, "name" : null},
+                              {"ts" : 9223372036854775807, "other" : true, "ts" : "dup"},
+                              {}])";
+        reader rd(str);
+        column cols[] = {{"ts", column_type::int64},
+                         {"v", column_type::float64},
+                         {"name", column_type::string}};
+        auto rows = extract_columns(rd, cols);
+        WJR_ASSERT_L0(rows.has_value() && *rows == 4);
+
+        auto &ts = cols[0];
+        WJR_ASSERT_L0(ts.size() == 4 && ts.int64s().size() == 4);
+        WJR_ASSERT_L0(ts.int64s()[0] == 1 && ts.int64s()[1] == -2);
+        WJR_ASSERT_L0(ts.int64s()[2] == std::numeric_limits<int64_t>::max());
+        WJR_ASSERT_L0(ts.int64s()[3] == 0 && ts.valid()[3] == 0 && ts.valid()[2] == 1);
+
+        auto &v = cols[1];
+        WJR_ASSERT_L0(v.doubles()[0] == 0.5 && v.doubles()[1] == -3.0);
+        WJR_ASSERT_L0(std::isnan(v.doubles()[2]) && v.valid()[2] == 0);
+
+        auto &name = cols[2];
+        WJR_ASSERT_L0(name.offsets().size() == 5);
+        WJR_ASSERT_L0(name.string(0) == "a\"b" && name.valid()[0] == 1);
+        WJR_ASSERT_L0(name.string(1).empty() && name.valid()[1] == 0);
+        WJR_ASSERT_L0(name.string(3).empty() && name.chars().size() == 3);
+
+        // columns are cleared and reused
+        reader other(std::string_view(R"([{"name" : "xyz"}])"));
+        WJR_ASSERT_L0(extract_columns(other, cols).value() == 1);
+        WJR_ASSERT_L0(ts.size() == 1 && name.string(0) == "xyz");
+
+        std::string empty = "[]";
+        WJR_ASSERT_L0(extract_columns(reader(empty), cols).value() == 0);
+        WJR_ASSERT_L0(name.size() == 0 && name.offsets().size() == 1);
+    } while (false);
+
+    do {
+        column cols[] = {{"a", column_type::int64}, {"b", column_type::string}};
+        for (std::string_view str :
+             {R"({"a" : 1})", R"(1)", R"([1])", R"([[]])", R"([{"a" : 1.5}])", R"([{"a" : "1"}])",
+              R"([{"b" : 1}])", R"([{"a" : true}])", R"([{"a" : [1]}])", R"([{"b" : {}}])"}) {
+            reader rd(str);
+            WJR_ASSERT_L0(extract_columns(rd, cols).error() == error_code::INCORRECT_TYPE);
+        }
+
+        reader rd(std::string_view(R"([{"a" : 9223372036854775808}])"));
+        WJR_ASSERT_L0(extract_columns(rd, cols).error() == error_code::NUMBER_OUT_OF_RANGE);
+        reader bad(std::string_view(R"([{"a" : 1}, ])"));
+        WJR_ASSERT_L0(!extract_columns(bad, cols));
+
+        // fields without a column are checked too
+        for (std::string_view str : {R"([{"a" : 1, "z" : 1x}])", R"([{"z" : [01]}])",
+                                     R"([{"z" : "\q"}])", R"([{"\ud800" : 1}])"}) {
+            reader malformed(str);
+            WJR_ASSERT_L0(!extract_columns(malformed, cols));
+        }
+    } while (false);
+
+    // the same values as through a document
+    do {
+        reader rd(twitter_json);
+        auto doc = document::parse(rd);
+        const auto &value = doc->at(std::string("statuses"));
+        const auto &statuses = value.get<array_t>();
+        const auto arr = value.dump();
+        reader srd(arr);
+        column cols[] = {{"id", column_type::int64},
+                         {"retweet_count", column_type::float64},
+                         {"text", column_type::string}};
+        WJR_ASSERT_L0(extract_columns(srd, cols).value() == statuses.size());
+
+        for (size_t i = 0; i < statuses.size(); ++i) {
+            auto &obj = statuses[i].get<object_t>();
+            WJR_ASSERT_L0(static_cast<uint64_t>(cols[0].int64s()[i]) ==
+                          obj.at(std::string("id")).get<number_unsigned_t>());
+            WJR_ASSERT_L0(cols[1].doubles()[i] ==
+                          obj.at(std::string("retweet_count")).get<number_unsigned_t>());
+            WJR_ASSERT_L0(cols[2].string(i) == obj.at(std::string("text")).get<string_t>());
+        }
+    } while (false);
+}
@@ -2,6 +2,8 @@
 
 #include "detail.hpp"
 
+#include <wjr/container/btree_map.hpp>
+#include <wjr/memory/arena.hpp>
 #include <wjr/memory/stack_allocator.hpp>
 #include <wjr/memory/uninitialized.hpp>
 
@@ -28,6 +30,73 @@ TEST(memory, stack_allocator) {
     } while (false);
 }
 
+TEST(memory, arena) {
+    do {
+        arena al(256);
+        WJR_ASSERT_L0(al.capacity() == 0);
+
+        auto *p0 = static_cast<char *>(al.allocate(1, 1));
+        auto *p1 = static_cast<char *>(al.allocate(8, 8));
+        WJR_ASSERT_L0(reinterpret_cast<uintptr_t>(p1) % 8 == 0);
+        WJR_ASSERT_L0(p1 > p0);
+
+        // only the latest allocation is given back
+        al.deallocate(p1, 8);
+        WJR_ASSERT_L0(al.allocate(8, 8) == p1);
+
+        for (int i = 0; i < 64; ++i) {
+            (void)al.allocate(100);
+        }
+
+        const size_t capacity = al.capacity();
+        WJR_ASSERT_L0(capacity >= 64 * 100);
+
+        // blocks are merged, allocating the same amount again stays in one block
+        al.reset();
+        WJR_ASSERT_L0(al.capacity() == capacity);
+        for (int i = 0; i < 64; ++i) {
+            (void)al.allocate(100);
+        }
+        WJR_ASSERT_L0(al.capacity() == capacity);
+
+        al.release();
+        WJR_ASSERT_L0(al.capacity() == 0);
+    } while (false);
+
+    do {
+        arena al0, al1;
+        WJR_ASSERT_L0(arena::current() == nullptr);
+        {
+            arena_scope guard0(al0);
+            WJR_ASSERT_L0(arena::current() == &al0);
+            {
+                arena_scope guard1(al1);
+                std::vector<int, arena_allocator<int>> vec(100, 1);
+                WJR_ASSERT_L0(al1.capacity() != 0);
+                WJR_ASSERT_L0(al0.capacity() == 0);
+            }
+            WJR_ASSERT_L0(arena::current() == &al0);
+        }
+        WJR_ASSERT_L0(arena::current() == nullptr);
+    } while (false);
+
+    do {
+        // nodes and values are aligned even though the map is given a char allocator
+        arena al;
+        arena_scope guard(al);
+        btree_map<int, std::string, std::less<>, arena_allocator<char>> mp;
+        for (int i = 0; i < 256; ++i) {
+            (void)al.allocate(1, 1);
+            mp.emplace(i, std::string(i % 32, 'a'));
+        }
+
+        constexpr size_t align = alignof(std::pair<const int, std::string>);
+        for (const auto &value : mp) {
+            WJR_ASSERT_L0(reinterpret_cast<uintptr_t>(&value) % align == 0);
+        }
+    } while (false);
+}
+
 TEST(memory, uninitialized) {
     do {
         using type = uninitialized<int>;